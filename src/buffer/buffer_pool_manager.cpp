@@ -20,6 +20,7 @@ BufferPoolManager::~BufferPoolManager() {
 }
 
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
   // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
@@ -76,6 +77,7 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
 }
 
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 0.   Make sure you call AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
@@ -119,6 +121,7 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
 }
 
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   // 0.   Make sure you call DeallocatePage!
   // 1.   Search the page table for the requested page (P).
   // 1.   If P does not exist, return true.
@@ -149,6 +152,7 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   //1 find whether page_id is in this buffer pool, if not, return false
   //2 find whether this page pin_count is more than 1, if it is, just set is_dirty_,and decrement pin_count
   //3 if pin_count is 1, unpin it and add it to lrulist by replacer
@@ -165,6 +169,7 @@ bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   //1 if the page_id is not allocated, return false
   //2 if the page_id is not in buffer pool return false;
   //3 find frame_id and write
@@ -193,11 +198,13 @@ void BufferPoolManager::DeallocatePage(page_id_t page_id) {
 }
 
 bool BufferPoolManager::IsPageFree(page_id_t page_id) {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   return disk_manager_->IsPageFree(page_id);
 }
 
 // Only used for debug
 bool BufferPoolManager::CheckAllUnpinned() {
+  std::scoped_lock<std::recursive_mutex> lock(latch_);
   bool res = true;
   for (size_t i = 0; i < pool_size_; i++) {
     if (pages_[i].pin_count_ != 0) {
@@ -1,4 +1,7 @@
+#include <algorithm>
+
 #include "catalog/catalog.h"
+#include "page/index_roots_page.h"
 
 void CatalogMeta::SerializeTo(char *buf) const {
   // ASSERT(false, "Not Implemented yet");
@@ -25,6 +28,16 @@ void CatalogMeta::SerializeTo(char *buf) const {
     buf += sizeof(uint32_t);
   }
 
+  size = table_stats_pages_.size();
+  MACH_WRITE_UINT32(buf, size);
+  buf += sizeof(uint32_t);
+  for (auto i = table_stats_pages_.begin(); i != table_stats_pages_.end(); i++) {
+    MACH_WRITE_UINT32(buf, i->first);
+    buf += sizeof(uint32_t);
+    MACH_WRITE_UINT32(buf, i->second);
+    buf += sizeof(uint32_t);
+  }
+
   buf = begin;
 }
 
@@ -32,7 +45,7 @@ CatalogMeta *CatalogMeta::DeserializeFrom(char *buf, MemHeap *heap) {
   char *begin = buf;
   uint32_t magic_num = MACH_READ_UINT32(buf);
   buf += sizeof(uint32_t);
-  if (magic_num != CATALOG_METADATA_MAGIC_NUM) {
+  if (magic_num != CATALOG_METADATA_MAGIC_NUM && magic_num != CATALOG_METADATA_MAGIC_NUM_V1) {
     LOG(WARNING) << "MAGIC_NUM wrong in catalog Deserialize" << std::endl;
     buf = begin;
     return 0;
@@ -57,13 +70,23 @@ CatalogMeta *CatalogMeta::DeserializeFrom(char *buf, MemHeap *heap) {
     buf += sizeof(uint32_t);
     catalog->index_meta_pages_.insert(pair<table_id_t, page_id_t>(k1, k2));
   }
+  /*a catalog of the first version has no statistics*/
+  size = magic_num == CATALOG_METADATA_MAGIC_NUM ? MACH_READ_UINT32(buf) : 0;
+  buf += sizeof(uint32_t);
+  for (uint32_t i = 0; i < size; i++) {
+    table_id_t k1 = MACH_READ_UINT32(buf);
+    buf += sizeof(uint32_t);
+    page_id_t k2 = MACH_READ_UINT32(buf);
+    buf += sizeof(uint32_t);
+    catalog->table_stats_pages_.insert(pair<table_id_t, page_id_t>(k1, k2));
+  }
   buf = begin;
   return catalog;
 }
 
 uint32_t CatalogMeta::GetSerializedSize() const {
-  /*MAGIC NUMBER + 2 SIZE + CONTENT IN MAP*/
-  return sizeof(uint32_t) * (3+2*(index_meta_pages_.size()+table_meta_pages_.size()));
+  /*MAGIC NUMBER + 3 SIZE + CONTENT IN MAP*/
+  return sizeof(uint32_t) * (4 + 2 * (index_meta_pages_.size() + table_meta_pages_.size() + table_stats_pages_.size()));
 }
 
 CatalogMeta::CatalogMeta() {}
@@ -71,7 +94,7 @@ CatalogMeta::CatalogMeta() {}
 CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager,
                                LogManager *log_manager, bool init)
         : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager),
-          log_manager_(log_manager), heap_(new SimpleMemHeap()) {
+          log_manager_(log_manager), heap_(new ArenaMemHeap()) {
   /*if init is true, we will clear all the element in catalogManager*/
   if (init) {
     /*initialize the catalog_meta_*/
@@ -122,9 +145,23 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
       /*metadata for indexinfo*/
       IndexMetadata *index_meta = nullptr;
       IndexMetadata::DeserializeFrom(index_meta_page->GetData(), index_meta, heap_);
-      buffer_pool_manager_->UnpinPage(index_page->second, true);
-
-      TableInfo *table_info = tables_.find(index_meta->GetTableId())->second;
+      /*a tree in an old format starts over empty, its pages can't be walked by the current page code*/
+      if (index_meta->HasLegacyTree()) {
+        LOG(WARNING) << "Index " << index_meta->GetIndexName() << " is stored in an old format, rebuilding it."
+                     << std::endl;
+        auto *index_roots_page =
+            reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+        index_roots_page->Delete(index_meta->GetIndexId());
+        buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, true);
+      }
+
+      auto table = tables_.find(index_meta->GetTableId());
+      if (table == tables_.end()) {
+        LOG(WARNING) << "Index " << index_meta->GetIndexName() << " belongs to no table, it is skipped." << std::endl;
+        buffer_pool_manager_->UnpinPage(index_page->second, false);
+        continue;
+      }
+      TableInfo *table_info = table->second;
       IndexInfo *index_info = IndexInfo::Create(heap_);
       index_info->Init(index_meta, table_info, buffer_pool_manager_);
       /*update the map for index*/
@@ -132,6 +169,28 @@ CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManag
           ->second.insert(make_pair(index_meta->GetIndexName(), index_meta->GetIndexId()));
       indexes_.insert(make_pair(index_meta->GetIndexId(), index_info));
 
+      if (index_meta->HasLegacyTree()) {
+        BuildIndex(index_info, nullptr);
+        /*written back under the current magic number*/
+        index_meta->SerializeTo(index_meta_page->GetData());
+      }
+      buffer_pool_manager_->UnpinPage(index_page->second, true);
+    }
+    /*deserialize the statistics of the analyzed tables*/
+    for (auto stats_page = catalog_meta_->table_stats_pages_.begin();
+         stats_page != catalog_meta_->table_stats_pages_.end(); stats_page++) {
+      Page *table_stats_page = buffer_pool_manager_->FetchPage(stats_page->second);
+      TableStatistics *table_stats = nullptr;
+      TableStatistics::DeserializeFrom(table_stats_page->GetData(), table_stats, heap_);
+      buffer_pool_manager_->UnpinPage(stats_page->second, false);
+      auto table = tables_.find(stats_page->first);
+      if (table == tables_.end()) {
+        LOG(WARNING) << "Statistics of table " << stats_page->first << " belong to no table, they are skipped."
+                     << std::endl;
+        TableStatistics::Destroy(table_stats, heap_);
+        continue;
+      }
+      table->second->SetStatistics(table_stats);
     }
   } 
 
@@ -147,6 +206,7 @@ CatalogManager::~CatalogManager() {
     TableMetadata *tablemeta = tableinfo_it->second->GetTableMeta();
     tablemeta->SerializeTo(table_meta_page->GetData());
     buffer_pool_manager_->UnpinPage(catalog_meta_->table_meta_pages_.find(tableinfo_it->first)->second, true);
+    TableStatistics::Destroy(tableinfo_it->second->GetStatistics(), heap_);
   }
   /*serilize all indexmeta*/
   for (auto indexinfo_it = indexes_.begin(); indexinfo_it != indexes_.end(); indexinfo_it++) {
@@ -208,8 +268,11 @@ dberr_t CatalogManager::GetTable(const string &table_name, TableInfo *&table_inf
   if (itpair == table_names_.end()) {
     return DB_TABLE_NOT_EXIST;
   }
-  auto table_id=itpair->second;
-  table_info = tables_.find(table_id)->second;
+  auto table = tables_.find(itpair->second);
+  if (table == tables_.end()) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  table_info = table->second;
   return DB_SUCCESS;
 }
 
@@ -225,7 +288,8 @@ dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
 
 dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string &index_name,
                                     const std::vector<std::string> &index_keys, Transaction *txn,
-                                    IndexInfo *&index_info) {
+                                    IndexInfo *&index_info, bool unique,
+                                    const std::vector<std::string> &index_includes) {
   /*first check if there is the table*/
    auto check_table=table_names_.find(table_name);
   if (check_table == table_names_.end()) {
@@ -252,6 +316,31 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
       return DB_COLUMN_NAME_NOT_EXIST;
     }
   }
+  /*a key column is in the entries already*/
+  vector<uint32_t> include_map;
+  for (auto it = index_includes.begin(); it != index_includes.end(); it++) {
+    if (table_info->GetSchema()->GetColumnIndex(*it, column_index) != DB_SUCCESS) {
+      return DB_COLUMN_NAME_NOT_EXIST;
+    }
+    if (std::find(key_map.begin(), key_map.end(), column_index) == key_map.end() &&
+        std::find(include_map.begin(), include_map.end(), column_index) == include_map.end()) {
+      include_map.push_back(column_index);
+    }
+  }
+  /*the entry has to fit in the widest index key, with the row id of a non-unique index after it*/
+  std::vector<Column *> key_columns;
+  for (auto column_id : key_map) {
+    key_columns.push_back(table_info->GetSchema()->GetColumn(column_id));
+  }
+  for (auto column_id : include_map) {
+    key_columns.push_back(table_info->GetSchema()->GetColumn(column_id));
+  }
+  Schema key_schema(key_columns);
+  uint32_t key_size = KeyCodec::GetMaxEncodedSize(&key_schema) + (unique ? 0 : KeyCodec::ROW_ID_SIZE);
+  if (key_size > IndexInfo::MAX_KEY_SIZE) {
+    LOG(WARNING) << "Index key of " << index_name << " exceeds max key size." << std::endl;
+    return DB_FAILED;
+  }
   index_id_t index_id = next_index_id_++;
   /*the same as create table : new a page for metadata*/
 
@@ -259,7 +348,14 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   Page *meta_page = buffer_pool_manager_->NewPage(meta_page_id);
  
   /*create indexmeta data*/
-  IndexMetadata *index_meta = IndexMetadata::Create(index_id, index_name, table_id, key_map, heap_);
+  /*a single int column of a unique index gets a tree of plain int keys*/
+  IndexKeyKind key_kind = kIndexKeyGeneric;
+  if (unique && key_map.size() == 1 && include_map.empty() &&
+      table_info->GetSchema()->GetColumn(key_map[0])->GetType() == TypeId::kTypeInt) {
+    key_kind = kIndexKeyInt;
+  }
+  IndexMetadata *index_meta =
+      IndexMetadata::Create(index_id, index_name, table_id, key_map, heap_, key_kind, unique, include_map);
   index_meta->SerializeTo(meta_page->GetData());
 
   buffer_pool_manager_->UnpinPage(meta_page_id, true);
@@ -276,18 +372,30 @@ dberr_t CatalogManager::CreateIndex(const std::string &table_name, const string
   indexes_.insert(pair<index_id_t, IndexInfo *>(index_id, index_info));
   
   /*build the index according to the table content*/
-  auto index = index_info->GetIndex();
+  return BuildIndex(index_info, txn);
+}
+
+dberr_t CatalogManager::BuildIndex(IndexInfo *index_info, Transaction *txn) {
+  const std::vector<uint32_t> &key_map = index_info->GetIndexMeta()->GetKeyMapping();
+  const std::vector<uint32_t> &include_map = index_info->GetIndexMeta()->GetIncludeMapping();
+  auto builder = index_info->GetIndex()->GetBuilder(DEFAULT_INDEX_FILL_FACTOR);
   auto table_heap = index_info->GetTableInfo()->GetTableHeap();
-  for (auto record_it = table_heap->Begin(nullptr); record_it != table_heap->End(); record_it++) {
+  for (auto record_it = table_heap->Begin(nullptr); record_it != table_heap->End(); ++record_it) {
+    /*key fields are read in place from the page, only the key row is built*/
+    const RowView &view = record_it.GetRowView();
     std::vector<Field> fields;
     for (auto it_key_map = key_map.begin(); it_key_map != key_map.end(); it_key_map++) {
-      fields.push_back(*record_it->GetField(*it_key_map));
+      fields.push_back(view.GetField(*it_key_map));
+    }
+    for (auto column_id : include_map) {
+      fields.push_back(view.GetField(column_id));
     }
     Row key(fields);
-    index->InsertEntry(key, record_it->GetRowId(), nullptr);
+    builder->Add(key, record_it.GetRowId());
   }
-  return DB_SUCCESS;
+  return builder->Finish(txn);
 }
+
 dberr_t CatalogManager::GetIndex(const std::string &table_name, const std::string &index_name,
                                  IndexInfo *&index_info) const {
   auto table_indexmap = index_names_.find(table_name);  
@@ -320,7 +428,7 @@ dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vect
 dberr_t CatalogManager::DropTable(const string &table_name) { 
   /*first check if exist this table*/
   auto name_id = table_names_.find(table_name);
-  if (name_id == table_names_.end()) {
+  if (name_id == table_names_.end() || tables_.find(name_id->second) == tables_.end()) {
     return DB_TABLE_NOT_EXIST;
   }
   /*drop all the relevant index*/
@@ -339,9 +447,16 @@ dberr_t CatalogManager::DropTable(const string &table_name) {
   auto table_info = tables_.find(table_id)->second;
   TableHeap *table_heap = table_info->GetTableHeap();
   table_heap->FreeHeap();
+  TableStatistics::Destroy(table_info->GetStatistics(), heap_);
+  table_info->SetStatistics(nullptr);
 
-  /*delete the table_meta_page*/
+  /*delete the table_meta_page, and the page of its statistics*/
   buffer_pool_manager_->DeletePage(catalog_meta_->table_meta_pages_.find(table_id)->second);
+  auto stats_page = catalog_meta_->table_stats_pages_.find(table_id);
+  if (stats_page != catalog_meta_->table_stats_pages_.end()) {
+    buffer_pool_manager_->DeletePage(stats_page->second);
+    catalog_meta_->table_stats_pages_.erase(stats_page);
+  }
   /*modify catalog_meta data*/
   catalog_meta_->table_meta_pages_.erase(table_id);
   FlushCatalogMetaPage();
@@ -385,6 +500,42 @@ dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_
   return DB_SUCCESS;
 }
 
+dberr_t CatalogManager::AnalyzeTable(const std::string &table_name, TableInfo *&table_info) {
+  if (GetTable(table_name, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  TableStatistics *table_stats = TableStatistics::Analyze(table_info->GetTableHeap(), table_info->GetSchema(), heap_);
+  /*the statistics of the last analyze are replaced*/
+  TableStatistics::Destroy(table_info->GetStatistics(), heap_);
+  table_info->SetStatistics(table_stats);
+  auto stats_page = catalog_meta_->table_stats_pages_.find(table_info->GetTableId());
+  if (table_stats->GetSerializedSize() > PAGE_SIZE) {
+    LOG(WARNING) << "Statistics of " << table_name << " don't fit in a page, they are not stored." << std::endl;
+    /*the stored statistics of the last analyze would be loaded again*/
+    if (stats_page != catalog_meta_->table_stats_pages_.end()) {
+      buffer_pool_manager_->DeletePage(stats_page->second);
+      catalog_meta_->table_stats_pages_.erase(stats_page);
+      FlushCatalogMetaPage();
+    }
+    return DB_SUCCESS;
+  }
+  /*the statistics of the last analyze are overwritten*/
+  page_id_t stats_page_id = INVALID_PAGE_ID;
+  Page *page = nullptr;
+  if (stats_page == catalog_meta_->table_stats_pages_.end()) {
+    page = buffer_pool_manager_->NewPage(stats_page_id);
+    if (page == nullptr) return DB_FAILED;
+    catalog_meta_->table_stats_pages_.insert(pair<table_id_t, page_id_t>(table_info->GetTableId(), stats_page_id));
+    FlushCatalogMetaPage();
+  } else {
+    stats_page_id = stats_page->second;
+    page = buffer_pool_manager_->FetchPage(stats_page_id);
+  }
+  table_stats->SerializeTo(page->GetData());
+  buffer_pool_manager_->UnpinPage(stats_page_id, true);
+  return DB_SUCCESS;
+}
+
 dberr_t CatalogManager::FlushCatalogMetaPage() const {
   Page *p = buffer_pool_manager_->FetchPage(CATALOG_META_PAGE_ID);
   catalog_meta_->SerializeTo(p->GetData());
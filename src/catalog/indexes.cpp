@@ -2,9 +2,10 @@
 
 IndexMetadata *IndexMetadata::Create(const index_id_t index_id, const string &index_name,
                                      const table_id_t table_id, const vector<uint32_t> &key_map,
-                                     MemHeap *heap) {
+                                     MemHeap *heap, IndexKeyKind key_kind, bool unique,
+                                     const vector<uint32_t> &include_map) {
   void *buf = heap->Allocate(sizeof(IndexMetadata));
-  return new(buf)IndexMetadata(index_id, index_name, table_id, key_map);
+  return new(buf)IndexMetadata(index_id, index_name, table_id, key_map, key_kind, unique, include_map);
 }
 
 uint32_t IndexMetadata::SerializeTo(char *buf) const {
@@ -29,13 +30,24 @@ uint32_t IndexMetadata::SerializeTo(char *buf) const {
     MACH_WRITE_UINT32(buf, key_map_[i]);
     buf += sizeof(uint32_t);
   }
+  MACH_WRITE_UINT32(buf, key_kind_);
+  buf += sizeof(uint32_t);
+  MACH_WRITE_BOOL(buf, unique_);
+  buf += sizeof(bool);
+  MACH_WRITE_UINT32(buf, include_map_.size());
+  buf += sizeof(uint32_t);
+  for (auto column_id : include_map_) {
+    MACH_WRITE_UINT32(buf, column_id);
+    buf += sizeof(uint32_t);
+  }
   uint32_t offset = buf - begin;
   buf = begin;
   return offset;
 }
 
 uint32_t IndexMetadata::GetSerializedSize() const {
-    return sizeof(uint32_t) * (5+key_map_.size()) + (unsigned long)index_name_.length();
+    return sizeof(uint32_t) * (7 + key_map_.size() + include_map_.size()) + sizeof(bool) +
+           (unsigned long)index_name_.length();
 }
 
 uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, MemHeap *heap) {
@@ -45,7 +57,9 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, M
   char *begin = buf;
   uint32_t magic_num = MACH_READ_UINT32(buf);
   buf += sizeof(uint32_t);
-  if (magic_num != INDEX_METADATA_MAGIC_NUM) {
+  if (magic_num != INDEX_METADATA_MAGIC_NUM && magic_num != INDEX_METADATA_MAGIC_NUM_V1 &&
+      magic_num != INDEX_METADATA_MAGIC_NUM_V2 && magic_num != INDEX_METADATA_MAGIC_NUM_V3 &&
+      magic_num != INDEX_METADATA_MAGIC_NUM_V4) {
     LOG(WARNING) << "MAGIC_NUM wrong in index Deserialize" << std::endl;
     buf = begin;
     return 0;
@@ -74,7 +88,29 @@ uint32_t IndexMetadata::DeserializeFrom(char *buf, IndexMetadata *&index_meta, M
     kt.push_back(a);
     buf += sizeof(uint32_t);
   }
-  index_meta = Create(iid, i_name, tid, kt, heap);//构建元信息
+  IndexKeyKind key_kind = kIndexKeyGeneric;
+  if (magic_num != INDEX_METADATA_MAGIC_NUM_V1) {
+    key_kind = static_cast<IndexKeyKind>(MACH_READ_UINT32(buf));
+    buf += sizeof(uint32_t);
+  }
+  bool unique = true;
+  if (magic_num == INDEX_METADATA_MAGIC_NUM || magic_num == INDEX_METADATA_MAGIC_NUM_V4 ||
+      magic_num == INDEX_METADATA_MAGIC_NUM_V3) {
+    unique = MACH_READ_BOOL(buf);
+    buf += sizeof(bool);
+  }
+  std::vector<uint32_t> include_map;
+  if (magic_num == INDEX_METADATA_MAGIC_NUM || magic_num == INDEX_METADATA_MAGIC_NUM_V4) {
+    uint32_t include_count = MACH_READ_UINT32(buf);
+    buf += sizeof(uint32_t);
+    for (uint32_t i = 0; i < include_count; i++) {
+      include_map.push_back(MACH_READ_UINT32(buf));
+      buf += sizeof(uint32_t);
+    }
+  }
+  index_meta = Create(iid, i_name, tid, kt, heap, key_kind, unique, include_map);//构建元信息
+  /*every older version has keys or pages the tree can't read*/
+  index_meta->legacy_tree_ = magic_num != INDEX_METADATA_MAGIC_NUM;
   size_t offset = buf - begin;
   buf = begin;
   delete[] i_name;
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "catalog/statistics.h"
+
+void HyperLogLog::Add(uint64_t hash) {
+  /*the first bits pick a register, which keeps the longest run of leading zeros seen in the rest*/
+  uint32_t index = static_cast<uint32_t>(hash >> (64 - PRECISION));
+  uint64_t rest = hash << PRECISION;
+  uint8_t rank = rest == 0 ? 64 - PRECISION + 1 : static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+uint32_t HyperLogLog::Estimate() const {
+  double m = registers_.size();
+  double sum = 0;
+  uint32_t zeros = 0;
+  for (auto rank : registers_) {
+    sum += std::ldexp(1.0, -rank);
+    zeros += rank == 0 ? 1 : 0;
+  }
+  double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+  /*few values leave registers empty, linear counting is more exact then*/
+  if (estimate <= 2.5 * m && zeros != 0) {
+    estimate = m * std::log(m / zeros);
+  }
+  return static_cast<uint32_t>(std::lround(estimate));
+}
+
+uint64_t HyperLogLog::Hash(const char *data, uint32_t len) {
+  /*FNV-1a, then the finalizer of murmur3 to spread the bits*/
+  uint64_t hash = 14695981039346656037ULL;
+  for (uint32_t i = 0; i < len; i++) {
+    hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+TableStatistics *TableStatistics::Analyze(TableHeap *table_heap, Schema *schema, MemHeap *heap) {
+  void *buf = heap->Allocate(sizeof(TableStatistics));
+  auto table_stats = new(buf) TableStatistics();
+  uint32_t column_count = schema->GetColumnCount();
+  table_stats->columns_.resize(column_count);
+  table_stats->page_count_ = table_heap->GetPageCount();
+  std::vector<HyperLogLog> sketches(column_count);
+  /*the sample of the int and float columns, NAN stands for null*/
+  std::vector<std::vector<double>> samples(column_count);
+  std::mt19937 rng(0);
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    const RowView &row = it.GetRowView();
+    /*reservoir sampling: the n-th row replaces a random sampled row with probability SAMPLE_ROWS / n*/
+    uint32_t slot = table_stats->row_count_;
+    if (slot >= SAMPLE_ROWS) {
+      slot = std::uniform_int_distribution<uint32_t>(0, table_stats->row_count_)(rng);
+    }
+    table_stats->row_count_++;
+    for (uint32_t i = 0; i < column_count; i++) {
+      TypeId type = schema->GetColumn(i)->GetType();
+      double value = NAN;
+      if (row.IsNull(i)) {
+        table_stats->columns_[i].nulls_++;
+      } else if (type == TypeId::kTypeChar) {
+        uint32_t len;
+        const char *chars = row.GetChars(i, &len);
+        sketches[i].Add(HyperLogLog::Hash(chars, len));
+      } else {
+        value = type == TypeId::kTypeInt ? row.GetInt(i) : row.GetFloat(i);
+        sketches[i].Add(HyperLogLog::Hash(reinterpret_cast<const char *>(&value), sizeof(value)));
+        std::vector<double> &bounds = table_stats->columns_[i].bounds_;
+        if (bounds.empty()) {
+          bounds = {value, value};
+        }
+        bounds.front() = std::min(bounds.front(), value);
+        bounds.back() = std::max(bounds.back(), value);
+      }
+      if (type == TypeId::kTypeChar || slot >= SAMPLE_ROWS) {
+        continue;
+      }
+      if (slot == samples[i].size()) {
+        samples[i].push_back(value);
+      } else {
+        samples[i][slot] = value;
+      }
+    }
+  }
+  for (uint32_t i = 0; i < column_count; i++) {
+    ColumnStatistics &column = table_stats->columns_[i];
+    column.distinct_ = std::min(sketches[i].Estimate(), table_stats->row_count_ - column.nulls_);
+    std::vector<double> &sample = samples[i];
+    sample.erase(std::remove_if(sample.begin(), sample.end(), [](double value) { return std::isnan(value); }),
+                 sample.end());
+    if (sample.empty()) {
+      continue;
+    }
+    /*the inner bounds split the sorted sample into buckets of the same size, min and max are exact*/
+    std::sort(sample.begin(), sample.end());
+    double min = column.bounds_.front();
+    double max = column.bounds_.back();
+    column.bounds_.clear();
+    column.bounds_.push_back(min);
+    for (uint32_t bucket = 1; bucket < HISTOGRAM_BUCKETS; bucket++) {
+      column.bounds_.push_back(std::min(std::max(sample[bucket * (sample.size() - 1) / HISTOGRAM_BUCKETS], min), max));
+    }
+    column.bounds_.push_back(max);
+  }
+  return table_stats;
+}
+
+uint32_t TableStatistics::SerializeTo(char *buf) const {
+  char *begin = buf;
+  MACH_WRITE_UINT32(buf, TABLE_STATISTICS_MAGIC_NUM);
+  buf += sizeof(uint32_t);
+  MACH_WRITE_UINT32(buf, row_count_);
+  buf += sizeof(uint32_t);
+  MACH_WRITE_UINT32(buf, page_count_);
+  buf += sizeof(uint32_t);
+  MACH_WRITE_UINT32(buf, columns_.size());
+  buf += sizeof(uint32_t);
+  for (auto &column : columns_) {
+    MACH_WRITE_UINT32(buf, column.distinct_);
+    buf += sizeof(uint32_t);
+    MACH_WRITE_UINT32(buf, column.nulls_);
+    buf += sizeof(uint32_t);
+    MACH_WRITE_UINT32(buf, column.bounds_.size());
+    buf += sizeof(uint32_t);
+    for (auto bound : column.bounds_) {
+      MACH_WRITE_TO(double, buf, bound);
+      buf += sizeof(double);
+    }
+  }
+  return buf - begin;
+}
+
+uint32_t TableStatistics::GetSerializedSize() const {
+  uint32_t size = sizeof(uint32_t) * 4;
+  for (auto &column : columns_) {
+    size += sizeof(uint32_t) * 3 + sizeof(double) * column.bounds_.size();
+  }
+  return size;
+}
+
+void TableStatistics::Destroy(TableStatistics *table_stats, MemHeap *heap) {
+  if (table_stats != nullptr) {
+    table_stats->~TableStatistics();
+    heap->Free(table_stats);
+  }
+}
+
+uint32_t TableStatistics::DeserializeFrom(char *buf, TableStatistics *&table_stats, MemHeap *heap) {
+  char *begin = buf;
+  if (MACH_READ_UINT32(buf) != TABLE_STATISTICS_MAGIC_NUM) {
+    LOG(WARNING) << "MAGIC_NUM wrong in table statistics Deserialize" << std::endl;
+    table_stats = nullptr;
+    return 0;
+  }
+  buf += sizeof(uint32_t);
+  void *mem = heap->Allocate(sizeof(TableStatistics));
+  table_stats = new(mem) TableStatistics();
+  table_stats->row_count_ = MACH_READ_UINT32(buf);
+  buf += sizeof(uint32_t);
+  table_stats->page_count_ = MACH_READ_UINT32(buf);
+  buf += sizeof(uint32_t);
+  table_stats->columns_.resize(MACH_READ_UINT32(buf));
+  buf += sizeof(uint32_t);
+  for (auto &column : table_stats->columns_) {
+    column.distinct_ = MACH_READ_UINT32(buf);
+    buf += sizeof(uint32_t);
+    column.nulls_ = MACH_READ_UINT32(buf);
+    buf += sizeof(uint32_t);
+    column.bounds_.resize(MACH_READ_UINT32(buf));
+    buf += sizeof(uint32_t);
+    for (auto &bound : column.bounds_) {
+      bound = MACH_READ_FROM(double, buf);
+      buf += sizeof(double);
+    }
+  }
+  return buf - begin;
+}
+
+double TableStatistics::Selectivity(uint32_t column_id, const char *op, double value) const {
+  if (row_count_ == 0) {
+    return 0;
+  }
+  const ColumnStatistics &column = columns_[column_id];
+  double not_null = static_cast<double>(row_count_ - column.nulls_) / row_count_;
+  if (strcmp(op, "is") == 0) {
+    return 1 - not_null;
+  } else if (strcmp(op, "not") == 0) {
+    return not_null;
+  }
+  /*every distinct value is taken as equally frequent*/
+  double equal = column.distinct_ == 0 ? 0 : not_null / column.distinct_;
+  bool known = !column.bounds_.empty();
+  if (known && (value < column.bounds_.front() || value > column.bounds_.back())) {
+    equal = 0;
+  }
+  if (strcmp(op, "=") == 0) {
+    return equal;
+  } else if (strcmp(op, "<>") == 0 || strcmp(op, "!=") == 0) {
+    return not_null - equal;
+  } else if (!known) {
+    return not_null * DEFAULT_RANGE_SELECTIVITY;
+  } else if (strcmp(op, "<") == 0) {
+    return not_null * LessThan(column, value, false);
+  } else if (strcmp(op, "<=") == 0) {
+    return not_null * LessThan(column, value, true);
+  } else if (strcmp(op, ">") == 0) {
+    return not_null * (1 - LessThan(column, value, true));
+  } else if (strcmp(op, ">=") == 0) {
+    return not_null * (1 - LessThan(column, value, false));
+  }
+  return 1;
+}
+
+double TableStatistics::LessThan(const ColumnStatistics &column, double value, bool inclusive) const {
+  const std::vector<double> &bounds = column.bounds_;
+  if (value < bounds.front() || (!inclusive && value == bounds.front())) {
+    return 0;
+  }
+  if (value > bounds.back() || (inclusive && value == bounds.back())) {
+    return 1;
+  }
+  /*whole buckets below value, and the part of its bucket up to value as if the values were spread evenly*/
+  uint32_t buckets = bounds.size() - 1;
+  uint32_t bucket = std::upper_bound(bounds.begin(), bounds.end(), value) - bounds.begin() - 1;
+  bucket = std::min(bucket, buckets - 1);
+  double low = bounds[bucket];
+  double high = bounds[bucket + 1];
+  double share = (bucket + (high > low ? (value - low) / (high - low) : 0)) / buckets;
+  if (inclusive && column.distinct_ != 0) {
+    share += 1.0 / column.distinct_;
+  }
+  return std::min(share, 1.0);
+}
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <algorithm>
 #include <fstream>
+#include <iterator>
 #include <stack>
 #include <unordered_map>
 #include "glog/logging.h"
@@ -35,6 +36,16 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
   if (ast == nullptr) {
     return DB_FAILED;
   }
+  /*everything a statement allocates on the fly comes from this heap and is dropped in one shot at the end*/
+  ArenaMemHeap statement_heap;
+  MemHeap *outer_heap = context->heap_;
+  context->heap_ = &statement_heap;
+  dberr_t result = ExecuteStatement(ast, context);
+  context->heap_ = outer_heap;
+  return result;
+}
+
+dberr_t ExecuteEngine::ExecuteStatement(pSyntaxNode ast, ExecuteContext *context) {
   switch (ast->type_) {
     case kNodeCreateDB:
       return ExecuteCreateDatabase(ast, context);
@@ -74,6 +85,8 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
       return ExecuteExecfile(ast, context);
     case kNodeQuit:
       return ExecuteQuit(ast, context);
+    case kNodeAnalyze:
+      return ExecuteAnalyze(ast, context);
     default:
       break;
   }
@@ -438,21 +451,31 @@ dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *conte
   TableInfo *currenttable;
   if (Currentp->catalog_mgr_->GetTable(tablename, currenttable) == DB_TABLE_NOT_EXIST) return DB_TABLE_NOT_EXIST;
   vector<Column*> columns = currenttable->GetSchema()->GetColumns();
+  /*the key is unique if one of its columns is, otherwise the index keeps every row of a key*/
+  bool unique = false;
   if (ast->type_ == kNodeColumnList) {
     pSyntaxNode tmp = ast->child_;
     while (tmp != NULL) {
       for (auto iter = columns.begin(); iter != columns.end(); iter++) {
-        if (!(*iter)->IsUnique() && (*iter)->GetName() == ast->child_->val_) {
-          cout << "只能在唯一键上建立索引" << endl;
-          return DB_FAILED;
+        if ((*iter)->IsUnique() && (*iter)->GetName() == tmp->val_) {
+          unique = true;
         }
       }
       indexkeys.push_back(tmp->val_);
       tmp = tmp->next_;
     }
+    ast = ast->next_;
+  }
+  /*include columns are stored in the entries, a select of them and of the key reads no row*/
+  vector<string> indexincludes;
+  if (ast != NULL && ast->type_ == kNodeColumnList) {
+    for (pSyntaxNode tmp = ast->child_; tmp != NULL; tmp = tmp->next_) {
+      indexincludes.push_back(tmp->val_);
+    }
   }
 
-  return Currentp->catalog_mgr_->CreateIndex(tablename, indexname, indexkeys, txn, index_info);
+  return Currentp->catalog_mgr_->CreateIndex(tablename, indexname, indexkeys, txn, index_info, unique,
+                                             indexincludes);
 
   return DB_FAILED;
 }
@@ -487,301 +510,289 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
   return DB_FAILED;
 }
 
-dberr_t ExecuteEngine::NewTravel(DBStorageEngine *Currentp, TableInfo *currenttable, pSyntaxNode root,
-                                 vector<RowId> *result) {
+/*
+ * One selected field, the same whether it comes from the heap or from an index entry: the
+ * characters of a row in a page are not null-terminated, only the length tells their end
+ */
+static void PrintField(const Field &field) {
+  if (field.IsNull()) {
+    std::cout << "null";
+  } else if (field.GetType() == TypeId::kTypeChar) {
+    std::cout.write(field.GetData(), field.GetLength());
+  } else {
+    char buf[sizeof(int32_t)];
+    field.SerializeTo(buf);
+    if (field.GetType() == TypeId::kTypeInt) {
+      std::cout << MACH_READ_INT32(buf);
+    } else {
+      std::cout << std::to_string(MACH_READ_FROM(float, buf));
+    }
+  }
+  std::cout << " ";
+}
+
+/*the distinct pages expected among rows spread evenly over pages*/
+static inline double PagesTouched(double rows, double pages) {
+  return pages <= 1 ? std::min(rows, pages) : pages * (1 - pow(1 - 1 / pages, rows));
+}
+
+/*row ids order by page, then by slot*/
+static inline bool RowIdLess(const RowId &lhs, const RowId &rhs) { return lhs.Get() < rhs.Get(); }
+
+std::unique_ptr<Operator> ExecuteEngine::PlanScan(DBStorageEngine *Currentp, TableInfo *currenttable,
+                                                  pSyntaxNode root, RowIdList *rows, ExecuteContext *context) {
   Transaction *txn = NULL;
-  if (root->type_ == kNodeConnector) {
-    vector<RowId> left, right;
-    vector<RowId>::iterator iterright;
-    NewTravel(Currentp, currenttable, root->child_, &left);
-    NewTravel(Currentp, currenttable, root->child_->next_, &right);
-    if (strcmp(root->val_, "and") == 0) {
-      for (auto iterleft = left.begin(); iterleft != left.end(); iterleft++) {
-        if (find(right.begin(), right.end(), *iterleft) != right.end()) {
-          (*result).push_back(*iterleft);
-        }
-      }
-    } else if (strcmp(root->val_, "or") == 0) {
-      (*result).insert((*result).end(), left.begin(), left.end());
-      (*result).insert((*result).end(), right.begin(), right.end());
+  TableHeap *heap = currenttable->GetTableHeap();
+  if (root == nullptr) {
+    return std::make_unique<SeqScanOperator>(heap, txn);
+  }
+  /*
+   * a full scan reads every page of the table once and in order, an index path fetches a page for each row
+   * it selects; the index is worth it while its rows cost less than the full scan, and a single row always does
+   */
+  auto maxrows = std::max<size_t>(1, static_cast<size_t>(heap->GetPageCount() / RANDOM_PAGE_COST));
+  if (IndexPath(Currentp, currenttable, root, maxrows, rows, context)) {
+    /*
+     * in key order every row fetches its page, in page order each page is fetched once for all of its rows:
+     * the result is sorted when it is expected to share at least one page, which a few rows of a large
+     * table seldom do and keep the order of the index
+     */
+    if (rows->size() - PagesTouched(rows->size(), heap->GetPageCount()) >= 1) {
+      SortRowIds(rows);
+    }
+    return std::make_unique<IndexScanOperator>(heap, rows, txn);
+  }
+  /*the rows are checked while the scan reads them, no list of them is built*/
+  rows->clear();
+  return std::make_unique<FilterOperator>(std::make_unique<SeqScanOperator>(heap, txn),
+                                          Predicate(root, currenttable->GetSchema()));
+}
 
-      for (auto resultit = (*result).begin(); resultit != (*result).end(); resultit++) {
-        for (auto i2 = resultit + 1; i2 != (*result).end(); i2++) {
-          if ((*i2) == (*resultit)) {
-            (*result).erase(i2);
-            break;
-          }
-        }
-      }
+bool ExecuteEngine::IndexPath(DBStorageEngine *Currentp, TableInfo *currenttable, pSyntaxNode root, size_t maxrows,
+                              RowIdList *result, ExecuteContext *context) {
+  /*a path the statistics expect to select too many rows is not even opened*/
+  double selectivity = EstimateSelectivity(currenttable, root);
+  if (selectivity >= 0 && selectivity * currenttable->GetStatistics()->GetRowCount() > maxrows) {
+    return false;
+  }
+  IndexInfo *index = nullptr;
+  IndexCursors cursors;
+  if (IndexScan(Currentp, currenttable, root, index, &cursors, context)) {
+    return ReadRowIds(&cursors, maxrows, result);
+  }
+  if (root->type_ != kNodeConnector) {
+    return false;
+  }
+  RowIdList left(MemHeapAllocator<RowId>(context->heap_));
+  RowIdList right(MemHeapAllocator<RowId>(context->heap_));
+  bool leftindexed = IndexPath(Currentp, currenttable, root->child_, maxrows, &left, context);
+  if (strcmp(root->val_, "and") == 0) {
+    bool rightindexed = IndexPath(Currentp, currenttable, root->child_->next_, maxrows, &right, context);
+    if (leftindexed && rightindexed) {
+      /*both sides sorted by row id, the index paths intersect in one pass*/
+      SortRowIds(&left);
+      SortRowIds(&right);
+      std::set_intersection(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(*result),
+                            RowIdLess);
+      return true;
     }
-    if (!result->empty()) return DB_SUCCESS;
-    return DB_FAILED;
-  } else if (root->type_ == kNodeCompareOperator) {
-    char *cmpoperator = root->val_;
-    char *op1 = root->child_->val_;
-    char *op2 = root->child_->next_->val_;
-    // if key 上有index
-    IndexInfo *nowindex = nullptr;
-    vector<IndexInfo *> nowindexes;
-    string indexname;
-    Currentp->catalog_mgr_->GetTableIndexes(currenttable->GetTableName(), nowindexes);
-    for (auto m = nowindexes.begin(); m != nowindexes.end(); m++) {
-      if ((*m)->GetIndexName() == "primarykey") continue;
-      if ((*m)->GetIndexKeySchema()->GetColumns().size() == 1) {
-        if ((*m)->GetIndexKeySchema()->GetColumn(0)->GetName() == op1) {
-          indexname = (*m)->GetIndexName();
-        }
-      }
+    if (!leftindexed && !rightindexed) {
+      return false;
     }
-    // 存在该列的索引
-    if (Currentp->catalog_mgr_->GetIndex(currenttable->GetTableName(), indexname, nowindex) != DB_INDEX_NOT_FOUND) {
-      // vector<RowId> result;
-      if (root->child_->next_->type_ == kNodeNumber || root->child_->next_->type_ == kNodeString) {
-        uint32_t op1index;
-        currenttable->GetSchema()->GetColumnIndex(op1, op1index);
-        TypeId typeop1 = currenttable->GetSchema()->GetColumn(op1index)->GetType();
-        vector<Field> keyrowfield;
-        if (typeop1 == kTypeInt) {
-          keyrowfield.push_back(Field(typeop1, atoi(op2)));
-        } else if (typeop1 == kTypeFloat) {
-          keyrowfield.push_back(Field(typeop1, (float)atof(op2)));
-        } else if (typeop1 == kTypeChar) {
-          keyrowfield.push_back(Field(typeop1, op2, strlen(op2), true));
-        }
-        Row keyrow(keyrowfield);
-        vector<RowId> scanresult;
-        int position{};
-        page_id_t leaf_page_id{};
-        nowindex->GetIndex()->ScanKey(keyrow, scanresult, position, leaf_page_id, txn);
-        IndexIterator<GenericKey<32>, RowId, GenericComparator<32>> indexiter(leaf_page_id, position, Currentp->bpm_);
-        auto indexptr =
-            reinterpret_cast<BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>> *>((*nowindex).GetIndex());
-        if (scanresult.size() == 0) return DB_FAILED;
-        if (strcmp(cmpoperator, "=") == 0) {
-          (*result).push_back(scanresult[0]);
-          if (!(*result).empty()) return DB_SUCCESS;
-          return DB_FAILED;
-        } else if (strcmp(cmpoperator, ">=") == 0) {
-          for (; indexiter != indexptr->GetEndIterator(); indexiter.operator++()) {
-            (*result).push_back((*indexiter).second);
-          }
-          if (!(*result).empty()) return DB_SUCCESS;
-          return DB_FAILED;
-        } else if (strcmp(cmpoperator, ">") == 0) {
-          indexiter.operator++();
-          for (; indexiter != indexptr->GetEndIterator(); indexiter.operator++()) {
-            (*result).push_back((*indexiter).second);
-          }
-          if (!(*result).empty()) return DB_SUCCESS;
-          return DB_FAILED;
-        } else if (strcmp(cmpoperator, "<=") == 0) {
-          // IndexIterator<GenericKey<32>, RowId, GenericComparator<32>> indexiter2 = indexiter;
-          IndexIterator<GenericKey<32>, RowId, GenericComparator<32>> indexiter2 = indexptr->GetBeginIterator();
-          indexiter.operator++();
-          for (; indexiter2 != indexiter; indexiter2.operator++()) {
-            (*result).push_back((*indexiter2).second);
-          }
-          if (!(*result).empty()) return DB_SUCCESS;
-          return DB_FAILED;
-        } else if (strcmp(cmpoperator, "<") == 0) {
-          // IndexIterator<GenericKey<32>, RowId, GenericComparator<32>> indexiter2 = indexiter;
-          IndexIterator<GenericKey<32>, RowId, GenericComparator<32>> indexiter2 = indexptr->GetBeginIterator();
-
-          for (; indexiter2 != indexiter; indexiter2.operator++()) {
-            (*result).push_back((*indexiter2).second);
-          }
-          if (!(*result).empty()) return DB_SUCCESS;
-          return DB_FAILED;
-        } else if (strcmp(cmpoperator, "<>") == 0) {
-          // IndexIterator<GenericKey<32>, RowId, GenericComparator<32>> indexiter2 = indexiter;
-          IndexIterator<GenericKey<32>, RowId, GenericComparator<32>> indexiter2 = indexptr->GetBeginIterator();
+    /*only the rows of the cheap side are read and checked against the other one*/
+    if (leftindexed) {
+      FilterRows(currenttable, root->child_->next_, &left, result);
+    } else {
+      FilterRows(currenttable, root->child_, &right, result);
+    }
+    return true;
+  }
+  if (strcmp(root->val_, "or") == 0 && leftindexed &&
+      IndexPath(Currentp, currenttable, root->child_->next_, maxrows - left.size(), &right, context)) {
+    /*the two sides together still cost less than a full scan*/
+    SortRowIds(&left);
+    SortRowIds(&right);
+    std::set_union(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(*result), RowIdLess);
+    return true;
+  }
+  return false;
+}
 
-          for (; indexiter2 != indexiter; indexiter2.operator++()) {
-            (*result).push_back((*indexiter2).second);
-          }
-          indexiter.operator++();
-          for (; indexiter != indexptr->GetEndIterator(); indexiter.operator++()) {
-            (*result).push_back((*indexiter).second);
-          }
-          if (!(*result).empty()) return DB_SUCCESS;
-          return DB_FAILED;
-        }
-      } else if (root->child_->next_->type_ == kNodeNull) {
-        TableIterator tableit(currenttable->GetTableHeap()->Begin(txn));
-        for (tableit == currenttable->GetTableHeap()->Begin(txn); tableit != currenttable->GetTableHeap()->End();
-             tableit++) {
-          if (TravelWithoutIndex(currenttable, tableit, root) == kTrue) {
-            (*result).push_back((*tableit).GetRowId());
-          }
-        }
-        if (!(*result).empty()) return DB_SUCCESS;
-        return DB_FAILED;
-      }
+double ExecuteEngine::EstimateSelectivity(TableInfo *currenttable, pSyntaxNode root) {
+  TableStatistics *stats = currenttable->GetStatistics();
+  if (stats == nullptr) {
+    return -1;
+  }
+  if (root->type_ == kNodeConnector) {
+    double left = EstimateSelectivity(currenttable, root->child_);
+    double right = EstimateSelectivity(currenttable, root->child_->next_);
+    if (left < 0 || right < 0) {
+      return -1;
     }
-    // 不存在该列的索引
-    else {
-      TableIterator tableit(currenttable->GetTableHeap()->Begin(txn));
-      for (tableit == currenttable->GetTableHeap()->Begin(txn); tableit != currenttable->GetTableHeap()->End();
-           tableit++) {
-        if (TravelWithoutIndex(currenttable, tableit, root) == kTrue) {
-          (*result).push_back((*tableit).GetRowId());
-        }
+    if (strcmp(root->val_, "and") == 0) {
+      /*two bounds of one column select the rows in between, other columns are taken as independent*/
+      if (root->child_->type_ == kNodeCompareOperator && root->child_->next_->type_ == kNodeCompareOperator &&
+          strcmp(root->child_->child_->val_, root->child_->next_->child_->val_) == 0) {
+        return std::max(left + right - 1, 0.0);
       }
-      if (!(*result).empty()) return DB_SUCCESS;
-      return DB_FAILED;
+      return left * right;
+    } else if (strcmp(root->val_, "or") == 0) {
+      return left + right - left * right;
     }
+    return -1;
   }
-  return DB_FAILED;
+  uint32_t columnindex;
+  if (root->type_ != kNodeCompareOperator ||
+      currenttable->GetSchema()->GetColumnIndex(root->child_->val_, columnindex) != DB_SUCCESS) {
+    return -1;
+  }
+  pSyntaxNode value = root->child_->next_;
+  return stats->Selectivity(columnindex, root->val_, value->type_ == kNodeNumber ? atof(value->val_) : 0);
+}
+
+void ExecuteEngine::FilterRows(TableInfo *currenttable, pSyntaxNode root, RowIdList *rows, RowIdList *result) {
+  Transaction *txn = NULL;
+  /*read in page order, each page is fetched once for all of its rows*/
+  SortRowIds(rows);
+  Predicate predicate(root, currenttable->GetSchema());
+  TablePage *page = nullptr;
+  for (auto &rid : *rows) {
+    RowView row;
+    if (currenttable->GetTableHeap()->GetTupleView(rid, &row, page, txn) && predicate.Evaluate(row)) {
+      (*result).push_back(rid);
+    }
+  }
+  currenttable->GetTableHeap()->ReleasePage(page);
 }
 
-CmpBool ExecuteEngine::TravelWithoutIndex(TableInfo *currenttable, TableIterator &tableit, pSyntaxNode root) {
+bool ExecuteEngine::IndexScan(DBStorageEngine *Currentp, TableInfo *currenttable, pSyntaxNode root,
+                              IndexInfo *&index, IndexCursors *cursors, ExecuteContext *context) {
+  /*a range on an indexed column reads only the keys in range, rather than both halves of the index*/
+  if (root->type_ == kNodeConnector) {
+    return strcmp(root->val_, "and") == 0 &&
+           IndexBetween(Currentp, currenttable, root->child_, root->child_->next_, index, cursors, context);
+  }
+  if (root->type_ != kNodeCompareOperator ||
+      (root->child_->next_->type_ != kNodeNumber && root->child_->next_->type_ != kNodeString)) {
+    return false;
+  }
   char *cmpoperator = root->val_;
-  char *op1 = root->child_->val_;
-  if (root->child_->next_->type_ == kNodeNumber || root->child_->next_->type_ == kNodeString) {
-    char *op2 = root->child_->next_->val_;
-    Field *now{};
-    uint32_t op1index{};
-    if (currenttable->GetSchema()->GetColumnIndex(op1, op1index) == DB_SUCCESS) {
-      now = (*tableit).GetField(op1index);
-      TypeId typeop1 = currenttable->GetSchema()->GetColumn(op1index)->GetType();
-      Field *pto{};
-      if (typeop1 == kTypeInt) {
-        pto = new Field(typeop1, atoi(op2));
-      } else if (typeop1 == kTypeFloat) {
-        pto = new Field(typeop1, (float)atof(op2));
-      } else if (typeop1 == kTypeChar) {
-        pto = new Field(typeop1, op2, strlen(op2), true);
-      }
+  // if key 上有index
+  index = FindColumnIndex(Currentp, currenttable, root->child_->val_);
+  if (index == nullptr) {
+    return false;
+  }
+  vector<Field> keyrowfield = MakeKeyFields(currenttable, root->child_);
+  Row keyrow(keyrowfield, context->heap_);
+  /*the operator gives the bounds of the keys to scan, <> takes the keys on both sides*/
+  if (strcmp(cmpoperator, "=") == 0) {
+    IndexRangeScan(index, &keyrow, true, &keyrow, true, cursors);
+  } else if (strcmp(cmpoperator, ">=") == 0 || strcmp(cmpoperator, ">") == 0) {
+    IndexRangeScan(index, &keyrow, strcmp(cmpoperator, ">=") == 0, nullptr, false, cursors);
+  } else if (strcmp(cmpoperator, "<=") == 0 || strcmp(cmpoperator, "<") == 0) {
+    IndexRangeScan(index, nullptr, false, &keyrow, strcmp(cmpoperator, "<=") == 0, cursors);
+  } else if (strcmp(cmpoperator, "<>") == 0) {
+    IndexRangeScan(index, nullptr, false, &keyrow, false, cursors);
+    IndexRangeScan(index, &keyrow, false, nullptr, false, cursors);
+  }
+  return true;
+}
 
-      if (strcmp(cmpoperator, "=") == 0) {
-        CmpBool returnvalue = now->CompareEquals(*pto);
-        delete pto;
-        return returnvalue;
-      } else if (strcmp(cmpoperator, ">") == 0) {
-        CmpBool returnvalue = now->CompareGreaterThan(*pto);
-        delete pto;
-        return returnvalue;
-      } else if (strcmp(cmpoperator, "<") == 0) {
-        CmpBool returnvalue = now->CompareLessThan(*pto);
-        delete pto;
-        return returnvalue;
-      } else if (strcmp(cmpoperator, "!=") == 0) {
-        CmpBool returnvalue = now->CompareNotEquals(*pto);
-        delete pto;
-        return returnvalue;
-      } else if (strcmp(cmpoperator, "<=") == 0) {
-        CmpBool returnvalue = now->CompareLessThanEquals(*pto);
-        delete pto;
-        return returnvalue;
-      } else if (strcmp(cmpoperator, ">=") == 0) {
-        CmpBool returnvalue = now->CompareGreaterThanEquals(*pto);
-        delete pto;
-        return returnvalue;
-      } else if (strcmp(cmpoperator, "<>") == 0) {
-        CmpBool returnvalue = now->CompareNotEquals(*pto);
-        delete pto;
-        return returnvalue;
-      }
+IndexInfo *ExecuteEngine::FindColumnIndex(DBStorageEngine *Currentp, TableInfo *currenttable, const char *column) {
+  IndexInfo *columnindex = nullptr;
+  vector<IndexInfo *> indexes;
+  Currentp->catalog_mgr_->GetTableIndexes(currenttable->GetTableName(), indexes);
+  for (auto m = indexes.begin(); m != indexes.end(); m++) {
+    if ((*m)->GetIndexName() == "primarykey") continue;
+    if ((*m)->GetIndexKeySchema()->GetColumnCount() == 1 &&
+        (*m)->GetIndexKeySchema()->GetColumn(0)->GetName() == column) {
+      columnindex = *m;
     }
-    cout << "Wrong column name!" << endl;
-    return kFalse;
-  } else if (root->child_->next_->type_ == kNodeNull) {
-    if (strcmp(cmpoperator, "is") == 0) {
-      // is null
-      Field *now{};
-      uint32_t op1index{};
-      if (currenttable->GetSchema()->GetColumnIndex(op1, op1index) == DB_SUCCESS) {
-        now = (*tableit).GetField(op1index);
-        return GetCmpBool(now->IsNull());
-      }
-      cout << "Wrong column name!" << endl;
-      return kFalse;
-    } else if (strcmp(cmpoperator, "not") == 0) {
-      // not null
-      Field *now{};
-      uint32_t op1index{};
-      if (currenttable->GetSchema()->GetColumnIndex(op1, op1index) == DB_SUCCESS) {
-        now = (*tableit).GetField(op1index);
-        return GetCmpBool(!(now->IsNull()));
+  }
+  return columnindex;
+}
+
+vector<Field> ExecuteEngine::MakeKeyFields(TableInfo *currenttable, pSyntaxNode column) {
+  char *value = column->next_->val_;
+  uint32_t columnindex;
+  currenttable->GetSchema()->GetColumnIndex(column->val_, columnindex);
+  TypeId type = currenttable->GetSchema()->GetColumn(columnindex)->GetType();
+  vector<Field> keyrowfield;
+  if (type == kTypeInt) {
+    keyrowfield.push_back(Field(type, atoi(value)));
+  } else if (type == kTypeFloat) {
+    keyrowfield.push_back(Field(type, (float)atof(value)));
+  } else if (type == kTypeChar) {
+    keyrowfield.push_back(Field(type, value, strlen(value), true));
+  }
+  return keyrowfield;
+}
+
+void ExecuteEngine::IndexRangeScan(IndexInfo *index, const Row *lower, bool lower_inclusive, const Row *upper,
+                                   bool upper_inclusive, IndexCursors *cursors) {
+  /*the cursor hides which key size the index was built with, it stops at the end of the range*/
+  cursors->push_back(index->GetIndex()->Scan(lower, lower_inclusive, upper, upper_inclusive));
+}
+
+void ExecuteEngine::SortRowIds(RowIdList *result) {
+  if (!std::is_sorted(result->begin(), result->end(), RowIdLess)) {
+    std::sort(result->begin(), result->end(), RowIdLess);
+  }
+  result->erase(std::unique(result->begin(), result->end()), result->end());
+}
+
+bool ExecuteEngine::ReadRowIds(IndexCursors *cursors, size_t maxrows, RowIdList *result) {
+  for (auto &cursor : *cursors) {
+    for (; !cursor->IsEnd(); cursor->Next()) {
+      if (result->size() == maxrows) {
+        return false;
       }
-      cout << "Wrong column name!" << endl;
-      return kFalse;
+      (*result).push_back(cursor->GetRowId());
     }
   }
-  return kFalse;
+  return true;
 }
 
-CmpBool ExecuteEngine::Travel(TableInfo *currenttable, TableIterator &tableit, pSyntaxNode root) {
-  if (root->type_ == kNodeConnector) {
-    if (strcmp(root->val_, "and") == 0) {
-      if (Travel(currenttable, tableit, root->child_) == kTrue &&
-          Travel(currenttable, tableit, root->child_->next_) == kTrue)
-        return kTrue;
-      return kFalse;
-    } else if (strcmp(root->val_, "or") == 0) {
-      if (Travel(currenttable, tableit, root->child_) == kTrue ||
-          Travel(currenttable, tableit, root->child_->next_) == kTrue)
-        return kTrue;
-      return kFalse;
+bool ExecuteEngine::IndexCovers(IndexInfo *index, const vector<Column *> &columns) {
+  for (auto column : columns) {
+    uint32_t columnindex;
+    if (index->GetIndexEntrySchema()->GetColumnIndex(column->GetName(), columnindex) != DB_SUCCESS) {
+      return false;
     }
-    return kFalse;  // 可能还有别的Connector吧不管了现在这边返回一下
-  } else if (root->type_ == kNodeCompareOperator) {
-    char *cmpoperator = root->val_;
-    char *op1 = root->child_->val_;
-    if (root->child_->next_->type_ == kNodeNumber || root->child_->next_->type_ == kNodeString) {
-      char *op2 = root->child_->next_->val_;
-      Field *now{};
-      uint32_t op1index{};
-      if (currenttable->GetSchema()->GetColumnIndex(op1, op1index)) {
-        now = (*tableit).GetField(op1index);
-        TypeId typeop1 = currenttable->GetSchema()->GetColumn(op1index)->GetType();
-        Field *pto;
-        if (typeop1 == kTypeInt) {
-          Field o(typeop1, atoi(op2));
-          pto = &o;
-        } else if (typeop1 == kTypeFloat) {
-          Field o(typeop1, (float)atof(op2));
-          pto = &o;
-        } else if (typeop1 == kTypeChar) {
-          Field o(typeop1, op2, strlen(op2), true);
-          pto = &o;
-        }
+  }
+  return true;
+}
 
-        if (strcmp(cmpoperator, "=") == 0) {
-          return now->CompareEquals(*pto);
-        } else if (strcmp(cmpoperator, ">") == 0) {
-          return now->CompareGreaterThan(*pto);
-        } else if (strcmp(cmpoperator, "<") == 0) {
-          return now->CompareLessThan(*pto);
-        } else if (strcmp(cmpoperator, "<>") == 0) {
-          return now->CompareNotEquals(*pto);
-        } else if (strcmp(cmpoperator, "<=") == 0) {
-          return now->CompareLessThanEquals(*pto);
-        } else if (strcmp(cmpoperator, ">=") == 0) {
-          return now->CompareGreaterThanEquals(*pto);
-        }
-      }
-    } else if (root->child_->next_->type_ == kNodeNull) {
-      if (strcmp(cmpoperator, "is") == 0) {
-        // is null
-        Field *now{};
-        uint32_t op1index{};
-        if (currenttable->GetSchema()->GetColumnIndex(op1, op1index)) {
-          now = (*tableit).GetField(op1index);
-          return GetCmpBool(now->IsNull());
-        }
-      } else if (strcmp(cmpoperator, "not") == 0) {
-        // not null
-        Field *now{};
-        uint32_t op1index{};
-        if (currenttable->GetSchema()->GetColumnIndex(op1, op1index)) {
-          now = (*tableit).GetField(op1index);
-          return GetCmpBool(!(now->IsNull()));
-        }
-      }
+bool ExecuteEngine::IndexBetween(DBStorageEngine *Currentp, TableInfo *currenttable, pSyntaxNode left,
+                                 pSyntaxNode right, IndexInfo *&index, IndexCursors *cursors,
+                                 ExecuteContext *context) {
+  pSyntaxNode lower = nullptr;
+  pSyntaxNode upper = nullptr;
+  for (pSyntaxNode bound : {left, right}) {
+    if (bound->type_ != kNodeCompareOperator ||
+        (bound->child_->next_->type_ != kNodeNumber && bound->child_->next_->type_ != kNodeString)) {
+      return false;
+    }
+    if (strcmp(bound->val_, ">") == 0 || strcmp(bound->val_, ">=") == 0) {
+      lower = bound;
+    } else if (strcmp(bound->val_, "<") == 0 || strcmp(bound->val_, "<=") == 0) {
+      upper = bound;
     }
   }
-  return kFalse;
+  if (lower == nullptr || upper == nullptr || strcmp(lower->child_->val_, upper->child_->val_) != 0) {
+    return false;
+  }
+  index = FindColumnIndex(Currentp, currenttable, lower->child_->val_);
+  if (index == nullptr) {
+    return false;
+  }
+  vector<Field> lowerfield = MakeKeyFields(currenttable, lower->child_);
+  vector<Field> upperfield = MakeKeyFields(currenttable, upper->child_);
+  Row lowerrow(lowerfield, context->heap_);
+  Row upperrow(upperfield, context->heap_);
+  IndexRangeScan(index, &lowerrow, strcmp(lower->val_, ">=") == 0, &upperrow, strcmp(upper->val_, "<=") == 0,
+                 cursors);
+  return true;
 }
 
 dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
@@ -794,7 +805,6 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
   ast = ast->next_;
   TableInfo *currenttable;
   vector<Column *> columns;
-  Transaction *txn{};
   for (auto it = dbs_.begin(); it != dbs_.end(); it++) {
     if (it->first == current_db_) {
       Currentp = it->second;
@@ -818,49 +828,51 @@ dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
   }
   ast = ast->next_;
   // 此处开始判断条件
-  if (ast != NULL && ast->type_ == kNodeConditions) {
-    pSyntaxNode root = ast->child_;
-    vector<RowId> result;
-
-    if (NewTravel(Currentp, currenttable, root, &result) == DB_SUCCESS) {
-      for (auto i = result.begin(); i != result.end(); i++) {
-        Row nowrow(*i);
-        currenttable->GetTableHeap()->GetTuple(&nowrow, txn);
-        for (auto fielditer = columns.begin(); fielditer != columns.end(); fielditer++) {
-          uint32_t fieldid;
-          currenttable->GetSchema()->GetColumnIndex((*fielditer)->GetName(), fieldid);
-
-          std::cout << nowrow.GetField(fieldid)->GetData() << " ";
+  if (ast != NULL && ast->type_ != kNodeConditions) {
+    return DB_FAILED;
+  }
+  pSyntaxNode root = ast == NULL ? nullptr : ast->child_;
+  if (root != nullptr) {
+    IndexInfo *index = nullptr;
+    IndexCursors cursors;
+    if (IndexScan(Currentp, currenttable, root, index, &cursors, context) && IndexCovers(index, columns)) {
+      /*the selected columns are decoded from the index entries, no row is fetched from the heap*/
+      Schema *entryschema = index->GetIndexEntrySchema();
+      for (auto &cursor : cursors) {
+        for (; !cursor->IsEnd(); cursor->Next()) {
+          Row entry(INVALID_ROWID, context->heap_);
+          cursor->GetEntry(entry);
+          for (auto fielditer = columns.begin(); fielditer != columns.end(); fielditer++) {
+            uint32_t fieldid;
+            entryschema->GetColumnIndex((*fielditer)->GetName(), fieldid);
+            PrintField(*entry.GetField(fieldid));
+          }
+          std::cout << std::endl;
         }
-        std::cout << std::endl;
       }
+      return DB_SUCCESS;
     }
-    return DB_SUCCESS;
-  } else if (ast == NULL) {  // 没有条件
-    TableIterator tableit(currenttable->GetTableHeap()->Begin(txn));
-    for (/*tableit == currenttable->GetTableHeap()->Begin(txn)*/; tableit != currenttable->GetTableHeap()->End();
-         tableit++) {
-      // 打印
-      Row row((*tableit).GetRowId());
-      currenttable->GetTableHeap()->GetTuple(&row, txn);
-
-      for (auto i = columns.begin(); i != columns.end(); i++) {
-        uint32_t tmpcolumnindex{};
-        currenttable->GetSchema()->GetColumnIndex((*i)->GetName(), tmpcolumnindex);
-        Field *tmpField = row.GetField(tmpcolumnindex);
-        if (tmpField->IsNull())
-          cout << "null"
-               << " ";
-        else
-          cout << tmpField->GetData() << " ";
+  }
+  /*the rows are fetched from the heap, an index path has to beat a full scan*/
+  vector<uint32_t> columnids;
+  for (auto column : columns) {
+    uint32_t columnindex;
+    currenttable->GetSchema()->GetColumnIndex(column->GetName(), columnindex);
+    columnids.push_back(columnindex);
+  }
+  RowIdList rows(MemHeapAllocator<RowId>(context->heap_));
+  ProjectionOperator plan(PlanScan(Currentp, currenttable, root, &rows, context), columnids);
+  RowBatch batch;
+  while (plan.Next(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      const RowView &row = batch.At(i);
+      for (auto column : batch.GetColumns()) {
+        PrintField(row.GetField(column));
       }
-      // row.GetField();
       cout << endl;
-      cout << "-------------" << endl;
     }
-    return DB_SUCCESS;
   }
-  return DB_FAILED;
+  return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
@@ -934,7 +946,7 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
     }
     ast = ast->next_;
   }
-  Row row(newfield);
+  Row row(newfield, context->heap_);
 
   Currentp->catalog_mgr_->GetTableIndexes(currenttable->GetTableName(), indexes);
   // 检查newfield是否符合插入条件
@@ -950,7 +962,8 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
     if ((*columnsiter)->IsUnique()) {
       // 如果该列上有index
       for (auto iterindexes = indexes.begin(); iterindexes != indexes.end(); iterindexes++) {
-        if ((*iterindexes)->GetIndexKeySchema()->GetColumn(0)->GetName() == (*columnsiter)->GetName()) {
+        if ((*iterindexes)->IsUnique() && (*iterindexes)->GetIndexKeySchema()->GetColumnCount() == 1 &&
+            (*iterindexes)->GetIndexKeySchema()->GetColumn(0)->GetName() == (*columnsiter)->GetName()) {
           // 通过index找有无重复
           vector<RowId> result;
           int position;
@@ -960,7 +973,7 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
           currenttable->GetSchema()->GetColumnIndex((*columnsiter)->GetName(), keyindex);
           vector<Field> rowkeyfield;
           rowkeyfield.push_back(*row.GetField(keyindex));
-          Row rowkey(rowkeyfield);
+          Row rowkey(rowkeyfield, context->heap_);
           if ((*iterindexes)->GetIndex()->ScanKey(rowkey, result, position, leaf_page_id, txn) == DB_SUCCESS) {
             cout << "对于Unique列，不应该插入重复的元组" << endl;
             return DB_FAILED;
@@ -973,11 +986,11 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
       if (check == false) {
         TableIterator tableit(currenttable->GetTableHeap()->Begin(txn));
         for (tableit == currenttable->GetTableHeap()->Begin(txn); tableit != currenttable->GetTableHeap()->End();
-             tableit++) {
+             ++tableit) {
           uint32_t indexop1{};
           currenttable->GetSchema()->GetColumnIndex((*columnsiter)->GetName(), indexop1);
-          Field *currentfield = (*tableit).GetField(indexop1);
-          if (currentfield->CompareEquals(newfield[indexop1]) == kTrue) {
+          Field currentfield = tableit.GetRowView().GetField(indexop1);
+          if (currentfield.CompareEquals(newfield[indexop1]) == kTrue) {
             cout << "对于Unique列，不应该插入重复的元组" << endl;
             return DB_FAILED;
           }
@@ -998,7 +1011,7 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
     // 此时说明是联合主键
     //TableIterator tableit(currenttable->GetTableHeap()->Begin(txn));
     //for (tableit == currenttable->GetTableHeap()->Begin(txn); tableit != currenttable->GetTableHeap()->End();
-    //     tableit++) {
+    //     ++tableit) {
     //  for (iter = columnindexes.begin(); iter != columnindexes.end(); iter++) {
     //    if (row.GetField(*iter)->CompareEquals(*((*tableit).GetField(*iter))) != kTrue) {
     //      break;
@@ -1023,7 +1036,7 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
         for (auto it = columnindexes.begin(); it != columnindexes.end(); it++) {
           rowkeyfield.push_back(*row.GetField(*it));
         }
-        Row rowkey(rowkeyfield);
+        Row rowkey(rowkeyfield, context->heap_);
         if ((*iterindexes)->GetIndex()->ScanKey(rowkey, result, position, leaf_page_id, txn) == DB_SUCCESS) {
           cout << "对于primary key列，不应该插入重复的元组" << endl;
           return DB_FAILED;
@@ -1041,12 +1054,12 @@ dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
       uint32_t keyindex;
       uint32_t i = 0;
       vector<Field> rowkeyfield;
-      for (i = 0; i < (*iterindexes)->GetIndexKeySchema()->GetColumnCount(); i++) {
-        currenttable->GetSchema()->GetColumnIndex((*iterindexes)->GetIndexKeySchema()->GetColumn(i)->GetName(),
+      for (i = 0; i < (*iterindexes)->GetIndexEntrySchema()->GetColumnCount(); i++) {
+        currenttable->GetSchema()->GetColumnIndex((*iterindexes)->GetIndexEntrySchema()->GetColumn(i)->GetName(),
                                                   keyindex);
         rowkeyfield.push_back(*row.GetField(keyindex));
       }
-      Row rowkey(rowkeyfield);
+      Row rowkey(rowkeyfield, context->heap_);
       if ((*iterindexes)->GetIndex()->InsertEntry(rowkey, row.GetRowId(), txn) == DB_FAILED) return DB_FAILED;
     }
     return DB_SUCCESS;
@@ -1074,50 +1087,24 @@ dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
   if (ast->type_ == kNodeIdentifier) {
     if (Currentp->catalog_mgr_->GetTable(ast->val_, currenttable) == DB_TABLE_NOT_EXIST) return DB_TABLE_NOT_EXIST;
   }
-  // 全表删除
-  if (ast->next_ == NULL) {
-    TableIterator tableit(currenttable->GetTableHeap()->Begin(txn));
-    for (tableit == currenttable->GetTableHeap()->Begin(txn); tableit != currenttable->GetTableHeap()->End();
-         tableit++) {
-      if (currenttable->GetTableHeap()->MarkDelete((*tableit).GetRowId(), txn) == false) return DB_FAILED;
-      currenttable->GetTableHeap()->ApplyDelete((*tableit).GetRowId(), txn);
-    }
-    // 更新pagerootid
-    currenttable->SetRootPageId();
-    return DB_SUCCESS;
+  pSyntaxNode root = nullptr;
+  if (ast->next_ != NULL) {
+    ast = ast->next_;  // kNodeConditions
+    if (ast->type_ != kNodeConditions) return DB_FAILED;
+    root = ast->child_;
   }
-  ast = ast->next_;  // kNodeConditions
   vector<IndexInfo *> indexes;
   Currentp->catalog_mgr_->GetTableIndexes(currenttable->GetTableName(), indexes);
-  if (ast->type_ == kNodeConditions) {
-    pSyntaxNode root = ast->child_;
-    vector<RowId> result;
-    if (NewTravel(Currentp, currenttable, root, &result) == DB_SUCCESS) {
-      for (auto iterresult = result.begin(); iterresult != result.end(); iterresult++) {
-        Row nowrow(*iterresult);
-        currenttable->GetTableHeap()->GetTuple(&nowrow, txn);
-        currenttable->GetTableHeap()->MarkDelete((*iterresult), txn);
-        currenttable->GetTableHeap()->ApplyDelete((*iterresult), txn);
-        // 更新pagerootid
-        currenttable->SetRootPageId();
-        for (auto iterindexes = indexes.begin(); iterindexes != indexes.end(); iterindexes++) {
-          uint32_t keyindex;
-          uint32_t i = 0;
-          vector<Field> rowkeyfield;
-          for (i = 0; i < (*iterindexes)->GetIndexKeySchema()->GetColumnCount(); i++) {
-            currenttable->GetSchema()->GetColumnIndex((*iterindexes)->GetIndexKeySchema()->GetColumn(i)->GetName(),
-                                                      keyindex);
-            
-            rowkeyfield.push_back(*nowrow.GetField(keyindex));
-          }
-          Row rowkey(rowkeyfield);
-          if ((*iterindexes)->GetIndex()->RemoveEntry(rowkey, (*iterresult), txn) == DB_FAILED) return DB_FAILED;
-        }
-      }
-      return DB_SUCCESS;
-    }
+  RowIdList rows(MemHeapAllocator<RowId>(context->heap_));
+  DeleteOperator plan(PlanScan(Currentp, currenttable, root, &rows, context), currenttable, indexes, txn,
+                      context->heap_);
+  RowBatch batch;
+  while (plan.Next(&batch)) {
   }
-  return DB_FAILED;
+  if (plan.GetStatus() != DB_SUCCESS) return plan.GetStatus();
+  // 全表删除 succeeds on an empty table, a condition has to match some rows
+  if (root != nullptr && plan.GetCount() == 0) return DB_FAILED;
+  return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
@@ -1143,10 +1130,8 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
   vector<Field> update;
   vector<uint32_t> FieldColumn;
   vector<Column *> columns = currenttable->GetSchema()->GetColumns();
-  int updatecolumn = 0;
   ast = ast->next_;  // kNodeUpdateValues
   pSyntaxNode record = ast;
-  vector<Column> primarykey = currenttable->GetPrimaryKey();
   if (ast->type_ == kNodeUpdateValues) {
     ast = ast->child_;
     while (ast != NULL) {
@@ -1206,141 +1191,14 @@ dberr_t ExecuteEngine::ExecuteUpdate(pSyntaxNode ast, ExecuteContext *context) {
   vector<IndexInfo *> indexes;
   Currentp->catalog_mgr_->GetTableIndexes(currenttable->GetTableName(), indexes);
   if (astCondition != NULL && astCondition->type_ == kNodeConditions) {
-    pSyntaxNode root = astCondition->child_;
-    vector<RowId> result;
-    if (NewTravel(Currentp, currenttable, root, &result) == DB_SUCCESS) {
-      for (auto iterresult = result.begin(); iterresult != result.end(); iterresult++) {
-        updatecolumn = 0;
-
-        Row rowp(*iterresult);
-        currenttable->GetTableHeap()->GetTuple(&rowp, txn);
-        Row previous = rowp;
-        vector<Field *> pre = previous.GetFields();
-
-        for (auto updateiter = update.begin(); updateiter != update.end(); updateiter++) {
-          Field tmp(*updateiter);
-          Swap((*updateiter), *(pre[FieldColumn[updatecolumn]]));
-          Swap((*updateiter), tmp);
-          updatecolumn++;
-        }
-        Row nowrow(*iterresult);
-        currenttable->GetTableHeap()->GetTuple(&nowrow, txn);
-        // 检查unique约束
-        bool check = false;
-        vector<Column *> uniqueColumns;
-        for (auto columnsiter = columns.begin(); columnsiter != columns.end(); columnsiter++) {
-          check = false;
-          if ((*columnsiter)->IsUnique()) {
-            // 如果该列上有index
-            for (auto iterindexes = indexes.begin(); iterindexes != indexes.end(); iterindexes++) {
-              if ((*iterindexes)->GetIndexKeySchema()->GetColumn(0)->GetName() == (*columnsiter)->GetName()) {
-                // 通过index找有无重复
-                vector<RowId> Scanresult;
-
-                int position;
-                page_id_t leaf_page_id;
-                uint32_t keyindex;
-                currenttable->GetSchema()->GetColumnIndex((*columnsiter)->GetName(), keyindex);
-                vector<Field> rowkeyfield;
-                rowkeyfield.push_back(*previous.GetField(keyindex));
-                Row rowkey(rowkeyfield);
-                if ((*iterindexes)->GetIndex()->ScanKey(rowkey, Scanresult, position, leaf_page_id, txn) ==
-                    DB_SUCCESS) {
-                  // if (Scanresult[0])
-                  if (*iterresult == Scanresult[0]) {
-                    continue;
-                  }
-                  cout << "对于Unique列，不应该插入重复的元组" << endl;
-                  return DB_FAILED;
-                }
-                check = true;
-                break;
-              }
-            }
-            // 如果该列上没有index，用tableiterator来检查有无重复tuple
-            if (check == false) {
-              TableIterator tableit(currenttable->GetTableHeap()->Begin(txn));
-              for (tableit == currenttable->GetTableHeap()->Begin(txn); tableit != currenttable->GetTableHeap()->End();
-                   tableit++) {
-                if ((*tableit).GetRowId() == (*iterresult)) continue;
-                uint32_t indexop1{};
-                currenttable->GetSchema()->GetColumnIndex((*columnsiter)->GetName(), indexop1);
-                Field *currentfield = (*tableit).GetField(indexop1);
-                if (currentfield->CompareEquals(*pre[indexop1]) == kTrue) {
-                  cout << "对于Unique列，不应该插入重复的元组" << endl;
-                  return DB_FAILED;
-                }
-              }
-            }
-          }
-        }
-        // primary key约束
-        if (1) {
-          vector<uint32_t> columnindexes;
-          vector<uint32_t>::iterator iter;
-          for (auto piter = primarykey.begin(); piter != primarykey.end(); piter++) {
-            uint32_t tmpindex;
-            currenttable->GetSchema()->GetColumnIndex((*piter).GetName(), tmpindex);
-            columnindexes.push_back(tmpindex);
-          }
-          /*// 此时说明是联合主键
-          currenttable->GetTableHeap()->GetTuple(&nowrow, txn);
-          TableIterator tableit(currenttable->GetTableHeap()->Begin(txn));
-          for (tableit == currenttable->GetTableHeap()->Begin(txn); tableit != currenttable->GetTableHeap()->End();
-               tableit++) {
-            if ((*tableit).GetRowId() == (*iterresult)) continue;
-            for (iter = columnindexes.begin(); iter != columnindexes.end(); iter++) {
-              if (previous.GetField(*iter)->CompareEquals(*((*tableit).GetField(*iter))) != kTrue) {
-                break;
-              }
-            }
-            if (iter == columnindexes.end())  // 所有的field都一样
-            {
-              cout << "conflict with primary key!" << endl;
-              return DB_FAILED;
-            }
-          }*/
-          /*find the index for pk*/
-          for (auto iterindexes = indexes.begin(); iterindexes != indexes.end(); iterindexes++) {
-            if ((*iterindexes)->GetIndexName() == "primarykey") {
-              vector<RowId> result;
-              int position;
-              page_id_t leaf_page_id;
-
-              vector<Field> rowkeyfield;
-              /*get the key value of pk*/
-              for (auto it = columnindexes.begin(); it != columnindexes.end(); it++) {
-                rowkeyfield.push_back(*previous.GetField(*it));
-              }
-              Row rowkey(rowkeyfield);
-              if ((*iterindexes)->GetIndex()->ScanKey(rowkey, result, position, leaf_page_id, txn) == DB_SUCCESS) {
-                cout << "对于primary key列，不应该插入重复的元组" << endl;
-                return DB_FAILED;
-              }
-              break;
-            }
-          }
-        }
-        if (currenttable->GetTableHeap()->UpdateTuple(previous, (*iterresult), txn) == false) return DB_FAILED;
-        // 更新rootpageid
-        currenttable->SetRootPageId();
-        // 修改index
-        for (auto iterindexes = indexes.begin(); iterindexes != indexes.end(); iterindexes++) {
-          uint32_t keyindex;
-          uint32_t i = 0;
-          vector<Field> rowkeyfield;
-          for (i = 0; i < (*iterindexes)->GetIndexKeySchema()->GetColumnCount(); i++) {
-            currenttable->GetSchema()->GetColumnIndex((*iterindexes)->GetIndexKeySchema()->GetColumn(0)->GetName(),
-                                                      keyindex);
-            rowkeyfield.push_back(*previous.GetField(keyindex));
-          }
-          Row rowkey(rowkeyfield);
-          if ((*iterindexes)->GetIndex()->RemoveEntry(rowkey, previous.GetRowId(), txn) == DB_FAILED) return DB_FAILED;
-          if ((*iterindexes)->GetIndex()->InsertEntry(rowkey, previous.GetRowId(), txn) == DB_FAILED) return DB_FAILED;
-        }
-      }
-      return DB_SUCCESS;
+    RowIdList rows(MemHeapAllocator<RowId>(context->heap_));
+    UpdateOperator plan(PlanScan(Currentp, currenttable, astCondition->child_, &rows, context), currenttable,
+                        indexes, FieldColumn, update, txn, context->heap_);
+    RowBatch batch;
+    while (plan.Next(&batch)) {
     }
+    if (plan.GetStatus() != DB_SUCCESS) return plan.GetStatus();
+    if (plan.GetCount() != 0) return DB_SUCCESS;
     cout << "No Such Rows!" << endl;
   }
   return DB_FAILED;
@@ -1438,3 +1296,22 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
   }*/
   return DB_SUCCESS;
 }
+
+dberr_t ExecuteEngine::ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteAnalyze" << std::endl;
+#endif
+  ast = ast->child_;
+  auto it = dbs_.find(current_db_);
+  if (it == dbs_.end()) {
+    cout << "No database selected" << endl;
+    return DB_FAILED;
+  }
+  TableInfo *currenttable = nullptr;
+  dberr_t result = it->second->catalog_mgr_->AnalyzeTable(ast->val_, currenttable);
+  if (result == DB_SUCCESS) {
+    TableStatistics *stats = currenttable->GetStatistics();
+    cout << ast->val_ << ": " << stats->GetRowCount() << " rows in " << stats->GetPageCount() << " pages" << endl;
+  }
+  return result;
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "executor/filter_kernels.h"
+
+template<typename T, typename Test>
+static inline void FilterValues(const T *values, size_t begin, size_t count, uint64_t *mask, Test test) {
+  for (size_t i = begin; i < count; i++) {
+    mask[i / 64] |= static_cast<uint64_t>(test(values[i])) << (i % 64);
+  }
+}
+
+/*values from begin on, one at a time; the operator is looked at once, not once per value*/
+template<typename T>
+static void FilterScalar(const T *values, size_t begin, size_t count, CompareOp op, T constant, uint64_t *mask) {
+  switch (op) {
+    case CompareOp::kEqual:
+      FilterValues(values, begin, count, mask, [constant](T value) { return value == constant; });
+      break;
+    case CompareOp::kNotEqual:
+      FilterValues(values, begin, count, mask, [constant](T value) { return value != constant; });
+      break;
+    case CompareOp::kLess:
+      FilterValues(values, begin, count, mask, [constant](T value) { return value < constant; });
+      break;
+    case CompareOp::kLessEqual:
+      FilterValues(values, begin, count, mask, [constant](T value) { return value <= constant; });
+      break;
+    case CompareOp::kGreater:
+      FilterValues(values, begin, count, mask, [constant](T value) { return value > constant; });
+      break;
+    case CompareOp::kGreaterEqual:
+      FilterValues(values, begin, count, mask, [constant](T value) { return value >= constant; });
+      break;
+  }
+}
+
+#ifdef __AVX2__
+/*eight int32 compared at once, the result of each lane as one bit*/
+template<CompareOp op>
+static inline uint32_t CompareLanes(__m256i values, __m256i constant) {
+  __m256i result;
+  if (op == CompareOp::kEqual || op == CompareOp::kNotEqual) {
+    result = _mm256_cmpeq_epi32(values, constant);
+  } else if (op == CompareOp::kGreater || op == CompareOp::kLessEqual) {
+    result = _mm256_cmpgt_epi32(values, constant);
+  } else {
+    result = _mm256_cmpgt_epi32(constant, values);
+  }
+  auto bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(result)));
+  /*there are only equal and greater than for integers, the other operators negate them*/
+  bool negate = op == CompareOp::kNotEqual || op == CompareOp::kLessEqual || op == CompareOp::kGreaterEqual;
+  return negate ? bits ^ 0xFF : bits;
+}
+
+template<CompareOp op>
+static inline uint32_t CompareLanes(__m256 values, __m256 constant) {
+  constexpr int predicate = op == CompareOp::kEqual        ? _CMP_EQ_OQ
+                            : op == CompareOp::kNotEqual   ? _CMP_NEQ_UQ
+                            : op == CompareOp::kLess       ? _CMP_LT_OQ
+                            : op == CompareOp::kLessEqual  ? _CMP_LE_OQ
+                            : op == CompareOp::kGreater    ? _CMP_GT_OQ
+                                                           : _CMP_GE_OQ;
+  return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(values, constant, predicate)));
+}
+
+/*the values in groups of eight, returns how many were done; a word of the mask takes eight groups*/
+template<CompareOp op>
+static size_t FilterLanes(const int32_t *values, size_t count, int32_t constant, uint64_t *mask) {
+  __m256i broadcast = _mm256_set1_epi32(constant);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+    mask[i / 64] |= static_cast<uint64_t>(CompareLanes<op>(lanes, broadcast)) << (i % 64);
+  }
+  return i;
+}
+
+template<CompareOp op>
+static size_t FilterLanes(const float *values, size_t count, float constant, uint64_t *mask) {
+  __m256 broadcast = _mm256_set1_ps(constant);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 lanes = _mm256_loadu_ps(values + i);
+    mask[i / 64] |= static_cast<uint64_t>(CompareLanes<op>(lanes, broadcast)) << (i % 64);
+  }
+  return i;
+}
+
+template<typename T>
+static size_t FilterVector(const T *values, size_t count, CompareOp op, T constant, uint64_t *mask) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return FilterLanes<CompareOp::kEqual>(values, count, constant, mask);
+    case CompareOp::kNotEqual:
+      return FilterLanes<CompareOp::kNotEqual>(values, count, constant, mask);
+    case CompareOp::kLess:
+      return FilterLanes<CompareOp::kLess>(values, count, constant, mask);
+    case CompareOp::kLessEqual:
+      return FilterLanes<CompareOp::kLessEqual>(values, count, constant, mask);
+    case CompareOp::kGreater:
+      return FilterLanes<CompareOp::kGreater>(values, count, constant, mask);
+    case CompareOp::kGreaterEqual:
+      return FilterLanes<CompareOp::kGreaterEqual>(values, count, constant, mask);
+  }
+  return 0;
+}
+#endif
+
+template<typename T>
+static void Filter(const T *values, size_t count, CompareOp op, T constant, uint64_t *mask) {
+  std::fill(mask, mask + MaskWords(count), 0);
+  size_t done = 0;
+#ifdef __AVX2__
+  done = FilterVector(values, count, op, constant, mask);
+#endif
+  /*the values left over from the last group of eight*/
+  FilterScalar(values, done, count, op, constant, mask);
+}
+
+void FilterInt32(const int32_t *values, size_t count, CompareOp op, int32_t constant, uint64_t *mask) {
+  Filter(values, count, op, constant, mask);
+}
+
+void FilterFloat(const float *values, size_t count, CompareOp op, float constant, uint64_t *mask) {
+  Filter(values, count, op, constant, mask);
+}
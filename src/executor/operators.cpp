@@ -0,0 +1,238 @@
+#include <iostream>
+
+#include "executor/operators.h"
+
+SeqScanOperator::SeqScanOperator(TableHeap *table_heap, Transaction *txn)
+    : table_heap_(table_heap), txn_(txn), iterator_(table_heap->Begin(txn)) {}
+
+bool SeqScanOperator::Next(RowBatch *batch) {
+  batch->Clear();
+  /*the views of the batch point into page_, the iterator has pinned the next page once the batch is full*/
+  for (; iterator_ != table_heap_->End() && batch->Size() < RowBatch::MAX_SIZE; ++iterator_) {
+    RowId rid = iterator_.GetRowId();
+    if (batch->Size() != 0 && page_->GetTablePageId() != rid.GetPageId()) {
+      break;
+    }
+    if (!table_heap_->GetTupleView(rid, batch->Append(), page_, txn_)) {
+      batch->Truncate(batch->Size() - 1);
+    }
+  }
+  return batch->Size() != 0;
+}
+
+bool IndexScanOperator::Next(RowBatch *batch) {
+  batch->Clear();
+  for (; next_ < rows_->size() && batch->Size() < RowBatch::MAX_SIZE; next_++) {
+    const RowId &rid = (*rows_)[next_];
+    if (batch->Size() != 0 && page_->GetTablePageId() != rid.GetPageId()) {
+      break;
+    }
+    if (!table_heap_->GetTupleView(rid, batch->Append(), page_, txn_)) {
+      batch->Truncate(batch->Size() - 1);
+    }
+  }
+  return batch->Size() != 0;
+}
+
+bool FilterOperator::Next(RowBatch *batch) {
+  while (child_->Next(batch)) {
+    predicate_.Evaluate(*batch, &selection_);
+    /*the rows that pass move to the front of the batch, the set bits of the selection are visited in order*/
+    size_t kept = 0;
+    for (size_t word = 0; word < selection_.size(); word++) {
+      for (uint64_t bits = selection_[word]; bits != 0; bits &= bits - 1) {
+        size_t i = word * 64 + __builtin_ctzll(bits);
+        if (kept != i) {
+          std::swap(batch->At(kept), batch->At(i));
+        }
+        kept++;
+      }
+    }
+    batch->Truncate(kept);
+    if (kept != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ProjectionOperator::Next(RowBatch *batch) {
+  if (!child_->Next(batch)) {
+    return false;
+  }
+  if (batch->GetColumns() != columns_) {
+    batch->SetColumns(columns_);
+  }
+  return true;
+}
+
+/*the key of a row in index, with the include columns after it*/
+static Row MakeIndexEntry(TableInfo *table, IndexInfo *index, Row &row, MemHeap *heap) {
+  std::vector<Field> fields;
+  Schema *entry_schema = index->GetIndexEntrySchema();
+  for (uint32_t i = 0; i < entry_schema->GetColumnCount(); i++) {
+    uint32_t column_id;
+    table->GetSchema()->GetColumnIndex(entry_schema->GetColumn(i)->GetName(), column_id);
+    fields.push_back(*row.GetField(column_id));
+  }
+  return Row(fields, heap);
+}
+
+bool DeleteOperator::Next(RowBatch *batch) {
+  if (status_ != DB_SUCCESS || !child_->Next(batch)) {
+    return false;
+  }
+  /*deleting a tuple moves the others of its page, the views of the batch are done with first*/
+  std::vector<RowId> rids;
+  for (size_t i = 0; i < batch->Size(); i++) {
+    rids.push_back(batch->At(i).GetRowId());
+  }
+  batch->Clear();
+  TableHeap *table_heap = table_->GetTableHeap();
+  for (auto &rid : rids) {
+    Row row(rid, heap_);
+    table_heap->GetTuple(&row, txn_);
+    if (!table_heap->MarkDelete(rid, txn_)) {
+      status_ = DB_FAILED;
+      return false;
+    }
+    table_heap->ApplyDelete(rid, txn_);
+    for (auto index : indexes_) {
+      Row key = MakeIndexEntry(table_, index, row, heap_);
+      if (index->GetIndex()->RemoveEntry(key, rid, txn_) == DB_FAILED) {
+        status_ = DB_FAILED;
+        return false;
+      }
+    }
+    count_++;
+  }
+  // 更新pagerootid
+  table_->SetRootPageId();
+  return true;
+}
+
+bool UpdateOperator::Next(RowBatch *batch) {
+  if (status_ != DB_SUCCESS) {
+    return false;
+  }
+  /*
+   * every row is found before the first one is updated: a row that no longer fits its page moves to another,
+   * maybe one the scan has not reached yet, which would then update it a second time
+   */
+  RowIdList rids{MemHeapAllocator<RowId>(heap_)};
+  while (child_->Next(batch)) {
+    for (size_t i = 0; i < batch->Size(); i++) {
+      rids.push_back(batch->At(i).GetRowId());
+    }
+  }
+  batch->Clear();
+  for (auto &rid : rids) {
+    status_ = UpdateRow(rid);
+    if (status_ != DB_SUCCESS) {
+      return false;
+    }
+    count_++;
+  }
+  return false;
+}
+
+dberr_t UpdateOperator::UpdateRow(const RowId &rid) {
+  TableHeap *table_heap = table_->GetTableHeap();
+  Row rowp(rid, heap_);
+  table_heap->GetTuple(&rowp, txn_);
+  Row previous = rowp;
+  vector<Field *> pre = previous.GetFields();
+  for (size_t i = 0; i < values_.size(); i++) {
+    Field value(values_[i]);
+    Swap(value, *(pre[columns_[i]]));
+  }
+  Row nowrow(rid, heap_);
+  table_heap->GetTuple(&nowrow, txn_);
+  // 检查unique约束
+  vector<Column *> columns = table_->GetSchema()->GetColumns();
+  for (auto columnsiter = columns.begin(); columnsiter != columns.end(); columnsiter++) {
+    if (!(*columnsiter)->IsUnique()) {
+      continue;
+    }
+    bool check = false;
+    // 如果该列上有index
+    for (auto iterindexes = indexes_.begin(); iterindexes != indexes_.end(); iterindexes++) {
+      if ((*iterindexes)->IsUnique() && (*iterindexes)->GetIndexKeySchema()->GetColumnCount() == 1 &&
+          (*iterindexes)->GetIndexKeySchema()->GetColumn(0)->GetName() == (*columnsiter)->GetName()) {
+        // 通过index找有无重复
+        vector<RowId> Scanresult;
+        int position;
+        page_id_t leaf_page_id;
+        uint32_t keyindex;
+        table_->GetSchema()->GetColumnIndex((*columnsiter)->GetName(), keyindex);
+        vector<Field> rowkeyfield;
+        rowkeyfield.push_back(*previous.GetField(keyindex));
+        Row rowkey(rowkeyfield, heap_);
+        if ((*iterindexes)->GetIndex()->ScanKey(rowkey, Scanresult, position, leaf_page_id, txn_) == DB_SUCCESS &&
+            !(Scanresult.size() == 1 && Scanresult[0] == rid)) {
+          std::cout << "对于Unique列，不应该插入重复的元组" << std::endl;
+          return DB_FAILED;
+        }
+        check = true;
+        break;
+      }
+    }
+    // 如果该列上没有index，用tableiterator来检查有无重复tuple
+    if (check == false) {
+      for (TableIterator tableit(table_heap->Begin(txn_)); tableit != table_heap->End(); ++tableit) {
+        if (tableit.GetRowId() == rid) continue;
+        uint32_t indexop1{};
+        table_->GetSchema()->GetColumnIndex((*columnsiter)->GetName(), indexop1);
+        Field *currentfield = (*tableit).GetField(indexop1);
+        if (currentfield->CompareEquals(*pre[indexop1]) == kTrue) {
+          std::cout << "对于Unique列，不应该插入重复的元组" << std::endl;
+          return DB_FAILED;
+        }
+      }
+    }
+  }
+  // primary key约束
+  vector<uint32_t> columnindexes;
+  vector<Column> primarykey = table_->GetPrimaryKey();
+  for (auto piter = primarykey.begin(); piter != primarykey.end(); piter++) {
+    uint32_t tmpindex;
+    table_->GetSchema()->GetColumnIndex((*piter).GetName(), tmpindex);
+    columnindexes.push_back(tmpindex);
+  }
+  /*find the index for pk*/
+  for (auto iterindexes = indexes_.begin(); iterindexes != indexes_.end(); iterindexes++) {
+    if ((*iterindexes)->GetIndexName() == "primarykey") {
+      vector<RowId> result;
+      int position;
+      page_id_t leaf_page_id;
+      vector<Field> rowkeyfield;
+      /*get the key value of pk*/
+      for (auto it = columnindexes.begin(); it != columnindexes.end(); it++) {
+        rowkeyfield.push_back(*previous.GetField(*it));
+      }
+      Row rowkey(rowkeyfield, heap_);
+      /*the row itself keeps its key when the update leaves the primary key as it was*/
+      if ((*iterindexes)->GetIndex()->ScanKey(rowkey, result, position, leaf_page_id, txn_) == DB_SUCCESS &&
+          !(result.size() == 1 && result[0] == rid)) {
+        std::cout << "对于primary key列，不应该插入重复的元组" << std::endl;
+        return DB_FAILED;
+      }
+      break;
+    }
+  }
+  RowId updated = rid;
+  if (table_heap->UpdateTuple(previous, updated, txn_) == false) return DB_FAILED;
+  // 更新rootpageid
+  table_->SetRootPageId();
+  /*
+   * the entry of the old key goes, a non-unique index would still return the row for it otherwise;
+   * the new one points to where the tuple is now, which is another rid if it had to move
+   */
+  for (auto index : indexes_) {
+    Row oldkey = MakeIndexEntry(table_, index, nowrow, heap_);
+    Row rowkey = MakeIndexEntry(table_, index, previous, heap_);
+    if (index->GetIndex()->RemoveEntry(oldkey, rid, txn_) == DB_FAILED) return DB_FAILED;
+    if (index->GetIndex()->InsertEntry(rowkey, updated, txn_) == DB_FAILED) return DB_FAILED;
+  }
+  return DB_SUCCESS;
+}
@@ -0,0 +1,266 @@
+#include <algorithm>
+#include <iostream>
+
+#include "executor/operators.h"
+#include "executor/predicate.h"
+
+Predicate::Predicate(pSyntaxNode root, Schema *schema) {
+  Compile(root, schema, 0);
+  stack_.resize(max_depth_);
+  operands_.resize(max_depth_);
+}
+
+void Predicate::Compile(pSyntaxNode root, Schema *schema, uint32_t depth) {
+  max_depth_ = std::max(max_depth_, depth + 1);
+  Instruction instruction{Op::kFalse};
+  if (root->type_ == kNodeConnector) {
+    if (strcmp(root->val_, "and") == 0 || strcmp(root->val_, "or") == 0) {
+      /*the right operand ends up on top of the left one*/
+      Compile(root->child_, schema, depth);
+      Compile(root->child_->next_, schema, depth + 1);
+      instruction.op_ = strcmp(root->val_, "and") == 0 ? Op::kAnd : Op::kOr;
+    }
+    program_.push_back(instruction);
+    return;
+  }
+  if (root->type_ != kNodeCompareOperator) {
+    program_.push_back(instruction);
+    return;
+  }
+  const char *cmpoperator = root->val_;
+  pSyntaxNode value = root->child_->next_;
+  if (schema->GetColumnIndex(root->child_->val_, instruction.column_) != DB_SUCCESS) {
+    std::cout << "Wrong column name!" << std::endl;
+    program_.push_back(instruction);
+    return;
+  }
+  if (value->type_ == kNodeNull) {
+    if (strcmp(cmpoperator, "is") == 0) {
+      instruction.op_ = Op::kIsNull;
+    } else if (strcmp(cmpoperator, "not") == 0) {
+      instruction.op_ = Op::kIsNotNull;
+    }
+    program_.push_back(instruction);
+    return;
+  }
+  if (value->type_ != kNodeNumber && value->type_ != kNodeString) {
+    program_.push_back(instruction);
+    return;
+  }
+  instruction.op_ = Op::kCompare;
+  if (strcmp(cmpoperator, "=") == 0) {
+    instruction.compare_op_ = CompareOp::kEqual;
+  } else if (strcmp(cmpoperator, "<>") == 0 || strcmp(cmpoperator, "!=") == 0) {
+    instruction.compare_op_ = CompareOp::kNotEqual;
+  } else if (strcmp(cmpoperator, "<") == 0) {
+    instruction.compare_op_ = CompareOp::kLess;
+  } else if (strcmp(cmpoperator, "<=") == 0) {
+    instruction.compare_op_ = CompareOp::kLessEqual;
+  } else if (strcmp(cmpoperator, ">") == 0) {
+    instruction.compare_op_ = CompareOp::kGreater;
+  } else if (strcmp(cmpoperator, ">=") == 0) {
+    instruction.compare_op_ = CompareOp::kGreaterEqual;
+  } else {
+    instruction.op_ = Op::kFalse;
+    program_.push_back(instruction);
+    return;
+  }
+  /*the literal takes the type of the column, serialized the way the tuples store it*/
+  TypeId type = schema->GetColumn(instruction.column_)->GetType();
+  Field literal(type);
+  if (type == kTypeInt) {
+    literal = Field(type, atoi(value->val_));
+  } else if (type == kTypeFloat) {
+    literal = Field(type, (float)atof(value->val_));
+  } else if (type == kTypeChar) {
+    literal = Field(type, value->val_, strlen(value->val_), false);
+  }
+  instruction.literal_ = literals_.size();
+  literals_.resize(literals_.size() + literal.GetSerializedSize());
+  literal.SerializeTo(literals_.data() + instruction.literal_);
+  instruction.type_ = type;
+  /*int and float columns are compared as vectors, conditions on the same column share one*/
+  if (type == kTypeInt || type == kTypeFloat) {
+    for (instruction.vector_ = 0; instruction.vector_ < vectors_.size(); instruction.vector_++) {
+      if (vectors_[instruction.vector_].column_ == instruction.column_) {
+        break;
+      }
+    }
+    if (instruction.vector_ == vectors_.size()) {
+      vectors_.emplace_back();
+      vectors_.back().column_ = instruction.column_;
+      vectors_.back().type_ = type;
+    }
+  }
+  program_.push_back(instruction);
+}
+
+bool Predicate::Evaluate(const RowView &row) const {
+  uint8_t *stack = operands_.data();
+  uint32_t top = 0;
+  for (auto &instruction : program_) {
+    bool result = false;
+    switch (instruction.op_) {
+      case Op::kAnd:
+        top--;
+        stack[top - 1] = stack[top - 1] && stack[top];
+        continue;
+      case Op::kOr:
+        top--;
+        stack[top - 1] = stack[top - 1] || stack[top];
+        continue;
+      case Op::kIsNull:
+        result = row.IsNull(instruction.column_);
+        break;
+      case Op::kIsNotNull:
+        result = !row.IsNull(instruction.column_);
+        break;
+      case Op::kFalse:
+        break;
+      case Op::kCompare:
+        if (!row.IsNull(instruction.column_)) {
+          const char *data = row.GetFieldData(instruction.column_);
+          const char *literal = literals_.data() + instruction.literal_;
+          int cmp = DispatchColumnComparator(instruction.type_, [&](auto comparator) {
+            return decltype(comparator)::CompareSerialized(data, literal);
+          });
+          switch (instruction.compare_op_) {
+            case CompareOp::kEqual:
+              result = cmp == 0;
+              break;
+            case CompareOp::kNotEqual:
+              result = cmp != 0;
+              break;
+            case CompareOp::kLess:
+              result = cmp < 0;
+              break;
+            case CompareOp::kLessEqual:
+              result = cmp <= 0;
+              break;
+            case CompareOp::kGreater:
+              result = cmp > 0;
+              break;
+            case CompareOp::kGreaterEqual:
+              result = cmp >= 0;
+              break;
+          }
+        }
+        break;
+    }
+    stack[top++] = result;
+  }
+  return stack[0];
+}
+
+const Predicate::ColumnVector &Predicate::Decode(const Instruction &instruction, const RowBatch &batch) const {
+  ColumnVector &vector = vectors_[instruction.vector_];
+  if (vector.decoded_) {
+    return vector;
+  }
+  size_t size = batch.Size();
+  vector.not_null_.assign(MaskWords(size), 0);
+  if (vector.type_ == kTypeInt) {
+    vector.ints_.resize(size);
+  } else {
+    vector.floats_.resize(size);
+  }
+  /*a null is decoded as 0, its bit in not_null_ drops it from the result*/
+  for (size_t i = 0; i < size; i++) {
+    const RowView &row = batch.At(i);
+    bool null = row.IsNull(vector.column_);
+    vector.not_null_[i / 64] |= static_cast<uint64_t>(!null) << (i % 64);
+    if (vector.type_ == kTypeInt) {
+      vector.ints_[i] = null ? 0 : row.GetInt(vector.column_);
+    } else {
+      vector.floats_[i] = null ? 0 : row.GetFloat(vector.column_);
+    }
+  }
+  vector.decoded_ = true;
+  return vector;
+}
+
+template<typename Comparator>
+void Predicate::CompareBatch(const Instruction &instruction, const RowBatch &batch, uint64_t *selection) const {
+  const char *literal = literals_.data() + instruction.literal_;
+  auto compare = [&](auto test) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      const RowView &row = batch.At(i);
+      bool pass = !row.IsNull(instruction.column_) &&
+                  test(Comparator::CompareSerialized(row.GetFieldData(instruction.column_), literal));
+      selection[i / 64] |= static_cast<uint64_t>(pass) << (i % 64);
+    }
+  };
+  switch (instruction.compare_op_) {
+    case CompareOp::kEqual:
+      compare([](int cmp) { return cmp == 0; });
+      break;
+    case CompareOp::kNotEqual:
+      compare([](int cmp) { return cmp != 0; });
+      break;
+    case CompareOp::kLess:
+      compare([](int cmp) { return cmp < 0; });
+      break;
+    case CompareOp::kLessEqual:
+      compare([](int cmp) { return cmp <= 0; });
+      break;
+    case CompareOp::kGreater:
+      compare([](int cmp) { return cmp > 0; });
+      break;
+    case CompareOp::kGreaterEqual:
+      compare([](int cmp) { return cmp >= 0; });
+      break;
+  }
+}
+
+void Predicate::Evaluate(const RowBatch &batch, std::vector<uint64_t> *selection) const {
+  size_t size = batch.Size();
+  size_t words = MaskWords(size);
+  for (auto &vector : vectors_) {
+    vector.decoded_ = false;
+  }
+  uint32_t top = 0;
+  for (auto &instruction : program_) {
+    if (instruction.op_ == Op::kAnd || instruction.op_ == Op::kOr) {
+      top--;
+      uint64_t *left = stack_[top - 1].data();
+      const uint64_t *right = stack_[top].data();
+      for (size_t i = 0; i < words; i++) {
+        left[i] = instruction.op_ == Op::kAnd ? (left[i] & right[i]) : (left[i] | right[i]);
+      }
+      continue;
+    }
+    stack_[top].assign(words, 0);
+    uint64_t *result = stack_[top++].data();
+    if (instruction.op_ == Op::kCompare && instruction.vector_ != NO_VECTOR) {
+      const ColumnVector &vector = Decode(instruction, batch);
+      const char *literal = literals_.data() + instruction.literal_;
+      if (vector.type_ == kTypeInt) {
+        FilterInt32(vector.ints_.data(), size, instruction.compare_op_, MACH_READ_INT32(literal), result);
+      } else {
+        FilterFloat(vector.floats_.data(), size, instruction.compare_op_, MACH_READ_FROM(float, literal), result);
+      }
+      for (size_t i = 0; i < words; i++) {
+        result[i] &= vector.not_null_[i];
+      }
+      continue;
+    }
+    /*char columns are compared in place, the type and the operator are looked at once per batch, not once per row*/
+    switch (instruction.op_) {
+      case Op::kCompare:
+        DispatchColumnComparator(instruction.type_, [&](auto comparator) {
+          CompareBatch<decltype(comparator)>(instruction, batch, result);
+        });
+        break;
+      case Op::kIsNull:
+      case Op::kIsNotNull:
+        for (size_t i = 0; i < size; i++) {
+          bool pass = batch.At(i).IsNull(instruction.column_) == (instruction.op_ == Op::kIsNull);
+          result[i / 64] |= static_cast<uint64_t>(pass) << (i % 64);
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  selection->assign(stack_[0].begin(), stack_[0].begin() + words);
+}
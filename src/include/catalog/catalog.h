@@ -52,13 +52,22 @@ public:
     return &index_meta_pages_;
   }
 
+  /**
+   * Used only for testing
+   */
+  inline std::map<table_id_t, page_id_t> *GetTableStatisticsPages() {
+    return &table_stats_pages_;
+  }
+
 private:
   explicit CatalogMeta();
 
 private:
-  static constexpr uint32_t CATALOG_METADATA_MAGIC_NUM = 89849;
+  static constexpr uint32_t CATALOG_METADATA_MAGIC_NUM = 89850;
+  static constexpr uint32_t CATALOG_METADATA_MAGIC_NUM_V1 = 89849;  // written before there were statistics
   std::map<table_id_t, page_id_t> table_meta_pages_;
   std::map<index_id_t, page_id_t> index_meta_pages_;
+  std::map<table_id_t, page_id_t> table_stats_pages_;
 };
 
 /**
@@ -81,9 +90,14 @@ public:
 
   dberr_t GetTables(std::vector<TableInfo *> &tables) const;
 
+  /**
+   * A unique index keeps one row per key, a non-unique one any number of rows.
+   * The include columns are stored in the entries after the key, they take no part in lookups.
+   */
   dberr_t CreateIndex(const std::string &table_name, const std::string &index_name,
                       const std::vector<std::string> &index_keys, Transaction *txn,
-                      IndexInfo *&index_info);
+                      IndexInfo *&index_info, bool unique = true,
+                      const std::vector<std::string> &index_includes = std::vector<std::string>());
 
   dberr_t GetIndex(const std::string &table_name, const std::string &index_name, IndexInfo *&index_info) const;
 
@@ -93,6 +107,11 @@ public:
 
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
+  /**
+   * Collect the statistics of a table and store them with the catalog, they replace those of the last analyze
+   */
+  dberr_t AnalyzeTable(const std::string &table_name, TableInfo *&table_info);
+
 private:
   dberr_t FlushCatalogMetaPage() const;
 
@@ -100,6 +119,11 @@ private:
 
   dberr_t LoadIndex(const index_id_t index_id, const page_id_t page_id);
 
+  /**
+   * Fill the empty index of index_info with the rows of its table, bottom-up from the sorted keys
+   */
+  dberr_t BuildIndex(IndexInfo *index_info, Transaction *txn);
+
   dberr_t GetTable(const table_id_t table_id, TableInfo *&table_info);
 
 private:
@@ -4,18 +4,28 @@
 #include <memory>
 
 #include "catalog/table.h"
+#include "index/basic_comparator.h"
 #include "index/generic_key.h"
 #include "index/b_plus_tree_index.h"
 #include "record/schema.h"
 #include "common/macros.h"
 
+/**
+ * Which B+ tree an index is built on
+ */
+enum IndexKeyKind {
+  kIndexKeyGeneric = 0,   // GenericKey in the encoding of KeyCodec, any key schema
+  kIndexKeyInt,           // int32_t keys, only for a single int column
+};
+
 class IndexMetadata {
   friend class IndexInfo;
 
 public:
   static IndexMetadata *Create(const index_id_t index_id, const std::string &index_name,
                                const table_id_t table_id, const std::vector<uint32_t> &key_map,
-                               MemHeap *heap);
+                               MemHeap *heap, IndexKeyKind key_kind = kIndexKeyGeneric, bool unique = true,
+                               const std::vector<uint32_t> &include_map = std::vector<uint32_t>());
 
   uint32_t SerializeTo(char *buf) const;
 
@@ -31,25 +41,54 @@ public:
 
   inline const std::vector<uint32_t> &GetKeyMapping() const { return key_map_; }
 
+  inline const std::vector<uint32_t> &GetIncludeMapping() const { return include_map_; }
+
   inline index_id_t GetIndexId() const { return index_id_; }
 
+  inline IndexKeyKind GetKeyKind() const { return key_kind_; }
+
+  inline bool IsUnique() const { return unique_; }
+
+  /**
+   * Whether the index was written with keys in the row format that came before KeyCodec, or
+   * with pages in the format that came before prefix compression, its tree has to be rebuilt
+   * before it is used
+   */
+  inline bool HasLegacyTree() const { return legacy_tree_; }
+
 private:
   IndexMetadata() = delete;
 
   explicit IndexMetadata(const index_id_t index_id, const std::string &index_name,
-                         const table_id_t table_id, const std::vector<uint32_t> &key_map) :
+                         const table_id_t table_id, const std::vector<uint32_t> &key_map,
+                         IndexKeyKind key_kind, bool unique, const std::vector<uint32_t> &include_map) :
       index_id_(index_id),
       index_name_(index_name),
       table_id_(table_id),
-      key_map_(key_map){
+      key_map_(key_map),
+      key_kind_(key_kind),
+      unique_(unique),
+      include_map_(include_map){
   }
 
 private:
-  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344528;
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM = 344532;
+  /* metadata written before the key kind was recorded, always generic with keys in the old row format */
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM_V1 = 344528;
+  /* metadata written before uniqueness was recorded, always unique */
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM_V2 = 344529;
+  /* metadata written before include columns were recorded, none */
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM_V3 = 344530;
+  /* metadata of a tree whose pages store keys whole, in the same format as the current one */
+  static constexpr uint32_t INDEX_METADATA_MAGIC_NUM_V4 = 344531;
   index_id_t index_id_;
   std::string index_name_;
   table_id_t table_id_;
   std::vector<uint32_t> key_map_;  /** The mapping of index key to tuple key */
+  IndexKeyKind key_kind_;
+  bool unique_;  /** Whether a key maps to one row at most */
+  std::vector<uint32_t> include_map_;  /** Tuple columns stored in the entries after the key */
+  bool legacy_tree_{false};
 };
 
 /**
@@ -70,34 +109,90 @@ public:
     meta_data_ = meta_data;
     table_info_ = table_info;
     key_schema_ = key_schema_->ShallowCopySchema(table_info->GetSchema(), meta_data->GetKeyMapping(), heap_);
+    entry_schema_ = key_schema_;
+    if (!meta_data->GetIncludeMapping().empty()) {
+      std::vector<uint32_t> entry_map(meta_data->GetKeyMapping());
+      entry_map.insert(entry_map.end(), meta_data->GetIncludeMapping().begin(), meta_data->GetIncludeMapping().end());
+      entry_schema_ = entry_schema_->ShallowCopySchema(table_info->GetSchema(), entry_map, heap_);
+    }
     index_ = CreateIndex(buffer_pool_manager);
     // Step1: init index metadata and table info
     // Step2: mapping index key to key schema
     // Step3: call CreateIndex to create the index
   }
 
+  /**
+   * Widest key an index can be built on, in the encoding of KeyCodec
+   */
+  static constexpr uint32_t MAX_KEY_SIZE = 128;
+
   inline Index *GetIndex() { return index_; }
 
   inline std::string GetIndexName() { return meta_data_->GetIndexName(); }
 
   inline IndexSchema *GetIndexKeySchema() { return key_schema_; }
 
+  /**
+   * Columns held by the entries of the index, the key columns followed by the include columns
+   */
+  inline IndexSchema *GetIndexEntrySchema() { return entry_schema_; }
+
   inline MemHeap *GetMemHeap() const { return heap_; }
 
   inline TableInfo *GetTableInfo() const { return table_info_; }
 
   inline IndexMetadata *GetIndexMeta() const { return meta_data_; }
 
+  inline bool IsUnique() const { return meta_data_->IsUnique(); }
+
  private:
   explicit IndexInfo() : meta_data_{nullptr}, index_{nullptr}, table_info_{nullptr},
-                         key_schema_{nullptr}, heap_(new SimpleMemHeap()) {}
+                         key_schema_{nullptr}, entry_schema_{nullptr}, heap_(new ArenaMemHeap()) {}
+
+  /*
+   * pick the narrowest key that holds every key of this schema, narrow keys give more entries per page;
+   * sizes grow by 1.5x-2x so that a slot wastes at most a third of its bytes.
+   * Include columns are stored after the key, a non-unique index needs room for the row id after them.
+   */
+  Index *CreateIndex(BufferPoolManager *buffer_pool_manager) {
+    if (meta_data_->GetKeyKind() == kIndexKeyInt) {
+      using INT_INDEX = BPlusTreeIndex<int32_t, RowId, BasicComparator<int32_t>>;
+      void *buf = heap_->Allocate(sizeof(INT_INDEX));
+      return new (buf) INT_INDEX(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager);
+    }
+    uint32_t key_size = KeyCodec::GetMaxEncodedSize(entry_schema_);
+    if (!meta_data_->IsUnique()) {
+      key_size += KeyCodec::ROW_ID_SIZE;
+    }
+    ASSERT(key_size <= MAX_KEY_SIZE, "Index key size exceed max key size.");
+    if (key_size <= 4) {
+      return CreateBPlusTreeIndex<4>(buffer_pool_manager);
+    } else if (key_size <= 8) {
+      return CreateBPlusTreeIndex<8>(buffer_pool_manager);
+    } else if (key_size <= 16) {
+      return CreateBPlusTreeIndex<16>(buffer_pool_manager);
+    } else if (key_size <= 24) {
+      return CreateBPlusTreeIndex<24>(buffer_pool_manager);
+    } else if (key_size <= 32) {
+      return CreateBPlusTreeIndex<32>(buffer_pool_manager);
+    } else if (key_size <= 48) {
+      return CreateBPlusTreeIndex<48>(buffer_pool_manager);
+    } else if (key_size <= 64) {
+      return CreateBPlusTreeIndex<64>(buffer_pool_manager);
+    } else if (key_size <= 96) {
+      return CreateBPlusTreeIndex<96>(buffer_pool_manager);
+    }
+    return CreateBPlusTreeIndex<128>(buffer_pool_manager);
+  }
 
-  Index *CreateIndex(BufferPoolManager *buffer_pool_manager) { 
-    using INDEX_KEY_TYPE = GenericKey<32>;
-    using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  template<size_t KeySize>
+  Index *CreateBPlusTreeIndex(BufferPoolManager *buffer_pool_manager) {
+    using INDEX_KEY_TYPE = GenericKey<KeySize>;
+    using INDEX_COMPARATOR_TYPE = GenericComparator<KeySize>;
     using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
     void *buf = heap_->Allocate(sizeof(BP_TREE_INDEX));
-    return new (buf) BP_TREE_INDEX(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager);
+    return new (buf) BP_TREE_INDEX(meta_data_->GetIndexId(), key_schema_, buffer_pool_manager,
+                                   meta_data_->IsUnique(), entry_schema_);
   }
 
 private:
@@ -105,6 +200,7 @@ private:
   Index *index_;//索引对象
   TableInfo *table_info_;//表格信息
   IndexSchema *key_schema_;//索引模式
+  IndexSchema *entry_schema_;
   MemHeap *heap_;
 };
 
@@ -0,0 +1,103 @@
+#ifndef MINISQL_STATISTICS_H
+#define MINISQL_STATISTICS_H
+
+#include <vector>
+
+#include "common/macros.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+
+/**
+ * HyperLogLog sketch, estimates the number of distinct values added to it in 2^PRECISION bytes.
+ * The standard error is about 1.04 / sqrt(2^PRECISION), 1.6% here.
+ */
+class HyperLogLog {
+public:
+  HyperLogLog() : registers_(1u << PRECISION, 0) {}
+
+  /**
+   * Add a value by its 64-bit hash, the bits of the hash have to be evenly distributed
+   */
+  void Add(uint64_t hash);
+
+  uint32_t Estimate() const;
+
+  /**
+   * 64-bit hash of data, good enough for Add
+   */
+  static uint64_t Hash(const char *data, uint32_t len);
+
+private:
+  static constexpr uint32_t PRECISION = 12;
+  std::vector<uint8_t> registers_;
+};
+
+/**
+ * Statistics of one column of a table
+ */
+struct ColumnStatistics {
+  uint32_t distinct_{0};  // estimated number of distinct values, nulls not counted
+  uint32_t nulls_{0};     // number of null values
+  /*
+   * equi-depth histogram of an int or float column, empty for char columns or if all values are null:
+   * bounds_.front() is the min and bounds_.back() the max of the column, each bucket between two
+   * neighbouring bounds holds the same share of the not null values
+   */
+  std::vector<double> bounds_;
+};
+
+/**
+ * Statistics of a table collected by analyze, the planner estimates the rows a condition selects from them.
+ * They are as old as the last analyze, the table may have changed since.
+ */
+class TableStatistics {
+public:
+  /**
+   * Scan the table once: rows, pages, nulls, min/max and distinct values are taken from every row,
+   * the histograms from a reservoir sample of the rows
+   */
+  static TableStatistics *Analyze(TableHeap *table_heap, Schema *schema, MemHeap *heap);
+
+  uint32_t SerializeTo(char *buf) const;
+
+  uint32_t GetSerializedSize() const;
+
+  static uint32_t DeserializeFrom(char *buf, TableStatistics *&table_stats, MemHeap *heap);
+
+  /**
+   * Release statistics made by Analyze or DeserializeFrom from heap, null is ignored
+   */
+  static void Destroy(TableStatistics *table_stats, MemHeap *heap);
+
+  inline uint32_t GetRowCount() const { return row_count_; }
+
+  inline uint32_t GetPageCount() const { return page_count_; }
+
+  inline const ColumnStatistics &GetColumnStatistics(uint32_t column_id) const { return columns_[column_id]; }
+
+  /**
+   * Estimated share of the rows whose column compares to value by op: "=", "<>", "<", "<=", ">", ">=",
+   * or "is"/"not" for is null/is not null, which ignore value. A range of a char column is guessed.
+   */
+  double Selectivity(uint32_t column_id, const char *op, double value) const;
+
+  static constexpr uint32_t SAMPLE_ROWS = 4096;
+  static constexpr uint32_t HISTOGRAM_BUCKETS = 16;
+
+private:
+  TableStatistics() = default;
+
+  /**
+   * Share of the not null values of column below value, or up to and including value
+   */
+  double LessThan(const ColumnStatistics &column, double value, bool inclusive) const;
+
+private:
+  static constexpr uint32_t TABLE_STATISTICS_MAGIC_NUM = 344540;
+  static constexpr double DEFAULT_RANGE_SELECTIVITY = 1.0 / 3;
+  uint32_t row_count_{0};
+  uint32_t page_count_{0};
+  std::vector<ColumnStatistics> columns_;
+};
+
+#endif  // MINISQL_STATISTICS_H
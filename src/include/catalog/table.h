@@ -2,6 +2,7 @@
 #define MINISQL_TABLE_H
 
 #include <memory>
+#include "catalog/statistics.h"
 #include "common/macros.h"
 #include "glog/logging.h"
 #include "record/schema.h"
@@ -95,12 +96,20 @@ public:
   //I add this function
   inline TableMetadata *GetTableMeta() { return table_meta_; }
 
+  /**
+   * @return the statistics of the last analyze, nullptr if the table was never analyzed
+   */
+  inline TableStatistics *GetStatistics() const { return table_stats_; }
+
+  inline void SetStatistics(TableStatistics *table_stats) { table_stats_ = table_stats; }
+
 private:
-  explicit TableInfo() : heap_(new SimpleMemHeap()) {};
+  explicit TableInfo() : heap_(new ArenaMemHeap()) {};
 
 private:
   TableMetadata *table_meta_;
   TableHeap *table_heap_;
+  TableStatistics *table_stats_{nullptr};
   MemHeap *heap_; /** store all objects allocated in table_meta and table heap */
   //vector<Column> primarykey;
 };
@@ -15,6 +15,8 @@ static constexpr int INDEX_ROOTS_PAGE_ID = 1;        // logical page id of the i
 
 static constexpr int PAGE_SIZE = 4096;               // size of a data page in byte
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 1024;// default size of buffer pool
+static constexpr double DEFAULT_INDEX_FILL_FACTOR = 0.9;// share of each index page filled by bulk loading
+static constexpr double RANDOM_PAGE_COST = 4.0;      // cost of a heap page fetched for an index entry, in pages read by a full scan
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
 static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;    // max length of varchar
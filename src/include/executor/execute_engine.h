@@ -1,12 +1,16 @@
 #ifndef MINISQL_EXECUTE_ENGINE_H
 #define MINISQL_EXECUTE_ENGINE_H
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "common/dberr.h"
 #include "common/instance.h"
+#include "executor/operators.h"
 #include "transaction/transaction.h"
 #include "storage/table_iterator.h"
+#include "utils/mem_heap.h"
 extern "C" {
 #include "parser/parser.h"
 };
@@ -20,8 +24,13 @@ extern "C" {
 struct ExecuteContext {
   bool flag_quit_{false};
   Transaction *txn_{nullptr};
+  /* per-statement memory context, set up by ExecuteEngine::Execute and released in one shot at statement end */
+  MemHeap *heap_{nullptr};
 };
 
+/* scans of one index a where clause is answered by, <> takes two */
+using IndexCursors = std::vector<std::unique_ptr<IndexCursor>>;
+
 /**
  * ExecuteEngine
  */
@@ -41,6 +50,11 @@ public:
   dberr_t Execute(pSyntaxNode ast, ExecuteContext *context);
 
 private:
+  /* asks for the index paths of a where clause directly */
+  friend class PlannerTest;
+
+  dberr_t ExecuteStatement(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteDropDatabase(pSyntaxNode ast, ExecuteContext *context);
@@ -79,12 +93,79 @@ private:
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
-  CmpBool Travel(TableInfo *currenttable, TableIterator &tableit, pSyntaxNode root);
+  dberr_t ExecuteAnalyze(pSyntaxNode ast, ExecuteContext *context);
+
+  /**
+   * The scan of the rows of the table that satisfy root, all of them if root is null: the rows of index paths,
+   * or a full scan with a filter, whichever reads fewer pages. rows holds the row ids of the index paths,
+   * it has to outlive the scan
+   */
+  std::unique_ptr<Operator> PlanScan(DBStorageEngine *Currentp, TableInfo *currenttable, pSyntaxNode root,
+                                     RowIdList *rows, ExecuteContext *context);
 
-  CmpBool TravelWithoutIndex(TableInfo *currenttable, TableIterator &tableit, pSyntaxNode root);
+  /**
+   * The rows of root read by indexes: one index scan, the intersection or union of the index paths of
+   * and/or, or the rows of the index path of one side of and checked against the other side.
+   * false once the paths select more than maxrows rows, a full scan is cheaper then
+   */
+  bool IndexPath(DBStorageEngine *Currentp, TableInfo *currenttable, pSyntaxNode root, size_t maxrows,
+                 RowIdList *result, ExecuteContext *context);
 
-  dberr_t NewTravel(DBStorageEngine *Currentp, TableInfo *currenttable,
-                           pSyntaxNode root, vector<RowId> *result);
+  /**
+   * Share of the rows of the table that satisfy root by the statistics of its last analyze,
+   * negative if the table was never analyzed or root is no condition on its columns
+   */
+  double EstimateSelectivity(TableInfo *currenttable, pSyntaxNode root);
+
+  /**
+   * Add the rows that satisfy root to result
+   */
+  void FilterRows(TableInfo *currenttable, pSyntaxNode root, RowIdList *rows, RowIdList *result);
+
+  /**
+   * The single column index on column, nullptr if there is none
+   */
+  IndexInfo *FindColumnIndex(DBStorageEngine *Currentp, TableInfo *currenttable, const char *column);
+
+  /**
+   * The key fields of a comparison of a column with a literal, column is the first child of the comparison
+   */
+  std::vector<Field> MakeKeyFields(TableInfo *currenttable, pSyntaxNode column);
+
+  /**
+   * Open the scans of an index that select the rows of root: a comparison of an indexed column with
+   * a literal, or a lower and an upper bound on one joined by and. false if root is neither
+   */
+  bool IndexScan(DBStorageEngine *Currentp, TableInfo *currenttable, pSyntaxNode root, IndexInfo *&index,
+                 IndexCursors *cursors, ExecuteContext *context);
+
+  /**
+   * Add a scan of index with keys from lower to upper to cursors, a null bound leaves that side open
+   */
+  void IndexRangeScan(IndexInfo *index, const Row *lower, bool lower_inclusive, const Row *upper,
+                      bool upper_inclusive, IndexCursors *cursors);
+
+  /**
+   * Scan the index once for a lower and an upper bound on the same column joined by and,
+   * false if the two comparisons are not such a range
+   */
+  bool IndexBetween(DBStorageEngine *Currentp, TableInfo *currenttable, pSyntaxNode left, pSyntaxNode right,
+                    IndexInfo *&index, IndexCursors *cursors, ExecuteContext *context);
+
+  /**
+   * Sort result by row id and drop duplicates, which is the page order of the rows
+   */
+  void SortRowIds(RowIdList *result);
+
+  /**
+   * Add the rows of the entries left in cursors to result, false if there are more than maxrows
+   */
+  bool ReadRowIds(IndexCursors *cursors, size_t maxrows, RowIdList *result);
+
+  /**
+   * Whether the entries of index hold every one of columns, a select of them needs no row from the heap
+   */
+  bool IndexCovers(IndexInfo *index, const std::vector<Column *> &columns);
 
 private:
   bool isRecons;
@@ -0,0 +1,32 @@
+#ifndef MINISQL_FILTER_KERNELS_H
+#define MINISQL_FILTER_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Filter kernels: compare a vector of column values with a constant and produce a selection bitmask,
+ * bit i % 64 of word i / 64 is set if values[i] passes. mask has (count + 63) / 64 words, the bits
+ * past count are left clear.
+ *
+ * With AVX2 eight values are compared per instruction, otherwise one at a time.
+ */
+enum class CompareOp : uint8_t {
+  kEqual,
+  kNotEqual,
+  kLess,
+  kLessEqual,
+  kGreater,
+  kGreaterEqual,
+};
+
+void FilterInt32(const int32_t *values, size_t count, CompareOp op, int32_t constant, uint64_t *mask);
+
+void FilterFloat(const float *values, size_t count, CompareOp op, float constant, uint64_t *mask);
+
+/**
+ * Words of a bitmask of count bits
+ */
+inline size_t MaskWords(size_t count) { return (count + 63) / 64; }
+
+#endif  // MINISQL_FILTER_KERNELS_H
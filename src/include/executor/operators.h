@@ -0,0 +1,220 @@
+#ifndef MINISQL_OPERATORS_H
+#define MINISQL_OPERATORS_H
+
+#include <memory>
+#include <vector>
+
+#include "catalog/indexes.h"
+#include "catalog/table.h"
+#include "common/dberr.h"
+#include "executor/predicate.h"
+#include "record/row_view.h"
+#include "utils/mem_heap.h"
+
+/* row ids collected while evaluating a where clause, they live in the statement's memory context */
+using RowIdList = std::vector<RowId, MemHeapAllocator<RowId>>;
+
+/**
+ * Rows passed from one operator to the next.
+ *
+ * The rows are read in place from a single heap page, which the scan that produced them keeps
+ * pinned until it is asked for the next batch. A batch holds at most the rows of one page.
+ * The views are reused from batch to batch, so a batch allocates nothing once it has grown.
+ */
+class RowBatch {
+public:
+  inline size_t Size() const { return size_; }
+
+  inline RowView &At(size_t i) { return rows_[i]; }
+
+  inline const RowView &At(size_t i) const { return rows_[i]; }
+
+  /**
+   * Add a row at the end, the caller points the returned view at it
+   */
+  inline RowView *Append() {
+    if (size_ == rows_.size()) {
+      rows_.emplace_back();
+    }
+    return &rows_[size_++];
+  }
+
+  inline void Clear() { size_ = 0; }
+
+  /**
+   * Keep the first size rows
+   */
+  inline void Truncate(size_t size) { size_ = size; }
+
+  /**
+   * Columns of the rows visible to the consumer, set by a projection. Empty for all of them
+   */
+  inline const std::vector<uint32_t> &GetColumns() const { return columns_; }
+
+  inline void SetColumns(const std::vector<uint32_t> &columns) { columns_ = columns; }
+
+  static constexpr size_t MAX_SIZE = 1024;
+
+private:
+  std::vector<RowView> rows_;
+  size_t size_{0};
+  std::vector<uint32_t> columns_;
+};
+
+/**
+ * Physical operator: a node of the plan of a statement, pulling batches of rows from its child
+ */
+class Operator {
+public:
+  virtual ~Operator() = default;
+
+  /**
+   * Fill batch with the next rows, false once there are none left. The rows of the last batch
+   * are released by the call.
+   */
+  virtual bool Next(RowBatch *batch) = 0;
+};
+
+/**
+ * Every row of a table, page by page
+ */
+class SeqScanOperator : public Operator {
+public:
+  SeqScanOperator(TableHeap *table_heap, Transaction *txn);
+
+  ~SeqScanOperator() override { table_heap_->ReleasePage(page_); }
+
+  bool Next(RowBatch *batch) override;
+
+private:
+  TableHeap *table_heap_;
+  Transaction *txn_;
+  TableIterator iterator_;
+  TablePage *page_{nullptr};
+};
+
+/**
+ * The rows of a list of row ids, found by the index paths of a where clause.
+ * Rows of one page in a row make one batch, sorting the list by row id reads each page once.
+ */
+class IndexScanOperator : public Operator {
+public:
+  IndexScanOperator(TableHeap *table_heap, const RowIdList *rows, Transaction *txn)
+      : table_heap_(table_heap), rows_(rows), txn_(txn) {}
+
+  ~IndexScanOperator() override { table_heap_->ReleasePage(page_); }
+
+  bool Next(RowBatch *batch) override;
+
+private:
+  TableHeap *table_heap_;
+  const RowIdList *rows_;
+  Transaction *txn_;
+  size_t next_{0};
+  TablePage *page_{nullptr};
+};
+
+/**
+ * The rows of the child that satisfy a predicate, batches left empty are skipped.
+ * The predicate is evaluated over the whole batch at once.
+ */
+class FilterOperator : public Operator {
+public:
+  FilterOperator(std::unique_ptr<Operator> child, Predicate predicate)
+      : child_(std::move(child)), predicate_(std::move(predicate)) {}
+
+  bool Next(RowBatch *batch) override;
+
+private:
+  std::unique_ptr<Operator> child_;
+  Predicate predicate_;
+  std::vector<uint64_t> selection_;
+};
+
+/**
+ * Restricts the rows of the child to some of their columns. Nothing is copied, the batch only
+ * records which columns its consumer sees.
+ */
+class ProjectionOperator : public Operator {
+public:
+  ProjectionOperator(std::unique_ptr<Operator> child, std::vector<uint32_t> columns)
+      : child_(std::move(child)), columns_(std::move(columns)) {}
+
+  bool Next(RowBatch *batch) override;
+
+private:
+  std::unique_ptr<Operator> child_;
+  std::vector<uint32_t> columns_;
+};
+
+/**
+ * Deletes the rows of the child from the table and its indexes. Each call deletes one batch
+ * of the child and leaves batch empty.
+ */
+class DeleteOperator : public Operator {
+public:
+  DeleteOperator(std::unique_ptr<Operator> child, TableInfo *table, std::vector<IndexInfo *> indexes,
+                 Transaction *txn, MemHeap *heap)
+      : child_(std::move(child)), table_(table), indexes_(std::move(indexes)), txn_(txn), heap_(heap) {}
+
+  bool Next(RowBatch *batch) override;
+
+  /**
+   * @return the rows deleted so far
+   */
+  inline uint32_t GetCount() const { return count_; }
+
+  /**
+   * @return DB_SUCCESS, or the error that stopped the delete
+   */
+  inline dberr_t GetStatus() const { return status_; }
+
+private:
+  std::unique_ptr<Operator> child_;
+  TableInfo *table_;
+  std::vector<IndexInfo *> indexes_;
+  Transaction *txn_;
+  MemHeap *heap_;
+  uint32_t count_{0};
+  dberr_t status_{DB_SUCCESS};
+};
+
+/**
+ * Sets columns of the rows of the child to new values, checking the unique and primary key
+ * constraints and keeping the indexes up to date. The first call reads every row of the child,
+ * then updates them all and leaves batch empty.
+ */
+class UpdateOperator : public Operator {
+public:
+  UpdateOperator(std::unique_ptr<Operator> child, TableInfo *table, std::vector<IndexInfo *> indexes,
+                 std::vector<uint32_t> columns, std::vector<Field> values, Transaction *txn, MemHeap *heap)
+      : child_(std::move(child)), table_(table), indexes_(std::move(indexes)), columns_(std::move(columns)),
+        values_(std::move(values)), txn_(txn), heap_(heap) {}
+
+  bool Next(RowBatch *batch) override;
+
+  /**
+   * @return the rows updated so far
+   */
+  inline uint32_t GetCount() const { return count_; }
+
+  /**
+   * @return DB_SUCCESS, or the error that stopped the update
+   */
+  inline dberr_t GetStatus() const { return status_; }
+
+private:
+  dberr_t UpdateRow(const RowId &rid);
+
+  std::unique_ptr<Operator> child_;
+  TableInfo *table_;
+  std::vector<IndexInfo *> indexes_;
+  std::vector<uint32_t> columns_;
+  std::vector<Field> values_;
+  Transaction *txn_;
+  MemHeap *heap_;
+  uint32_t count_{0};
+  dberr_t status_{DB_SUCCESS};
+};
+
+#endif  // MINISQL_OPERATORS_H
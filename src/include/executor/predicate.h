@@ -0,0 +1,95 @@
+#ifndef MINISQL_PREDICATE_H
+#define MINISQL_PREDICATE_H
+
+#include <vector>
+
+#include "executor/filter_kernels.h"
+#include "record/column_comparator.h"
+#include "record/row_view.h"
+#include "record/schema.h"
+extern "C" {
+#include "parser/syntax_tree.h"
+};
+
+class RowBatch;
+
+/**
+ * A where clause compiled against the schema of a table.
+ *
+ * Column names are resolved to their index, literals are converted once to the serialized form
+ * of their column and compared in place with the tuple bytes, operators become an enum. The
+ * program is in postfix order: comparisons push their result, and/or combine the last two.
+ * A condition on a column the table does not have is false for every row.
+ */
+class Predicate {
+public:
+  Predicate(pSyntaxNode root, Schema *schema);
+
+  /**
+   * Whether row satisfies the condition, a comparison with a null value does not
+   */
+  bool Evaluate(const RowView &row) const;
+
+  /**
+   * Evaluate every row of batch, one instruction at a time over all of them. The int and float
+   * columns compared are decoded from the rows into vectors and filtered by the kernels of
+   * filter_kernels.h. Bit i % 64 of word i / 64 of selection is set if row i satisfies the condition
+   */
+  void Evaluate(const RowBatch &batch, std::vector<uint64_t> *selection) const;
+
+private:
+  enum class Op : uint8_t {
+    kCompare,
+    kIsNull,
+    kIsNotNull,
+    kFalse,
+    kAnd,
+    kOr,
+  };
+
+  static constexpr uint32_t NO_VECTOR = UINT32_MAX;
+
+  struct Instruction {
+    Op op_;
+    CompareOp compare_op_{CompareOp::kEqual};
+    uint32_t column_{0};
+    uint32_t literal_{0};  // offset of the serialized literal in literals_
+    TypeId type_{TypeId::kTypeInvalid};  // of the column, picks the ColumnComparator
+    uint32_t vector_{NO_VECTOR};  // the decoded column in vectors_, int and float columns only
+  };
+
+  /* the values of one column over the rows of a batch */
+  struct ColumnVector {
+    uint32_t column_;
+    TypeId type_;
+    bool decoded_{false};
+    std::vector<int32_t> ints_;
+    std::vector<float> floats_;
+    std::vector<uint64_t> not_null_;
+  };
+
+  void Compile(pSyntaxNode root, Schema *schema, uint32_t depth);
+
+  /**
+   * The vector of the column of instruction over batch, decoded by the first instruction on it
+   */
+  const ColumnVector &Decode(const Instruction &instruction, const RowBatch &batch) const;
+
+  /**
+   * Compare column of every row of batch with the literal, in one loop per operator that calls
+   * the kernel of Comparator directly
+   */
+  template<typename Comparator>
+  void CompareBatch(const Instruction &instruction, const RowBatch &batch, uint64_t *selection) const;
+
+  std::vector<Instruction> program_;
+  std::vector<char> literals_;
+  uint32_t max_depth_{0};
+  /* the operands of and/or while a row is evaluated */
+  mutable std::vector<uint8_t> operands_;
+  /* the same for a batch, one selection per level */
+  mutable std::vector<std::vector<uint64_t>> stack_;
+  mutable std::vector<ColumnVector> vectors_;
+};
+
+#endif  // MINISQL_PREDICATE_H
@@ -9,6 +9,7 @@
 #include "page/b_plus_tree_leaf_page.h"
 #include "page/b_plus_tree_page.h"
 #include "transaction/transaction.h"
+#include "common/rwlatch.h"
 #include "index/index_iterator.h"
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
@@ -22,11 +23,27 @@
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Pages pack their keys with prefix compression (see PrefixKeyArray), so how many pairs a page
+ * holds depends on the keys, and a leaf split pushes up the shortest key between the two
+ * leaves rather than the first key of the new one. An internal key is therefore only a lower
+ * bound of its child, it is not updated when the first key of the child is removed.
+ *
+ * Concurrency: lookups, iterators, inserts and removes hold tree_latch_ in read mode and latch
+ * one page at a time on the way down. The leaves are linked B-link style: a leaf split runs
+ * with the tree shared, latching the leaf and then its parent, and anyone who reached the old
+ * leaf moves right along the next page links, bounded by the first key of the next leaf.
+ * An insert whose parent may not have room for the new key, or that goes after the last key of
+ * a leaf with a next leaf (it may belong after a separator the path was read before), and a
+ * remove that underflows give up and rerun with the tree latched exclusively.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using LeafArray = PrefixKeyArray<KeyType, ValueType>;
+  using InternalArray = PrefixKeyArray<KeyType, page_id_t>;
 
 public:
   explicit BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
@@ -35,12 +52,19 @@ public:
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
 
-  // Insert a key-value pair into this B+ tree.
-  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+  inline BufferPoolManager *GetBufferPoolManager() const { return buffer_pool_manager_; }
+
+  // Insert a key-value pair into this B+ tree, unless a key between unique_lower and unique_upper is there.
+  bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr,
+              const KeyType *unique_lower = nullptr, const KeyType *unique_upper = nullptr);
 
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  // Build an empty tree bottom-up from entries sorted by key without duplicates, false if it is not empty
+  // or out of pages.
+  bool BulkLoad(const std::vector<MappingType> &entries, double fill_factor = DEFAULT_INDEX_FILL_FACTOR);
+
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> &result, int& position, page_id_t &leaf_page_id, Transaction *transaction = nullptr);
 
@@ -50,12 +74,39 @@ public:
 
   INDEXITERATOR_TYPE End();
 
+  // iterator over the keys from lower to upper, a null bound leaves that side open
+  INDEXITERATOR_TYPE Scan(const KeyType *lower, bool lower_inclusive, const KeyType *upper, bool upper_inclusive);
+
+  // iterator on the last pair, it moves backward with operator--
+  INDEXITERATOR_TYPE RBegin();
+
+  // iterator on the last pair before upper, or at upper too if inclusive
+  INDEXITERATOR_TYPE RBegin(const KeyType &upper, bool inclusive);
+
+  // the end of a backward iteration, the same as End()
+  INDEXITERATOR_TYPE REnd();
+
+  // iterator starting at position of a leaf found by GetValue
+  INDEXITERATOR_TYPE IteratorAt(page_id_t leaf_page_id, int position);
+
   // expose for test purpose
   /*I don't know why this return type is Page, so I modify it as leaf page*/
   //Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
+  // the caller holds tree_latch_, the leaf is pinned but not latched
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
+  Page *LatchLeafPage(Page *page, const KeyType &key, bool exclusive);
+
+  // the caller holds tree_latch_ exclusive
+  bool HasKeyIn(const KeyType &lower, const KeyType &upper);
+
+  // the caller holds tree_latch_, the leaf holding the last key before key (the last leaf for null) is pinned
+  // and latched in read mode, nullptr if there is no such key
+  Page *FindLeafPageBefore(const KeyType *key);
+
+  Page *MoveRightBefore(Page *page, const KeyType *key);
+
   // used to check whether all pages are unpinned
   bool Check();
 
@@ -74,18 +125,32 @@ public:
   }
 
 private:
-  void StartNewTree(const KeyType &key, const ValueType &value);
+  bool StartNewTree(const KeyType &key, const ValueType &value);
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
+  void RemoveFromLeaf(const KeyType &key, Transaction *transaction = nullptr);
+
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
                         Transaction *transaction = nullptr);
 
   //In Destroy function 
   void DestroyPage(BPlusTreePage *page);
 
-  template<typename N>
-  N *Split(N *node);
+  // split the full leaf, with key & value inserted, nullptr and node untouched if no page is left
+  LeafPage *Split(LeafPage *node, const KeyType &key, const ValueType &value);
+
+  // split the full internal page, with key & new_id inserted after old_id, nullptr as above
+  InternalPage *Split(InternalPage *node, page_id_t old_id, const KeyType &key, page_id_t new_id);
+
+  // allocate every page a split of leaf may take up to the root, false if the pool is out of pages
+  bool ReservePages(LeafPage *leaf);
+
+  // a page of the reserve, or a new one when there is none
+  Page *NewNodePage(page_id_t &page_id);
+
+  // give back the pages of the reserve a split did not take, unpin the ancestors kept by ReservePages
+  void ReleaseReservedPages();
 
   
   template<typename N>
@@ -96,11 +161,26 @@ private:
   bool Coalesce(N **neighbor_node, N **node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent,
                 int index, Transaction *transaction = nullptr);
 
+  // false if the pair does not fit in node, or the new separator in the parent
   template<typename N>
-  void Redistribute(N *neighbor_node, N *node, int index);
+  bool Redistribute(N *neighbor_node, N *node, int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
+  /* The page being filled on one level of a bulk load, pages of a level are filled left to right */
+  struct BulkLoadLevel {
+    std::vector<int> sizes_;  // entries of each page on this level
+    int node_{-1};            // index of the page being filled
+    BPlusTreePage *page_{nullptr};
+    std::vector<page_id_t> pages_{};  // allocated on this level so far
+
+    inline int GetNodeSize() const { return sizes_[node_]; }
+  };
+
+  BPlusTreePage *BulkLoadNewPage(std::vector<BulkLoadLevel> &levels, size_t level, const KeyType &key);
+
+  page_id_t BulkLoadAppend(std::vector<BulkLoadLevel> &levels, size_t level, const KeyType &key, page_id_t child);
+
   void UpdateRootPageId(int insert_record = 0);
 
   /* Debug Routines for FREE!! */
@@ -115,6 +195,13 @@ private:
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  ReaderWriterLatch tree_latch_;
+  // bumped whenever the tree is latched exclusively, iterators find their leaf again after a change
+  uint64_t structure_version_{0};
+  // pages allocated by ReservePages, only used while the tree is latched exclusively
+  std::vector<Page *> reserved_pages_;
+  // the ancestors the split may reach, pinned by ReservePages so the split fetches them from memory
+  std::vector<page_id_t> reserved_path_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_H
@@ -16,7 +16,14 @@ public:
 
   using KeyComparatorName=KeyComparator;
 
-  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager);
+  /**
+   * A non-unique index keeps any number of rows per key, it is built on generic keys only.
+   * The entries hold the columns of entry_schema, the key columns followed by include columns; rows
+   * passed to InsertEntry and RemoveEntry carry all of them, the bounds of a lookup the key columns only.
+   * Without entry_schema the entries hold the key columns.
+   */
+  BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema, BufferPoolManager *buffer_pool_manager,
+                 bool unique = true, IndexSchema *entry_schema = nullptr);
 
   dberr_t InsertEntry(const Row &key, RowId row_id, Transaction *txn) override;
 
@@ -26,13 +33,75 @@ public:
 
   dberr_t Destroy() override;
 
+  std::unique_ptr<IndexCursor> GetBeginCursor() override;
+
+  std::unique_ptr<IndexCursor> GetCursor(page_id_t leaf_page_id, int position) override;
+
+  std::unique_ptr<IndexCursor> Scan(const Row *lower, bool lower_inclusive, const Row *upper,
+                                    bool upper_inclusive) override;
+
+  std::unique_ptr<IndexBuilder> GetBuilder(double fill_factor) override;
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
   INDEXITERATOR_TYPE GetEndIterator();
 
+  INDEXITERATOR_TYPE GetRBeginIterator();
+
 protected:
+  /**
+   * Key of the tree entry of row_id, false if the key is not indexed
+   */
+  bool MakeEntryKey(const Row &key, RowId row_id, KeyType &index_key) const;
+
+  /**
+   * Key of a range bound, false if no key compares with it
+   */
+  bool MakeBoundKey(const Row &key, bool lower, bool inclusive, KeyType &index_key) const;
+
+  /**
+   * Whether the entries of one key differ in more than the key, which then is a prefix of theirs
+   */
+  inline bool HasKeyPrefix() const { return !unique_ || entry_schema_ != key_schema_; }
+
+  class Cursor : public IndexCursor {
+  public:
+    Cursor(INDEXITERATOR_TYPE iterator, IndexSchema *entry_schema)
+        : iterator_(iterator), entry_schema_(entry_schema) {}
+
+    bool IsEnd() const override { return iterator_.IsEnd(); }
+
+    RowId GetRowId() override { return (*iterator_).second; }
+
+    void GetEntry(Row &entry) override;
+
+    void Next() override { ++iterator_; }
+
+  private:
+    INDEXITERATOR_TYPE iterator_;
+    IndexSchema *entry_schema_;
+  };
+
+  class Builder : public IndexBuilder {
+  public:
+    Builder(BPlusTreeIndex *index, double fill_factor) : index_(index), fill_factor_(fill_factor) {}
+
+    void Add(const Row &key, RowId row_id) override;
+
+    dberr_t Finish(Transaction *txn) override;
+
+  private:
+    BPlusTreeIndex *index_;
+    double fill_factor_;
+    std::vector<MappingType> entries_;
+  };
+
+  // the row id is part of the key of a non-unique index
+  bool unique_;
+  // key columns and include columns, the same as key_schema_ without include columns
+  IndexSchema *entry_schema_;
   // comparator for key
   KeyComparator comparator_;
   // container
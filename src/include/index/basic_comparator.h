@@ -1,9 +1,16 @@
 #ifndef MINISQL_BASIC_COMPARATOR_H
 #define MINISQL_BASIC_COMPARATOR_H
 
+class Schema;
+
 template<typename T>
 class BasicComparator {
 public:
+  BasicComparator() = default;
+
+  // built like GenericComparator by indexes, the key schema is not needed
+  explicit BasicComparator(Schema *) {}
+
   inline int operator()(const T &l, const T &r) const {
     if (l < r) {
       return -1;
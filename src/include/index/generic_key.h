@@ -3,6 +3,7 @@
 
 #include <cstring>
 
+#include "index/key_codec.h"
 #include "record/row.h"
 #include "record/field.h"
 
@@ -10,18 +11,45 @@ template<size_t KeySize>
 class GenericKey {
 public:
   inline void SerializeFromKey(const Row &key, Schema *schema) {
-    // initialize to 0
-    uint32_t size = key.GetSerializedSize(schema);
-    ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= KeySize, "Index key size exceed max key size.");
+    // initialize to 0, the padding takes part in comparisons
     memset(data, 0, KeySize);
-    key.SerializeTo(data, schema);
+    uint32_t size = KeyCodec::Encode(key, schema, data, KeySize);
+    ASSERT(size != 0, "Index key size exceed max key size.");
+  }
+
+  /**
+   * key of a non-unique index, the encoded key followed by row_id
+   */
+  inline void SerializeFromKey(const Row &key, RowId row_id, Schema *schema) {
+    memset(data, 0, KeySize);
+    uint32_t size = 0;
+    if (KeySize > KeyCodec::ROW_ID_SIZE) {
+      size = KeyCodec::Encode(key, schema, data, KeySize - KeyCodec::ROW_ID_SIZE);
+    }
+    ASSERT(size != 0, "Index key size exceed max key size.");
+    KeyCodec::EncodeRowId(row_id, data + size);
+  }
+
+  /**
+   * bound of the entries of key, the bytes after the key are all 0x00 for the low bound and all 0xFF
+   * for the high one. Whatever row id or include columns follow key in an entry, it lies between them.
+   */
+  inline void SerializeBoundFromKey(const Row &key, Schema *schema, bool low) {
+    memset(data, low ? 0 : 0xFF, KeySize);
+    uint32_t size = KeyCodec::Encode(key, schema, data, KeySize);
+    ASSERT(size != 0, "Index key size exceed max key size.");
+  }
+
+  /**
+   * the first key with a first column that is not null
+   */
+  inline void SetMinNotNull() {
+    memset(data, 0, KeySize);
+    KeyCodec::EncodeMinNotNull(data);
   }
 
   inline void DeserializeToKey(Row &key, Schema *schema) const {
-    uint32_t ofs = key.DeserializeFrom(const_cast<char *>(data), schema);
-    ASSERT(ofs <= KeySize, "Index key size exceed max key size.");
-    return;
+    KeyCodec::Decode(data, schema, key);
   }
 
   // compare
@@ -54,24 +82,9 @@ class GenericComparator {
 public:
   inline int operator()(const GenericKey<KeySize> &lhs,
                         const GenericKey<KeySize> &rhs) const {
-    int column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    lhs.DeserializeToKey(lhs_key, key_schema_);
-    rhs.DeserializeToKey(rhs_key, key_schema_);
-
-    for (int i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue)
-        return -1;
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue)
-        return 1;
-    }
-    // equals
-    return 0;
+    /*keys are stored in the memcmp-comparable encoding of KeyCodec*/
+    int result = memcmp(lhs.data, rhs.data, KeySize);
+    return (result > 0) - (result < 0);
   }
 
   GenericComparator(const GenericComparator &other) {
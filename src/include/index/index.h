@@ -7,6 +7,41 @@
 #include "record/row.h"
 #include "transaction/transaction.h"
 
+/**
+ * Iterator over the entries of an index, it hides the key type of the tree behind it
+ */
+class IndexCursor {
+public:
+  virtual ~IndexCursor() {}
+
+  virtual bool IsEnd() const = 0;
+
+  virtual RowId GetRowId() = 0;
+
+  /**
+   * Decode the columns the entry holds into entry: the key columns, then the include columns
+   */
+  virtual void GetEntry(Row &entry) = 0;
+
+  virtual void Next() = 0;
+};
+
+/**
+ * Collects the entries of a new index and builds it in one go
+ */
+class IndexBuilder {
+public:
+  virtual ~IndexBuilder() {}
+
+  virtual void Add(const Row &key, RowId row_id) = 0;
+
+  /**
+   * Build the index from the entries added, the index has to be empty.
+   * Of entries with the same key only the first one added is kept.
+   */
+  virtual dberr_t Finish(Transaction *txn) = 0;
+};
+
 class Index {
 public:
   explicit Index(index_id_t index_id, IndexSchema *key_schema)
@@ -23,6 +58,28 @@ public:
 
   virtual dberr_t Destroy() = 0;
 
+  /**
+   * Cursor on the first entry of the index
+   */
+  virtual std::unique_ptr<IndexCursor> GetBeginCursor() = 0;
+
+  /**
+   * Cursor on the entry found by ScanKey, at position in leaf page leaf_page_id
+   */
+  virtual std::unique_ptr<IndexCursor> GetCursor(page_id_t leaf_page_id, int position) = 0;
+
+  /**
+   * Cursor on the entries with keys from lower to upper, a null bound leaves that side open.
+   * No comparison holds for null, an open lower bound starts after the keys with a null first column.
+   */
+  virtual std::unique_ptr<IndexCursor> Scan(const Row *lower, bool lower_inclusive, const Row *upper,
+                                            bool upper_inclusive) = 0;
+
+  /**
+   * Builder filling this index bottom-up, pages are filled to fill_factor of their size
+   */
+  virtual std::unique_ptr<IndexBuilder> GetBuilder(double fill_factor) = 0;
+
 protected:
   index_id_t index_id_;
   IndexSchema *key_schema_;
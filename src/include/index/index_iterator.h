@@ -5,35 +5,86 @@
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
 public:
   // you may define your own constructor based on your member variables
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
-  explicit IndexIterator(LeafPage *target_leaf, int index, BufferPoolManager *buffer_pool_manager);
+  using Tree = BPlusTree<KeyType, ValueType, KeyComparator>;
+
+  /**
+   * Both constructors expect the caller to hold the latch of tree in read mode, the leaf page must
+   * be pinned by the caller for the first one and is fetched by the second one.
+   * The end iterator is built from a null page.
+   */
+  explicit IndexIterator(Page *page, int index, BufferPoolManager *buffer_pool_manager, Tree *tree = nullptr);
 
-  explicit IndexIterator(page_id_t leaf_page_id, int position, BufferPoolManager *buffer_pool_manager);
+  explicit IndexIterator(page_id_t leaf_page_id, int position, BufferPoolManager *buffer_pool_manager,
+                         Tree *tree = nullptr);
+
+  IndexIterator(const IndexIterator &other);
 
   ~IndexIterator();
 
-  /** Return the key/value pair this iterator is currently pointing at. */
+  IndexIterator &operator=(const IndexIterator &other);
+
+  /** Return whether the iterator is past the last key/value pair. */
+  inline bool IsEnd() const { return page_ == nullptr; }
+
+  /**
+   * Return the key/value pair this iterator is currently pointing at.
+   * It is a copy taken under the leaf latch, so writers may change the leaf meanwhile.
+   */
   const MappingType &operator*();
 
-  /** Move to the next key/value pair.*/
+  /** Move to the next key/value pair, the end iterator stays where it is.*/
   IndexIterator &operator++();
 
+  /**
+   * Move to the previous key/value pair, the iterator becomes the end iterator before the first one.
+   * Only iterators of a tree move backward, the end iterator stays where it is.
+   */
+  IndexIterator &operator--();
+
   /** Return whether two iterators are equal */
   bool operator==(const IndexIterator &itr) const;
 
   /** Return whether two iterators are not equal. */
   bool operator!=(const IndexIterator &itr) const;
 
+  /** End the iteration after the last key before upper, or at upper too if inclusive. */
+  void SetUpperBound(const KeyType &upper, bool inclusive);
+
 private:
+  /**
+   * Copy the pair at index_, moving on to the next leaves while index_ is past the end of one.
+   * With after_item the position is found again as the first key greater than item_, the
+   * entries of the leaf may have moved since the last step.
+   */
+  void Load(bool after_item);
+
+  /** Become the end iterator if item_ is past the upper bound. */
+  void CheckUpperBound();
+
+  /** Unpin the page and become the end iterator. */
+  void Finish();
+
+  inline LeafPage *Leaf() const { return reinterpret_cast<LeafPage *>(page_->GetData()); }
+
   // add your own private member variables here
-  LeafPage* target_leaf_;
+  Page *page_;//the pinned leaf, latched and unlatched through the page itself
   int index_;
   BufferPoolManager *buffer_pool_manager_;//for unpin the page and fetch page 
+  Tree *tree_;//its latch is taken in read mode while moving, no merge can run meanwhile
+  uint64_t structure_version_;//version of the tree when item_ was loaded
+  MappingType item_;
+  bool bounded_;//whether upper_ ends the iteration
+  bool upper_inclusive_;
+  KeyType upper_;
 };
 
 
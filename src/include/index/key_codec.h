@@ -0,0 +1,84 @@
+#ifndef MINISQL_KEY_CODEC_H
+#define MINISQL_KEY_CODEC_H
+
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Order-preserving binary encoding of index keys, so that two keys compare with memcmp.
+ *
+ * Each key column starts with a null byte (0x00 null, 0x01 not null, nulls sort first),
+ * a null column has nothing after it. Otherwise the value follows:
+ *  int:   4 bytes big-endian with the sign bit flipped
+ *  float: 4 bytes big-endian, sign bit flipped for positive values and all bits
+ *         flipped for negative ones
+ *  char:  the characters with every 0x00 escaped as 0x00 0xFF, terminated by 0x00 0x00
+ *
+ * No encoded column is a prefix of another, so whatever follows a key (the next column,
+ * or the zero padding up to the key size) never affects the order.
+ *
+ * A non-unique index appends the row id to the key: page id then slot, 4 bytes big-endian
+ * each. The entries of one key then sort by row id.
+ *
+ * Include columns of an index are encoded after the key columns the same way. They only
+ * order the entries of one key, like the row id does.
+ */
+class KeyCodec {
+public:
+  /**
+   * Encode key into buf
+   *
+   * @return bytes written, 0 if the key does not fit in size bytes
+   */
+  static uint32_t Encode(const Row &key, Schema *key_schema, char *buf, uint32_t size);
+
+  /**
+   * Decode an encoded key back into the fields of key
+   */
+  static void Decode(const char *buf, Schema *key_schema, Row &key);
+
+  /**
+   * Length of the encoding of a key of key_schema at the beginning of buf, whatever follows it
+   */
+  static uint32_t GetEncodedSize(const char *buf, Schema *key_schema);
+
+  /**
+   * Longest encoding of a key of this schema, chars are assumed to hold no 0x00 byte
+   */
+  static uint32_t GetMaxEncodedSize(const Schema *key_schema);
+
+  /**
+   * Write row_id at buf, right after an encoded key
+   */
+  static inline void EncodeRowId(RowId row_id, char *buf) {
+    WriteBigEndian(buf, static_cast<uint32_t>(row_id.GetPageId()));
+    WriteBigEndian(buf + sizeof(uint32_t), row_id.GetSlotNum());
+  }
+
+  static constexpr uint32_t ROW_ID_SIZE = 2 * sizeof(uint32_t);
+
+  /**
+   * Write the smallest encoding of a key whose first column is not null, the rest of buf is zero
+   */
+  static inline void EncodeMinNotNull(char *buf) { buf[0] = NOT_NULL; }
+
+private:
+  static constexpr uint32_t SIGN_BIT = 0x80000000;
+  static constexpr char NOT_NULL = 0x01;
+  static constexpr char CHAR_ESCAPE = static_cast<char>(0xFF);
+
+  static inline void WriteBigEndian(char *buf, uint32_t value) {
+    buf[0] = static_cast<char>(value >> 24);
+    buf[1] = static_cast<char>(value >> 16);
+    buf[2] = static_cast<char>(value >> 8);
+    buf[3] = static_cast<char>(value);
+  }
+
+  static inline uint32_t ReadBigEndian(const char *buf) {
+    auto bytes = reinterpret_cast<const unsigned char *>(buf);
+    return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+           (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+  }
+};
+
+#endif  // MINISQL_KEY_CODEC_H
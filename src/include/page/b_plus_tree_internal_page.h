@@ -3,10 +3,14 @@
 
 #include <queue>
 #include "page/b_plus_tree_page.h"
+#include "page/prefix_key_array.h"
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
 #define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)) - 1)
+/* the most pairs a page holds, with keys that are all prefix */
+#define INTERNAL_PAGE_SIZE                                                                   \
+  ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE - PrefixKeyArray<KeyType, ValueType>::HEADER_SIZE) / \
+   PrefixKeyArray<KeyType, ValueType>::MIN_ENTRY_SIZE)
 //#define INTERNAL_PAGE_SIZE 3
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
@@ -16,9 +20,12 @@
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
+ * A key only separates its child from the one before, it need not be a key of the
+ * tree: a leaf split pushes up the shortest key between the two leaves.
+ *
+ * Internal page format (keys are stored in increasing order, packed by PrefixKeyArray):
  *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ * | HEADER | PREFIX | SLOTS | free space | KEY SUFFIX + PAGE_ID ... |
  *  --------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
@@ -29,7 +36,8 @@ public:
 
   KeyType KeyAt(int index) const;
 
-  void SetKeyAt(int index, const KeyType &key);
+  // false if the key does not fit, the page is left as it was
+  bool SetKeyAt(int index, const KeyType &key);
 
   //here I add a new function SetValueAt(int index, const ValueType& value);
   void SetValueAt(int index, const ValueType &value);
@@ -41,10 +49,28 @@ public:
 
   ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
 
+  // index of the child holding the last key before key, 0 if no key of this page is before it
+  int LookupBefore(const KeyType &key, const KeyComparator &comparator) const;
+
+  // whether key fits in the page, both by size and by bytes
+  bool HasRoomFor(const KeyType &key) const;
+
+  // whether any key fits in the page, even one that leaves the others without a prefix
+  bool HasRoomForAnyKey() const;
+
+  // whether the page is under its min size and less than a third full
+  bool IsUnderflow() const;
+
+  // whether the pairs of this page and of the next one fit in one page
+  bool CanMergeWith(const BPlusTreeInternalPage *next) const;
+
   void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
 
   int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
 
+  // append a pair, the page must have room for it
+  void Append(const KeyType &key, const ValueType &value);
+
   void Remove(int index);
 
   ValueType RemoveAndReturnOnlyChild();
@@ -52,8 +78,12 @@ public:
   // Split and Merge utility methods
   void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
 
-  /*buffer_pool_manager here is to change those child's parent_id*/
-  void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
+  /*
+   * insert new_key & new_value after old_value in the page that has no room for them, then move the pairs after
+   * the split point to recipient. buffer_pool_manager here is to change those child's parent_id
+   */
+  void MoveHalfTo(BPlusTreeInternalPage *recipient, const ValueType &old_value, const KeyType &new_key,
+                  const ValueType &new_value, BufferPoolManager *buffer_pool_manager);
   //void MoveHalfTo(BPlusTreeInternalPage *recipient);
 
   void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
@@ -63,13 +93,13 @@ public:
                          BufferPoolManager *buffer_pool_manager);
 
 private:
-  void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
+  void CopyNFrom(const MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
 
   void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
 
   void CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
 
-  MappingType array_[0];
+  PrefixKeyArray<KeyType, ValueType> array_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_INTERNAL_PAGE_H
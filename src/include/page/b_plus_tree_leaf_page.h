@@ -8,12 +8,12 @@
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
 
- * Leaf page format (keys are stored in order):
+ * Leaf page format (keys are stored in order, packed by PrefixKeyArray):
  *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ * | HEADER | PREFIX | SLOTS | free space | KEY SUFFIX + RID ... |
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 24 bytes in total):
+ *  Header format (size in byte, 28 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | CurrentSize (4) | MaxSize (4) | ParentPageId (4) |
  *  ---------------------------------------------------------------------
@@ -25,10 +25,14 @@
 #include <vector>
 
 #include "page/b_plus_tree_page.h"
+#include "page/prefix_key_array.h"
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE (((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType)) - 1)
+/* the most pairs a page holds, with keys that are all prefix */
+#define LEAF_PAGE_SIZE                                                                   \
+  ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - PrefixKeyArray<KeyType, ValueType>::HEADER_SIZE) / \
+   PrefixKeyArray<KeyType, ValueType>::MIN_ENTRY_SIZE)
 //#define LEAF_PAGE_SIZE 3
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -47,9 +51,18 @@ public:
 
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
 
-  const MappingType &GetItem(int index);
+  MappingType GetItem(int index) const;
 
-  // insert and delete methods
+  // whether key fits in the page, both by size and by bytes
+  bool HasRoomFor(const KeyType &key) const;
+
+  // whether the page is under its min size and less than a third full
+  bool IsUnderflow() const;
+
+  // whether the pairs of this page and of the next one fit in one page
+  bool CanMergeWith(const BPlusTreeLeafPage *next) const;
+
+  // insert and delete methods, the page must have room for key
   int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
 
 
@@ -59,7 +72,9 @@ public:
   int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
 
   // Split and Merge utility methods
-  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  // insert key & value in the page that has no room for it, then move the pairs after the split point to recipient
+  void MoveHalfTo(BPlusTreeLeafPage *recipient, const KeyType &key, const ValueType &value,
+                  const KeyComparator &comparator);
 
   void MoveAllTo(BPlusTreeLeafPage *recipient);
 
@@ -67,15 +82,16 @@ public:
 
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
-private:
-  void CopyNFrom(MappingType *items, int size);
+  // append size sorted items, used by bulk loading
+  void CopyNFrom(const MappingType *items, int size);
 
+private:
   void CopyLastFrom(const MappingType &item);
 
   void CopyFirstFrom(const MappingType &item);
 
   page_id_t next_page_id_;
-  MappingType array_[0];
+  PrefixKeyArray<KeyType, ValueType> array_;
 };
 
 #endif  // MINISQL_B_PLUS_TREE_LEAF_PAGE_H
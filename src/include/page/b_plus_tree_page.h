@@ -73,4 +73,45 @@ private:
   [[maybe_unused]] page_id_t page_id_;
 };
 
+/**
+ * Branchless binary search over the sorted keys of a page.
+ *
+ * Instead of narrowing [left, right) with an unpredictable if/else, the window
+ * start moves by half of the window or not at all, which compiles to a
+ * conditional move. Every search does the same ceil(log2(size)) comparisons,
+ * so the loop has no data-dependent branch to mispredict.
+ *
+ * compare(i) is < 0, 0 or > 0 if key i of the page is before, equal to or after
+ * the key searched for.
+ * @return index of the first key that is >= key (KeyLowerBound) or > key
+ * (KeyUpperBound), size if there is none
+ */
+template<typename Compare>
+inline int KeyLowerBound(int size, const Compare &compare) {
+  if (size == 0) {
+    return 0;
+  }
+  int base = 0;
+  while (size > 1) {
+    int half = size / 2;
+    base = (compare(base + half) < 0) ? base + half : base;
+    size -= half;
+  }
+  return base + (compare(base) < 0);
+}
+
+template<typename Compare>
+inline int KeyUpperBound(int size, const Compare &compare) {
+  if (size == 0) {
+    return 0;
+  }
+  int base = 0;
+  while (size > 1) {
+    int half = size / 2;
+    base = (compare(base + half) <= 0) ? base + half : base;
+    size -= half;
+  }
+  return base + (compare(base) <= 0);
+}
+
 #endif  // MINISQL_B_PLUS_TREE_PAGE_H
@@ -0,0 +1,470 @@
+#ifndef MINISQL_PREFIX_KEY_ARRAY_H
+#define MINISQL_PREFIX_KEY_ARRAY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+template<size_t KeySize>
+class GenericKey;
+
+/**
+ * Whether the keys of a type are ordered like their bytes compared with memcmp. Only those
+ * share a prefix on a page and get separators shorter than a key.
+ */
+template<typename KeyType>
+struct KeyTraits {
+  static constexpr bool kBytewise = false;
+};
+
+template<size_t KeySize>
+struct KeyTraits<GenericKey<KeySize>> {
+  static constexpr bool kBytewise = true;
+};
+
+/**
+ * The sorted key/value pairs of a B+ tree page, packed with prefix compression.
+ *
+ * The bytes all keys of the page start with are stored once. An entry keeps the rest of its
+ * key without the zero bytes it ends with, keys are rebuilt by zero filling, so neither the
+ * prefix nor the padding of a key takes room in its entry. Keys that are not ordered by their
+ * bytes are stored whole, apart from the trailing zeros.
+ *
+ * Format (size in byte), from the start of the array to the end of the page:
+ *  -------------------------------------------------------------------------------------
+ * | HEADER (8) | PREFIX | SLOT(0) (2) | ... | SLOT(n-1) (2) | free space | ENTRIES ... |
+ *  -------------------------------------------------------------------------------------
+ * Slots are in key order and hold the offset of their entry, entries grow down from the end:
+ *  ------------------------------------------
+ * | SuffixSize (1) | SUFFIX | VALUE |
+ *  ------------------------------------------
+ * A removed entry leaves a hole that is reclaimed by packing the array again once the free
+ * space between slots and entries runs out. The number of pairs is kept by the page.
+ */
+template<typename KeyType, typename ValueType>
+class PrefixKeyArray {
+public:
+  using Item = std::pair<KeyType, ValueType>;
+
+  static constexpr int HEADER_SIZE = 8;
+  static constexpr int KEY_SIZE = sizeof(KeyType);
+  static constexpr int VALUE_SIZE = sizeof(ValueType);
+  /* an entry and its slot, with the shortest and with the longest suffix */
+  static constexpr int MIN_ENTRY_SIZE = sizeof(uint16_t) + 1 + VALUE_SIZE;
+  static constexpr int MAX_ENTRY_SIZE = MIN_ENTRY_SIZE + KEY_SIZE;
+
+  static_assert(KEY_SIZE <= UINT8_MAX, "The suffix size of an entry takes one byte.");
+
+  /**
+   * A key prepared to be compared with the entries of one array
+   */
+  struct Probe {
+    const KeyType *key_;
+    int prefix_result_;  // key against the prefix
+    int rest_size_;      // bytes of the key after the prefix, trailing zeros left out
+  };
+
+  /**
+   * Empty the array, it takes capacity bytes up to the end of its page, the header included
+   */
+  inline void Init(int capacity) {
+    static_assert(sizeof(PrefixKeyArray) == HEADER_SIZE, "The header is the only member.");
+    capacity_ = capacity;
+    prefix_size_ = 0;
+    heap_begin_ = capacity;
+    garbage_ = 0;
+  }
+
+  inline KeyType KeyAt(int index) const {
+    KeyType key;
+    char *bytes = reinterpret_cast<char *>(&key);
+    const char *entry = Entry(index);
+    int suffix_size = static_cast<uint8_t>(entry[0]);
+    memcpy(bytes, Prefix(), prefix_size_);
+    memcpy(bytes + prefix_size_, entry + 1, suffix_size);
+    memset(bytes + prefix_size_ + suffix_size, 0, KEY_SIZE - prefix_size_ - suffix_size);
+    return key;
+  }
+
+  inline ValueType ValueAt(int index) const {
+    ValueType value;
+    const char *entry = Entry(index);
+    memcpy(&value, entry + 1 + static_cast<uint8_t>(entry[0]), VALUE_SIZE);
+    return value;
+  }
+
+  inline void SetValueAt(int index, const ValueType &value) {
+    char *entry = Entry(index);
+    memcpy(entry + 1 + static_cast<uint8_t>(entry[0]), &value, VALUE_SIZE);
+  }
+
+  inline Item ItemAt(int index) const { return Item(KeyAt(index), ValueAt(index)); }
+
+  /**
+   * The pairs of an array of size pairs
+   */
+  std::vector<Item> Items(int size) const {
+    std::vector<Item> items;
+    items.reserve(size + 1);
+    for (int i = 0; i < size; i++) {
+      items.push_back(ItemAt(i));
+    }
+    return items;
+  }
+
+  inline Probe MakeProbe(const KeyType &key) const {
+    if (!KeyTraits<KeyType>::kBytewise) {
+      return Probe{&key, 0, 0};
+    }
+    int result = memcmp(Bytes(key), Prefix(), prefix_size_);
+    return Probe{&key, (result > 0) - (result < 0), std::max(0, TrimmedSize(key) - prefix_size_)};
+  }
+
+  /**
+   * Compare the key at index with the key of probe: the prefix is compared once for the probe,
+   * then only the suffix, which is zero filled like the rest of the key
+   * @return: < 0, 0 or > 0 if the key at index is before, equal to or after the probe
+   */
+  template<typename KeyComparator>
+  inline int Compare(int index, const Probe &probe, const KeyComparator &comparator) const {
+    if (!KeyTraits<KeyType>::kBytewise) {
+      return comparator(KeyAt(index), *probe.key_);
+    }
+    if (probe.prefix_result_ != 0) {
+      return -probe.prefix_result_;
+    }
+    const char *entry = Entry(index);
+    int suffix_size = static_cast<uint8_t>(entry[0]);
+    int result = memcmp(entry + 1, Bytes(*probe.key_) + prefix_size_, std::min(suffix_size, probe.rest_size_));
+    /*both end with a byte that is not zero, on equal bytes the longer one is after*/
+    return result != 0 ? result : suffix_size - probe.rest_size_;
+  }
+
+  /**
+   * Bytes taken by an array of size pairs, holes left by removed entries are not counted
+   */
+  inline int UsedBytes(int size) const { return SlotsEnd(size) + capacity_ - heap_begin_ - garbage_; }
+
+  inline int GetCapacity() const { return capacity_; }
+
+  /**
+   * Whether key fits in an array of size pairs, also if it shortens the prefix of the others
+   */
+  bool HasRoom(int size, const KeyType &key) const {
+    int trimmed_size = TrimmedSize(key);
+    if (size == 0) {
+      return HEADER_SIZE + MIN_ENTRY_SIZE + trimmed_size <= capacity_;
+    }
+    int prefix_size = SharedPrefixSize(key);
+    /*every entry grows by the bytes the prefix loses at most*/
+    int shrink = prefix_size_ - prefix_size;
+    return UsedBytes(size) + shrink * (size - 1) + sizeof(uint16_t) + EntrySize(trimmed_size, prefix_size) <=
+           capacity_;
+  }
+
+  /**
+   * Whether any key fits in an array of size pairs, even one that leaves them without a prefix
+   */
+  inline bool HasRoomForAny(int size) const {
+    return UsedBytes(size) + prefix_size_ * std::max(0, size - 1) + MAX_ENTRY_SIZE <= capacity_;
+  }
+
+  /**
+   * Insert key & value at index of an array of size pairs, HasRoom must be true for key
+   */
+  void Insert(int size, int index, const KeyType &key, const ValueType &value) {
+    int trimmed_size = TrimmedSize(key);
+    if (size == 0) {
+      /*a key alone is all prefix*/
+      Init(capacity_);
+      if (KeyTraits<KeyType>::kBytewise) {
+        prefix_size_ = trimmed_size;
+        memcpy(Prefix(), Bytes(key), prefix_size_);
+      }
+    } else if (SharedPrefixSize(key) < prefix_size_) {
+      InsertAndPack(size, index, key, value);
+      return;
+    }
+    int entry_size = EntrySize(trimmed_size, prefix_size_);
+    if (heap_begin_ - SlotsEnd(size) < static_cast<int>(sizeof(uint16_t)) + entry_size) {
+      InsertAndPack(size, index, key, value);
+      return;
+    }
+    heap_begin_ -= entry_size;
+    WriteEntry(heap_begin_, key, trimmed_size, value);
+    char *slots = Slots();
+    memmove(slots + (index + 1) * sizeof(uint16_t), slots + index * sizeof(uint16_t),
+            (size - index) * sizeof(uint16_t));
+    SetSlot(index, heap_begin_);
+  }
+
+  /**
+   * Remove the pair at index of an array of size pairs
+   */
+  void Remove(int size, int index) {
+    if (size == 1) {
+      Init(capacity_);
+      return;
+    }
+    const char *entry = Entry(index);
+    garbage_ += 1 + static_cast<uint8_t>(entry[0]) + VALUE_SIZE;
+    char *slots = Slots();
+    memmove(slots + index * sizeof(uint16_t), slots + (index + 1) * sizeof(uint16_t),
+            (size - index - 1) * sizeof(uint16_t));
+  }
+
+  /**
+   * Replace the key at index of an array of size pairs, the order of the keys must not change
+   * @return: false if the new key does not fit, the array is left as it was
+   */
+  bool SetKeyAt(int size, int index, const KeyType &key) {
+    std::vector<Item> items = Items(size);
+    items[index].first = key;
+    if (PackedSize(items.data(), size) > capacity_) {
+      return false;
+    }
+    Assign(items.data(), size);
+    return true;
+  }
+
+  /**
+   * Replace the pairs of the array with size sorted items, which must fit
+   */
+  void Assign(const Item *items, int size) {
+    Init(capacity_);
+    if (size == 0) {
+      return;
+    }
+    prefix_size_ = PrefixSize(items, size);
+    memcpy(Prefix(), Bytes(items[0].first), prefix_size_);
+    for (int i = 0; i < size; i++) {
+      int trimmed_size = TrimmedSize(items[i].first);
+      heap_begin_ -= EntrySize(trimmed_size, prefix_size_);
+      WriteEntry(heap_begin_, items[i].first, trimmed_size, items[i].second);
+      SetSlot(i, heap_begin_);
+    }
+    ASSERT(heap_begin_ >= SlotsEnd(size), "Items overflow the page.");
+  }
+
+  /**
+   * Bytes an array of size sorted items takes once packed
+   */
+  static int PackedSize(const Item *items, int size) {
+    int prefix_size = PrefixSize(items, size);
+    int bytes = HEADER_SIZE + prefix_size;
+    for (int i = 0; i < size; i++) {
+      bytes += sizeof(uint16_t) + EntrySize(TrimmedSize(items[i].first), prefix_size);
+    }
+    return bytes;
+  }
+
+  /**
+   * Where to split sorted items, too many for one page, among two pages: the number of items
+   * of the first one. If index, the item that overflowed the page, is at an end and shortens the
+   * prefix of the others, it goes alone, so the page it came to stays as full as it was.
+   * Otherwise the bytes are split in half, or the items after min_size if max_size is the limit.
+   * An index < 0 never goes alone.
+   */
+  static int SplitPoint(const std::vector<Item> &items, int index, int capacity, int max_size, int min_size) {
+    int size = items.size();
+    auto fits = [&](int split) {
+      return split > 0 && split < size && split <= max_size && size - split <= max_size &&
+             PackedSize(items.data(), split) <= capacity &&
+             PackedSize(items.data() + split, size - split) <= capacity;
+    };
+    if (size > max_size && fits(min_size)) {
+      return min_size;
+    }
+    if (KeyTraits<KeyType>::kBytewise && size > 2 && (index == 0 || index == size - 1)) {
+      int others = index == 0 ? 1 : 0;
+      if (PrefixSize(items.data(), size) < PrefixSize(items.data() + others, size - 1)) {
+        int split = index == 0 ? 1 : size - 1;
+        if (fits(split)) {
+          return split;
+        }
+      }
+    }
+    int prefix_size = PrefixSize(items.data(), size);
+    std::vector<int> bytes(size + 1, 0);
+    for (int i = 0; i < size; i++) {
+      bytes[i + 1] = bytes[i] + sizeof(uint16_t) + EntrySize(TrimmedSize(items[i].first), prefix_size);
+    }
+    int split = std::lower_bound(bytes.begin(), bytes.end(), bytes[size] / 2) - bytes.begin();
+    split = std::min(std::max(split, 1), size - 1);
+    ASSERT(fits(split), "Split halves overflow the page.");
+    return split;
+  }
+
+  /**
+   * Split sorted keys into runs that fill pages to capacity bytes and max_size keys at most,
+   * key(i) returns key i. The last two runs are balanced, so that the last page is not short.
+   * @return: the number of keys of each run
+   */
+  template<typename GetKey>
+  static std::vector<int> PlanRuns(int count, const GetKey &key, int capacity, int max_size) {
+    std::vector<int> runs;
+    std::vector<int> trimmed;
+    int begin = 0;
+    while (begin < count) {
+      KeyType first = key(begin);
+      int prefix_size = KeyTraits<KeyType>::kBytewise ? TrimmedSize(first) : 0;
+      int bytes = HEADER_SIZE + prefix_size;
+      trimmed.clear();
+      int end = begin;
+      while (end < count && end - begin < max_size) {
+        KeyType next = key(end);
+        int trimmed_size = TrimmedSize(next);
+        int next_prefix_size = std::min(prefix_size, CommonPrefixSize(Bytes(first), Bytes(next), prefix_size));
+        int next_bytes = bytes;
+        if (next_prefix_size < prefix_size) {
+          next_bytes = HEADER_SIZE + next_prefix_size;
+          for (int size : trimmed) {
+            next_bytes += sizeof(uint16_t) + EntrySize(size, next_prefix_size);
+          }
+        }
+        next_bytes += sizeof(uint16_t) + EntrySize(trimmed_size, next_prefix_size);
+        if (next_bytes > capacity && end > begin) {
+          break;
+        }
+        trimmed.push_back(trimmed_size);
+        prefix_size = next_prefix_size;
+        bytes = next_bytes;
+        end++;
+      }
+      runs.push_back(end - begin);
+      begin = end;
+    }
+    if (runs.size() > 1) {
+      /*halve the last two runs if the halves fit*/
+      int last = runs.back();
+      int total = runs[runs.size() - 2] + last;
+      int first_half = (total + 1) / 2;
+      std::vector<Item> items;
+      for (int i = count - total; i < count; i++) {
+        items.emplace_back(key(i), ValueType());
+      }
+      if (first_half <= max_size && PackedSize(items.data(), first_half) <= capacity &&
+          PackedSize(items.data() + first_half, total - first_half) <= capacity) {
+        runs[runs.size() - 2] = first_half;
+        runs.back() = total - first_half;
+      }
+    }
+    return runs;
+  }
+
+  /**
+   * The shortest key after left and not after right, it separates two pages of keys. Keys that
+   * are not ordered by their bytes are not shortened.
+   */
+  static KeyType Separator(const KeyType &left, const KeyType &right) {
+    if (!KeyTraits<KeyType>::kBytewise) {
+      return right;
+    }
+    /*right up to the first byte that differs from left, zero filled*/
+    KeyType separator;
+    int size = CommonPrefixSize(Bytes(left), Bytes(right), KEY_SIZE) + 1;
+    memset(reinterpret_cast<char *>(&separator), 0, KEY_SIZE);
+    memcpy(reinterpret_cast<char *>(&separator), Bytes(right), std::min(size, KEY_SIZE));
+    return separator;
+  }
+
+private:
+  static inline const char *Bytes(const KeyType &key) { return reinterpret_cast<const char *>(&key); }
+
+  /* the size of key without the zero bytes it ends with */
+  static inline int TrimmedSize(const KeyType &key) {
+    const char *bytes = Bytes(key);
+    int size = KEY_SIZE;
+    while (size > 0 && bytes[size - 1] == 0) {
+      size--;
+    }
+    return size;
+  }
+
+  static inline int CommonPrefixSize(const char *lhs, const char *rhs, int size) {
+    int common = 0;
+    while (common < size && lhs[common] == rhs[common]) {
+      common++;
+    }
+    return common;
+  }
+
+  /* the entry of a key of trimmed_size bytes under a prefix of prefix_size bytes, without its slot */
+  static inline int EntrySize(int trimmed_size, int prefix_size) {
+    return 1 + std::max(0, trimmed_size - prefix_size) + VALUE_SIZE;
+  }
+
+  /* the prefix size of size sorted items, the first key whole if it is alone */
+  static int PrefixSize(const Item *items, int size) {
+    if (!KeyTraits<KeyType>::kBytewise || size == 0) {
+      return 0;
+    }
+    if (size == 1) {
+      return TrimmedSize(items[0].first);
+    }
+    int prefix_size = KEY_SIZE;
+    for (int i = 1; i < size && prefix_size > 0; i++) {
+      prefix_size = CommonPrefixSize(Bytes(items[0].first), Bytes(items[i].first), prefix_size);
+    }
+    return prefix_size;
+  }
+
+  /* the bytes of the prefix key starts with too */
+  inline int SharedPrefixSize(const KeyType &key) const {
+    return CommonPrefixSize(Bytes(key), Prefix(), prefix_size_);
+  }
+
+  inline int SlotsEnd(int size) const { return HEADER_SIZE + prefix_size_ + size * sizeof(uint16_t); }
+
+  inline char *Base() { return reinterpret_cast<char *>(this); }
+
+  inline const char *Base() const { return reinterpret_cast<const char *>(this); }
+
+  inline char *Prefix() { return Base() + HEADER_SIZE; }
+
+  inline const char *Prefix() const { return Base() + HEADER_SIZE; }
+
+  inline char *Slots() { return Prefix() + prefix_size_; }
+
+  inline const char *Slots() const { return Prefix() + prefix_size_; }
+
+  inline uint16_t Slot(int index) const {
+    uint16_t offset;
+    memcpy(&offset, Slots() + index * sizeof(uint16_t), sizeof(uint16_t));
+    return offset;
+  }
+
+  inline void SetSlot(int index, uint16_t offset) {
+    memcpy(Slots() + index * sizeof(uint16_t), &offset, sizeof(uint16_t));
+  }
+
+  inline char *Entry(int index) { return Base() + Slot(index); }
+
+  inline const char *Entry(int index) const { return Base() + Slot(index); }
+
+  inline void WriteEntry(int offset, const KeyType &key, int trimmed_size, const ValueType &value) {
+    char *entry = Base() + offset;
+    int suffix_size = std::max(0, trimmed_size - prefix_size_);
+    entry[0] = static_cast<char>(suffix_size);
+    memcpy(entry + 1, Bytes(key) + prefix_size_, suffix_size);
+    memcpy(entry + 1 + suffix_size, &value, VALUE_SIZE);
+  }
+
+  /* insert by packing the array again, with a new prefix and no holes */
+  void InsertAndPack(int size, int index, const KeyType &key, const ValueType &value) {
+    std::vector<Item> items = Items(size);
+    items.insert(items.begin() + index, Item(key, value));
+    Assign(items.data(), size + 1);
+  }
+
+  uint16_t capacity_;
+  uint16_t prefix_size_;
+  uint16_t heap_begin_;  // offset of the first entry byte
+  uint16_t garbage_;     // bytes of removed entries not packed yet
+};
+
+#endif  // MINISQL_PREFIX_KEY_ARRAY_H
@@ -1,5 +1,6 @@
 %{
   #include <stdio.h>
+  #include <string.h>
   #include "parser/parser.h"
 
   extern char *yytext;
@@ -27,7 +28,7 @@
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
 %type <syntax_node> sql_insert sql_delete sql_update update_values update_value
-%type <syntax_node> sql_quit sql_exec_file
+%type <syntax_node> sql_quit sql_exec_file sql_analyze
 
 %%
 
@@ -58,6 +59,7 @@ sql:
   | sql_trx_rollback { $$ = $1; }
   | sql_quit { $$ = $1; }
   | sql_exec_file { $$ = $1; }
+  | sql_analyze { $$ = $1; }
   ;
 
 sql_create_database:
@@ -180,6 +182,22 @@ sql_create_index:
       SyntaxNodeAddChildren(index_type_node, $10);
       SyntaxNodeAddChildren($$, index_type_node);
   }
+  | CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' IDENTIFIER '(' column_list ')' {
+      /* include is no keyword of the lexer, so that it stays usable as a column name */
+      if (strcmp($9->val_, "include") != 0) {
+        yyerror("syntax error");
+        YYERROR;
+      }
+      $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
+      SyntaxNodeAddChildren($$, $3);
+      SyntaxNodeAddChildren($$, $5);
+      pSyntaxNode index_keys_node = CreateSyntaxNode(kNodeColumnList, "index keys");
+      SyntaxNodeAddChildren(index_keys_node, $7);
+      SyntaxNodeAddChildren($$, index_keys_node);
+      pSyntaxNode include_columns_node = CreateSyntaxNode(kNodeColumnList, "include columns");
+      SyntaxNodeAddChildren(include_columns_node, $11);
+      SyntaxNodeAddChildren($$, include_columns_node);
+  }
   ;
 
 sql_drop_index:
@@ -393,6 +411,18 @@ sql_exec_file:
   }
   ;
 
+sql_analyze:
+  IDENTIFIER IDENTIFIER {
+    /* analyze is no keyword of the lexer, so that it stays usable as a name */
+    if (strcmp($1->val_, "analyze") != 0) {
+      yyerror("syntax error");
+      YYERROR;
+    }
+    $$ = CreateSyntaxNode(kNodeAnalyze, NULL);
+    SyntaxNodeAddChildren($$, $2);
+  }
+  ;
+
 %%
 int yyerror(char* error) {
 	MinisqlParserSetError(error);
@@ -0,0 +1,97 @@
+#ifndef MINISQL_COLUMN_COMPARATOR_H
+#define MINISQL_COLUMN_COMPARATOR_H
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+#include "record/field.h"
+#include "record/type_id.h"
+
+/**
+ * Comparison kernels specialized on the column type.
+ *
+ * Unlike Field::CompareXXX, they neither go through the Type singletons nor check
+ * for null and comparability: the caller resolves the kernel once per column and
+ * handles null values itself. All of them return <0, 0 or >0.
+ */
+template<TypeId type>
+class ColumnComparator;
+
+template<>
+class ColumnComparator<TypeId::kTypeInt> {
+public:
+  static inline int Compare(const Field &lhs, const Field &rhs) {
+    return CompareValues(lhs.value_.integer_, rhs.value_.integer_);
+  }
+
+  /* compare two values in their serialized form */
+  static inline int CompareSerialized(const char *lhs, const char *rhs) {
+    return CompareValues(MACH_READ_INT32(lhs), MACH_READ_INT32(rhs));
+  }
+
+  static inline uint32_t GetSerializedSize(const char *) { return sizeof(int32_t); }
+
+private:
+  static inline int CompareValues(int32_t lhs, int32_t rhs) { return (lhs > rhs) - (lhs < rhs); }
+};
+
+template<>
+class ColumnComparator<TypeId::kTypeFloat> {
+public:
+  static inline int Compare(const Field &lhs, const Field &rhs) {
+    return CompareValues(lhs.value_.float_, rhs.value_.float_);
+  }
+
+  static inline int CompareSerialized(const char *lhs, const char *rhs) {
+    return CompareValues(MACH_READ_FROM(float, lhs), MACH_READ_FROM(float, rhs));
+  }
+
+  static inline uint32_t GetSerializedSize(const char *) { return sizeof(float); }
+
+private:
+  static inline int CompareValues(float lhs, float rhs) { return (lhs > rhs) - (lhs < rhs); }
+};
+
+template<>
+class ColumnComparator<TypeId::kTypeChar> {
+public:
+  static inline int Compare(const Field &lhs, const Field &rhs) {
+    return CompareValues(lhs.GetChars(), lhs.len_, rhs.GetChars(), rhs.len_);
+  }
+
+  /* serialized chars are prefixed with their length */
+  static inline int CompareSerialized(const char *lhs, const char *rhs) {
+    return CompareValues(lhs + sizeof(uint32_t), MACH_READ_UINT32(lhs), rhs + sizeof(uint32_t), MACH_READ_UINT32(rhs));
+  }
+
+  static inline uint32_t GetSerializedSize(const char *data) { return sizeof(uint32_t) + MACH_READ_UINT32(data); }
+
+private:
+  static inline int CompareValues(const char *lhs, uint32_t lhs_len, const char *rhs, uint32_t rhs_len) {
+    int ret = memcmp(lhs, rhs, std::min(lhs_len, rhs_len));
+    if (ret == 0) {
+      return (lhs_len > rhs_len) - (lhs_len < rhs_len);
+    }
+    return ret;
+  }
+};
+
+/**
+ * Call visitor with the ColumnComparator of type. The type is looked at once, a loop written
+ * as a generic lambda over the comparator is compiled for each type and calls its kernels directly.
+ */
+template<typename Visitor>
+inline auto DispatchColumnComparator(TypeId type, Visitor &&visitor) {
+  switch (type) {
+    case TypeId::kTypeFloat:
+      return visitor(ColumnComparator<TypeId::kTypeFloat>());
+    case TypeId::kTypeChar:
+      return visitor(ColumnComparator<TypeId::kTypeChar>());
+    default:
+      ASSERT(type == TypeId::kTypeInt, "No comparator for the type.");
+      return visitor(ColumnComparator<TypeId::kTypeInt>());
+  }
+}
+
+#endif  // MINISQL_COLUMN_COMPARATOR_H
@@ -8,9 +8,15 @@
 #include "record/types.h"
 #include "record/type_id.h"
 
+template<TypeId type>
+class ColumnComparator;
+
 class Field {
   friend class Type;
 
+  template<TypeId type>
+  friend class ColumnComparator;
+
   friend class TypeInt;
 
   friend class TypeChar;
@@ -21,7 +27,7 @@ public:
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
   ~Field() {
-    if (type_id_ == TypeId::kTypeChar && manage_data_) {
+    if (type_id_ == TypeId::kTypeChar && manage_data_ && !is_inline_) {
       delete[] value_.chars_;
     }
   }
@@ -51,8 +57,7 @@ public:
     } else {
       if (manage_data) {
         ASSERT(len < VARCHAR_MAX_LEN, "Field length exceeds max varchar length");
-        value_.chars_ = new char[len];
-        memcpy(value_.chars_, data, len);
+        CopyChars(data, len);
       } else {
         value_.chars_ = data;
       }
@@ -67,19 +72,30 @@ public:
     is_null_ = other.is_null_;
     manage_data_ = other.manage_data_;
     if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
-      value_.chars_ = new char[len_];
-      memcpy(value_.chars_, other.value_.chars_, len_);
+      CopyChars(other.GetChars(), len_);
     } else {
       value_ = other.value_;
     }
   }
 
+  // move constructor, takes over the character buffer (or the inline copy) of other
+  Field(Field &&other) noexcept
+          : value_(other.value_), type_id_(other.type_id_), len_(other.len_), is_null_(other.is_null_),
+            manage_data_(other.manage_data_), is_inline_(other.is_inline_) {
+    other.manage_data_ = false;
+  }
+
   // copy
   Field &operator=(Field &other) {
     Swap(*this, other);
     return *this;
   }
 
+  Field &operator=(Field &&other) noexcept {
+    Swap(*this, other);
+    return *this;
+  }
+
   inline bool IsNull() const {
     return is_null_;
   }
@@ -140,18 +156,41 @@ public:
     std::swap(first.len_, second.len_);
     std::swap(first.is_null_, second.is_null_);
     std::swap(first.manage_data_, second.manage_data_);
+    std::swap(first.is_inline_, second.is_inline_);
   }
 
+  /**
+   * Owned char values up to this length are kept inside the field instead of on the heap
+   */
+  static constexpr uint32_t FIELD_INLINE_CHARS = 15;
+
 protected:
+  inline const char *GetChars() const { return is_inline_ ? value_.inline_chars_ : value_.chars_; }
+
+  /* take a private copy of data, null-terminated so that it can be printed */
+  inline void CopyChars(const char *data, uint32_t len) {
+    if (len <= FIELD_INLINE_CHARS) {
+      memcpy(value_.inline_chars_, data, len);
+      value_.inline_chars_[len] = '\0';
+      is_inline_ = true;
+    } else {
+      value_.chars_ = new char[len + 1];
+      memcpy(value_.chars_, data, len);
+      value_.chars_[len] = '\0';
+    }
+  }
+
   union Val {
     int32_t integer_;
     float float_;
     char *chars_;
+    char inline_chars_[FIELD_INLINE_CHARS + 1];
   } value_;
   TypeId type_id_;
   uint32_t len_;
   bool is_null_{false};
   bool manage_data_{false};
+  bool is_inline_{false};
 };
 
 
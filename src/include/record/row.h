@@ -18,8 +18,15 @@
  * --------------------------------------------
  * | Field Nums | Null bitmap |
  * -------------------------------------------
- *  
  *
+ *  Rows with more than one field are written with an offset array after the bitmap,
+ *  this is marked by the highest bit of Field Nums:
+ * ------------------------------------------------------------------------
+ * | Field Nums | OFFSET_ARRAY flag | Null bitmap | Offset-1 | ... | Offset-N |
+ * ------------------------------------------------------------------------
+ *  Offset-i (2 bytes) is the position of Field-i from the beginning of the row,
+ *  so a single column can be located without decoding the ones before it.
+ *  Rows written without the flag are still read back correctly.
  */
 class Row {
   /*this friend class is added by me*/
@@ -30,7 +37,7 @@ class Row {
    * Row used for insert
    * Field integrity should check by upper level
    */
-  explicit Row(std::vector<Field> &fields) : heap_(new SimpleMemHeap) {
+  explicit Row(std::vector<Field> &fields) : heap_(&arena_) {
     // deep copy
     for (auto &field : fields) {
       void *buf = heap_->Allocate(sizeof(Field));
@@ -38,6 +45,16 @@ class Row {
     }
   }
 
+  /**
+   * Row used for insert, fields are allocated from the given memory context
+   */
+  Row(std::vector<Field> &fields, MemHeap *heap) : heap_(heap) {
+    for (auto &field : fields) {
+      void *buf = heap_->Allocate(sizeof(Field));
+      fields_.push_back(new(buf)Field(field));
+    }
+  }
+
   /**
    * Row used for deserialize
    */
@@ -46,18 +63,17 @@ class Row {
   /**
    * Row used for deserialize and update
    */
-  Row(RowId rid) : rid_(rid), heap_(new SimpleMemHeap) {}
+  Row(RowId rid) : rid_(rid), heap_(&arena_) {}
+
+  /**
+   * Row used for deserialize, fields are allocated from the given memory context
+   */
+  Row(RowId rid, MemHeap *heap) : rid_(rid), heap_(heap) {}
 
   /**
    * Row copy function
    */
-  Row(const Row &other) : heap_(new SimpleMemHeap) {
-    if (!fields_.empty()) {
-      for (auto &field : fields_) {
-        heap_->Free(field);
-      }
-      fields_.clear();
-    }
+  Row(const Row &other) : heap_(&arena_) {
     rid_ = other.rid_;
     for (auto &field : other.fields_) {
       void *buf = heap_->Allocate(sizeof(Field));
@@ -66,7 +82,7 @@ class Row {
   }
 
   virtual ~Row() {
-    delete heap_;
+    ClearFields();
   }
 
   /**
@@ -96,12 +112,38 @@ class Row {
 
   inline size_t GetFieldCount() const { return fields_.size(); }
 
+  /* highest bit of the field count word, set when the row carries an offset array */
+  static constexpr uint32_t ROW_OFFSET_ARRAY_FLAG = 0x80000000;
+
+  static inline uint32_t GetBitmapSize(uint32_t field_count) {
+    return (field_count % 8 == 0) ? field_count / 8 : field_count / 8 + 1;
+  }
+
+  /* whether a row with field_count fields is written with an offset array */
+  static inline bool UseOffsetArray(uint32_t field_count) { return field_count > 1; }
+
 private:
   Row &operator=(const Row &other) = delete;
 
+  /**
+   * Destroy the fields and hand their memory back to the heap for reuse
+   */
+  void ClearFields() {
+    for (auto &field : fields_) {
+      field->~Field();
+      heap_->Free(field);
+    }
+    fields_.clear();
+  }
+
+  /* typical rows fit in the inline buffer, so building one doesn't touch the system allocator */
+  static constexpr size_t ROW_INLINE_HEAP_SIZE = 384;
+
 private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
+  alignas(8) char inline_heap_[ROW_INLINE_HEAP_SIZE];
+  ArenaMemHeap arena_{inline_heap_, ROW_INLINE_HEAP_SIZE};
   MemHeap *heap_{nullptr};
   //static constexpr uint32_t ROW_MAGIC_NUM = 200209;
 };
@@ -0,0 +1,88 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <vector>
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/schema.h"
+
+/**
+ * Read-only view of a serialized row (see row.h for the format).
+ *
+ * Nothing is copied out of the buffer: the view only keeps a pointer to the
+ * tuple bytes, so it is valid only as long as the page holding them stays pinned.
+ * Rows carrying an offset array locate any field in O(1). For rows without one,
+ * field offsets are decoded lazily from the null bitmap, up to the highest field
+ * that has been asked for.
+ */
+class RowView {
+public:
+  RowView() = default;
+
+  RowView(const char *data, Schema *schema, RowId rid = INVALID_ROWID) { Reset(data, schema, rid); }
+
+  /**
+   * Point this view at another serialized row, the offset buffer is reused
+   */
+  void Reset(const char *data, Schema *schema, RowId rid = INVALID_ROWID);
+
+  inline bool IsValid() const { return data_ != nullptr; }
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return field_count_; }
+
+  inline bool IsNull(uint32_t idx) const {
+    ASSERT(idx < field_count_, "Failed to access field");
+    return (static_cast<unsigned char>(bitmap_[idx / 8]) & (0x80 >> (idx % 8))) == 0;
+  }
+
+  /**
+   * @return pointer to the serialized field inside the page
+   */
+  inline const char *GetFieldData(uint32_t idx) const { return data_ + GetFieldOffset(idx); }
+
+  inline int32_t GetInt(uint32_t idx) const { return MACH_READ_INT32(data_ + GetFieldOffset(idx)); }
+
+  inline float GetFloat(uint32_t idx) const { return MACH_READ_FROM(float, data_ + GetFieldOffset(idx)); }
+
+  /**
+   * @return pointer to the characters inside the page, they are not null-terminated
+   */
+  inline const char *GetChars(uint32_t idx, uint32_t *len) const {
+    const char *p = data_ + GetFieldOffset(idx);
+    *len = MACH_READ_UINT32(p);
+    return p + sizeof(uint32_t);
+  }
+
+  /**
+   * Build a field that borrows its data from the page, char fields don't own their buffer
+   */
+  Field GetField(uint32_t idx) const;
+
+  /**
+   * Offset of field idx from the beginning of the row
+   */
+  uint32_t GetFieldOffset(uint32_t idx) const;
+
+  /**
+   * Bytes occupied by the whole row
+   */
+  uint32_t GetSerializedSize() const { return GetFieldOffset(field_count_); }
+
+private:
+  /* bytes taken by field idx stored at offset */
+  uint32_t GetFieldSize(uint32_t idx, uint32_t offset) const;
+
+  const char *data_{nullptr};
+  const char *bitmap_{nullptr};
+  const char *offset_array_{nullptr};
+  Schema *schema_{nullptr};
+  RowId rid_{};
+  uint32_t field_count_{0};
+  /* only used without offset array: offsets_[i] is known for all i < offsets_.size() */
+  mutable std::vector<uint32_t> offsets_;
+};
+
+#endif  // MINISQL_ROW_VIEW_H
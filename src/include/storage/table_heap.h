@@ -42,9 +42,9 @@ public:
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * if the new tuple is too large to fit in the old page, it is deleted there and inserted again
    * @param[in] row Tuple of new row
-   * @param[in] rid Rid of the old tuple
+   * @param[in,out] rid Rid of the old tuple, set to the rid of the new one if it had to move
    * @param[in] txn Transaction performing the update
    * @return true is update is successful.
    */
@@ -72,6 +72,25 @@ public:
    */
   bool GetTuple(Row *row, Transaction *txn);
 
+  /**
+   * Read a tuple in place, without deserializing it.
+   * The page of the tuple stays pinned in page, reading the next tuple from the same page does not
+   * fetch it again. Start with a null page and release the last one with ReleasePage.
+   * The page is not latched, like in GetTuple and the iterator: the view outlives the call, and a
+   * latch held as long as the pin would block the delete or update of the same statement, which
+   * writes the page its child read the row from. The engine runs one statement at a time.
+   * @param[in] rid Rid of the tuple
+   * @param[out] view View of the tuple, valid while page stays pinned
+   * @param[in/out] page The page pinned by the last read, nullptr for none
+   * @return true if the read was successful (i.e. the tuple exists)
+   */
+  bool GetTupleView(const RowId &rid, RowView *view, TablePage *&page, Transaction *txn);
+
+  /**
+   * Unpin the page left pinned by GetTupleView
+   */
+  void ReleasePage(TablePage *&page);
+
   /**
    * Free table heap and release storage in disk file
    */
@@ -92,6 +111,11 @@ public:
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return the number of pages of this table, counted once and then kept up to date by inserts
+   */
+  uint32_t GetPageCount();
+
 private:
   /**
    * create table heap and initialize first page
@@ -120,6 +144,7 @@ private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
   Schema *schema_;
+  uint32_t page_count_{0};  // 0 until the pages are counted
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
 };
@@ -3,6 +3,7 @@
 
 #include "common/rowid.h"
 #include "record/row.h"
+#include "record/row_view.h"
 #include "transaction/transaction.h"
 
 
@@ -15,8 +16,9 @@ public:
   //explicit TableIterator();
   TableIterator() = delete;
   
-  explicit TableIterator(Row row, TablePage *table_page, TableHeap *table_heap, Transaction *txn);
+  explicit TableIterator(RowId rid, TablePage *table_page, TableHeap *table_heap, Transaction *txn);
 
+  /*the copy pins the current page again, so both iterators can unpin it*/
   explicit TableIterator(const TableIterator &other);
   
   ~TableIterator();
@@ -29,13 +31,26 @@ public:
 
   Row *operator->();
 
+  /**
+   * Zero-copy access to the current tuple, read straight from the pinned page.
+   * The row is only deserialized when operator* or operator-> is used.
+   */
+  const RowView &GetRowView();
+
+  inline RowId GetRowId() const { return row_.GetRowId(); }
+
   TableIterator &operator++();
 
   TableIterator operator++(int);
 
 private:
+  void LoadRow();
+
   // add your own private member variables here
   Row row_;
+  RowView view_;
+  bool row_loaded_{false};
+  bool view_loaded_{false};
   TablePage *cur_page_;
   TableHeap *table_heap_;
   Transaction *txn_;
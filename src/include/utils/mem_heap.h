@@ -1,8 +1,10 @@
 #ifndef MINISQL_MEM_HEAP_H
 #define MINISQL_MEM_HEAP_H
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
+#include <new>
 #include <unordered_set>
 #include "common/macros.h"
 
@@ -54,4 +56,169 @@ private:
   std::unordered_set<void *> allocated_;
 };
 
+/**
+ * Bump-pointer heap. Memory is carved out of large chunks and given back to the
+ * system all at once, on Reset() or when the heap is destroyed.
+ *
+ * Every block carries an 8-byte header with its size class, so Free() can put small
+ * blocks on a per-class free list and later allocations of the same class reuse them.
+ * Blocks larger than the biggest class are only reclaimed by Reset().
+ */
+class ArenaMemHeap : public MemHeap {
+public:
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 4096;
+
+  explicit ArenaMemHeap(size_t chunk_size = DEFAULT_CHUNK_SIZE) : chunk_size_(chunk_size) {}
+
+  /**
+   * The first allocations are served from buf (8-byte aligned), which must outlive the heap
+   */
+  ArenaMemHeap(char *buf, size_t size, size_t chunk_size = DEFAULT_CHUNK_SIZE)
+          : cur_(buf), end_(buf + size), inline_begin_(buf), inline_end_(buf + size), chunk_size_(chunk_size) {}
+
+  ~ArenaMemHeap() override { ReleaseChunks(); }
+
+  DISALLOW_COPY_AND_MOVE(ArenaMemHeap);
+
+  void *Allocate(size_t size) override {
+    uint32_t size_class = SizeClassOf(size);
+    if (size_class < NUM_SIZE_CLASSES && free_lists_[size_class] != nullptr) {
+      FreeBlock *block = free_lists_[size_class];
+      free_lists_[size_class] = block->next_;
+      return block;
+    }
+    size_t total = size_class < NUM_SIZE_CLASSES ? ClassSize(size_class) : AlignUp(size + HEADER_SIZE);
+    if (static_cast<size_t>(end_ - cur_) < total) {
+      NewChunk(total);
+    }
+    char *buf = cur_;
+    cur_ += total;
+    *reinterpret_cast<uint64_t *>(buf) = size_class;
+    return buf + HEADER_SIZE;
+  }
+
+  void Free(void *ptr) override {
+    if (ptr == nullptr) {
+      return;
+    }
+    uint64_t size_class = *reinterpret_cast<uint64_t *>(static_cast<char *>(ptr) - HEADER_SIZE);
+    if (size_class < NUM_SIZE_CLASSES) {
+      FreeBlock *block = static_cast<FreeBlock *>(ptr);
+      block->next_ = free_lists_[size_class];
+      free_lists_[size_class] = block;
+    }
+  }
+
+  /**
+   * Drop every allocation at once, the heap starts over from its inline buffer (if any)
+   */
+  void Reset() {
+    ReleaseChunks();
+    cur_ = inline_begin_;
+    end_ = inline_end_;
+    for (auto &head : free_lists_) {
+      head = nullptr;
+    }
+  }
+
+  /**
+   * @return number of chunks currently obtained from the system
+   */
+  inline size_t GetChunkCount() const { return chunk_count_; }
+
+private:
+  struct Chunk {
+    Chunk *next_;
+  };
+
+  struct FreeBlock {
+    FreeBlock *next_;
+  };
+
+  static constexpr size_t HEADER_SIZE = sizeof(uint64_t);
+  static constexpr size_t MIN_CLASS_SIZE = 16;
+  /* 16-byte steps up to 128 bytes (fields and other small objects), then 256, 512, 1024; header included */
+  static constexpr uint32_t NUM_LINEAR_CLASSES = 8;
+  static constexpr uint32_t NUM_SIZE_CLASSES = 11;
+
+  static inline size_t AlignUp(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+  static inline size_t ClassSize(uint32_t size_class) {
+    if (size_class < NUM_LINEAR_CLASSES) {
+      return MIN_CLASS_SIZE * (size_class + 1);
+    }
+    return (MIN_CLASS_SIZE * NUM_LINEAR_CLASSES) << (size_class - NUM_LINEAR_CLASSES + 1);
+  }
+
+  static inline uint32_t SizeClassOf(size_t size) {
+    size_t total = size + HEADER_SIZE;
+    if (total <= MIN_CLASS_SIZE * NUM_LINEAR_CLASSES) {
+      return (total - 1) / MIN_CLASS_SIZE;
+    }
+    uint32_t size_class = NUM_LINEAR_CLASSES;
+    while (size_class < NUM_SIZE_CLASSES && ClassSize(size_class) < total) {
+      size_class++;
+    }
+    return size_class;
+  }
+
+  void NewChunk(size_t min_size) {
+    size_t size = std::max(chunk_size_, min_size + sizeof(Chunk));
+    Chunk *chunk = static_cast<Chunk *>(::operator new(size));
+    chunk->next_ = chunks_;
+    chunks_ = chunk;
+    chunk_count_++;
+    cur_ = reinterpret_cast<char *>(chunk) + sizeof(Chunk);
+    end_ = reinterpret_cast<char *>(chunk) + size;
+  }
+
+  void ReleaseChunks() {
+    while (chunks_ != nullptr) {
+      Chunk *next = chunks_->next_;
+      ::operator delete(chunks_);
+      chunks_ = next;
+    }
+    chunk_count_ = 0;
+  }
+
+  char *cur_{nullptr};
+  char *end_{nullptr};
+  char *inline_begin_{nullptr};
+  char *inline_end_{nullptr};
+  size_t chunk_size_;
+  size_t chunk_count_{0};
+  Chunk *chunks_{nullptr};
+  FreeBlock *free_lists_[NUM_SIZE_CLASSES]{};
+};
+
+/**
+ * STL allocator drawing from a MemHeap, so containers can live in a memory context
+ * and go away together with it.
+ */
+template<typename T>
+class MemHeapAllocator {
+public:
+  using value_type = T;
+
+  explicit MemHeapAllocator(MemHeap *heap) : heap_(heap) {}
+
+  template<typename U>
+  MemHeapAllocator(const MemHeapAllocator<U> &other) : heap_(other.GetHeap()) {}
+
+  T *allocate(size_t n) { return static_cast<T *>(heap_->Allocate(n * sizeof(T))); }
+
+  void deallocate(T *ptr, size_t) { heap_->Free(ptr); }
+
+  inline MemHeap *GetHeap() const { return heap_; }
+
+  template<typename U>
+  bool operator==(const MemHeapAllocator<U> &other) const { return heap_ == other.GetHeap(); }
+
+  template<typename U>
+  bool operator!=(const MemHeapAllocator<U> &other) const { return heap_ != other.GetHeap(); }
+
+private:
+  MemHeap *heap_;
+};
+
 #endif //MINISQL_MEM_HEAP_H
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <string>
 #include "glog/logging.h"
 #include "index/b_plus_tree.h"
@@ -28,12 +29,13 @@ BPLUSTREE_TYPE::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_ma
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Destroy() {
-  if (IsEmpty()) {
-    return;
-  } else {
+  tree_latch_.WLock();
+  structure_version_++;
+  if (!IsEmpty()) {
     BPlusTreePage *root = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
     DestroyPage(root);
   }
+  tree_latch_.WUnlock();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -73,21 +75,24 @@ bool BPLUSTREE_TYPE::IsEmpty() const {
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result, int& position, page_id_t &leaf_page_id,Transaction *transaction) {
 
+  tree_latch_.RLock();
   if (IsEmpty()) {
+    tree_latch_.RUnlock();
     return false;
   } 
   ValueType ret_value;
-  LeafPage *target_leaf = reinterpret_cast<LeafPage *>(FindLeafPage(key)->GetData());
+  Page *page = LatchLeafPage(FindLeafPage(key), key, false);
+  LeafPage *target_leaf = reinterpret_cast<LeafPage *>(page->GetData());
   position = target_leaf->KeyIndex(key, comparator_);
-  // leaf_page_id = target_leaf->GetPageId();
-  if (target_leaf->Lookup(key, ret_value, comparator_)) {
+  leaf_page_id = target_leaf->GetPageId();
+  bool found = target_leaf->Lookup(key, ret_value, comparator_);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(leaf_page_id, false);
+  tree_latch_.RUnlock();
+  if (found) {
     result.push_back(ret_value);
-    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), true);
-    return true;
-  } else {
-    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), true);
-    return false;
   }
+  return found;
 }
 
 /*****************************************************************************
@@ -97,38 +102,253 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
+ * If unique_lower and unique_upper are given, key lies between them and the insertion fails
+ * as well if any key between them is there, checked under the same latches as the insertion.
  * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * keys return false, otherwise return true. False as well if a split is out of pages, the tree is unchanged then.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) { 
-  /*the code in textbook P643 */ 
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction,
+                            const KeyType *unique_lower, const KeyType *unique_upper) {
+  tree_latch_.RLock();
+  if (!IsEmpty()) {
+    Page *page = LatchLeafPage(FindLeafPage(key), key, true);
+    LeafPage *target_leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    int index = target_leaf->KeyIndex(key, comparator_);
+    bool duplicate = index < target_leaf->GetSize() && comparator_(target_leaf->KeyAt(index), key) == 0;
+    /*keys in range before the first one of the leaf may be in the leaf before, only the exclusive path looks*/
+    bool range_before = false;
+    if (unique_lower != nullptr) {
+      int lower_index = target_leaf->KeyIndex(*unique_lower, comparator_);
+      duplicate = duplicate || (lower_index < target_leaf->GetSize() &&
+                                comparator_(target_leaf->KeyAt(lower_index), *unique_upper) <= 0);
+      range_before = lower_index == 0;
+    }
+    if (duplicate) {
+      LOG(WARNING) << "Insert duplicated keys!" << std::endl;
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), false);
+      tree_latch_.RUnlock();
+      return false;
+    }
+    /*
+     * a key after the last one of a leaf may belong to the next leaf, if the separator of the next
+     * leaf is shorter than its first key: only a path read with the tree exclusive tells
+     */
+    bool at_end = (index == target_leaf->GetSize() && target_leaf->GetNextPageId() != INVALID_PAGE_ID) || range_before;
+    /*a leaf with room takes the key without touching any other page*/
+    if (!at_end && target_leaf->HasRoomFor(key)) {
+      target_leaf->Insert(key, value, comparator_);
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), true);
+      tree_latch_.RUnlock();
+      return true;
+    }
+    /*
+     * a full leaf splits while the tree stays shared if its parent has room for the new
+     * separator, readers that reached the leaf before the parent knew of the split move right
+     */
+    if (!at_end && !target_leaf->IsRootPage()) {
+      Page *parent_page = buffer_pool_manager_->FetchPage(target_leaf->GetParentPageId());
+      parent_page->WLatch();
+      InternalPage *parent = reinterpret_cast<InternalPage *>(parent_page->GetData());
+      LeafPage *copy_leaf = parent->HasRoomForAnyKey() ? Split(target_leaf, key, value) : nullptr;
+      if (copy_leaf != nullptr) {
+        copy_leaf->SetParentPageId(parent->GetPageId());
+        parent->InsertNodeAfter(target_leaf->GetPageId(),
+                                LeafArray::Separator(target_leaf->KeyAt(target_leaf->GetSize() - 1),
+                                                     copy_leaf->KeyAt(0)),
+                                copy_leaf->GetPageId());
+        buffer_pool_manager_->UnpinPage(copy_leaf->GetPageId(), true);
+        parent_page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
+        page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), true);
+        tree_latch_.RUnlock();
+        return true;
+      }
+      parent_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(parent->GetPageId(), false);
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), false);
+  }
+  tree_latch_.RUnlock();
+  /*the code in textbook P643, the split may reach the root so it runs alone*/
+  bool inserted = true;
+  tree_latch_.WLock();
+  structure_version_++;
   if (IsEmpty()) {
-    StartNewTree(key, value);
-    return true;
+    inserted = StartNewTree(key, value);
+  } else if (unique_lower != nullptr && HasKeyIn(*unique_lower, *unique_upper)) {
+    LOG(WARNING) << "Insert duplicated keys!" << std::endl;
+    inserted = false;
+  } else {
+    inserted = InsertIntoLeaf(key, value, transaction);
+  }
+  tree_latch_.WUnlock();
+  return inserted;
+}
+/*
+ * Build the tree from entries sorted by key without duplicates in one pass, the tree must be empty.
+ * The pages of every level are planned up front: each page is filled to fill_factor of its bytes
+ * and of its max size (at least half of them) and the last two pages share their entries, so
+ * the last one is not left short. The keys of the first internal level separate the leaves.
+ * Only the rightmost page of each level is pinned: a new page is appended to the rightmost page one
+ * level up, which therefore becomes its parent.
+ * @return: false if the tree is not empty, or if a page can't be allocated, the tree is left empty then
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &entries, double fill_factor) {
+  tree_latch_.WLock();
+  structure_version_++;
+  if (!IsEmpty()) {
+    tree_latch_.WUnlock();
+    return false;
+  }
+  auto max_entries = [fill_factor](int max_size) {
+    return std::max(max_size / 2 + 1, std::min(max_size, static_cast<int>(max_size * fill_factor)));
+  };
+  auto max_bytes = [fill_factor](int capacity) {
+    return std::max(capacity / 2, std::min(capacity, static_cast<int>(capacity * fill_factor)));
+  };
+  std::vector<BulkLoadLevel> levels;
+  std::vector<KeyType> keys;  // the key of each page of the level planned last in its parent
+  if (!entries.empty()) {
+    std::vector<int> sizes =
+        LeafArray::PlanRuns(entries.size(), [&entries](int i) { return entries[i].first; },
+                            max_bytes(PAGE_SIZE - LEAF_PAGE_HEADER_SIZE), max_entries(leaf_max_size_));
+    for (size_t i = 0, begin = 0; i < sizes.size(); begin += sizes[i], i++) {
+      keys.push_back(begin == 0 ? entries[0].first
+                                : LeafArray::Separator(entries[begin - 1].first, entries[begin].first));
+    }
+    levels.push_back(BulkLoadLevel{sizes});
+  }
+  while (!levels.empty() && levels.back().sizes_.size() > 1) {
+    std::vector<int> sizes =
+        InternalArray::PlanRuns(keys.size(), [&keys](int i) { return keys[i]; },
+                                max_bytes(PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE), max_entries(internal_max_size_));
+    std::vector<KeyType> first_keys;
+    for (size_t i = 0, begin = 0; i < sizes.size(); begin += sizes[i], i++) {
+      first_keys.push_back(keys[begin]);
+    }
+    keys.swap(first_keys);
+    levels.push_back(BulkLoadLevel{sizes});
+  }
+  bool failed = false;
+  for (size_t i = 0; i < entries.size();) {
+    KeyType key = i == 0 ? entries[0].first : LeafArray::Separator(entries[i - 1].first, entries[i].first);
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(BulkLoadNewPage(levels, 0, key));
+    if (leaf == nullptr) {
+      failed = true;
+      break;
+    }
+    int size = levels[0].GetNodeSize();
+    leaf->CopyNFrom(&entries[i], size);
+    i += size;
+  }
+  for (auto &level : levels) {
+    if (level.page_ != nullptr) {
+      buffer_pool_manager_->UnpinPage(level.page_->GetPageId(), true);
+    }
+  }
+  if (failed) {
+    /*drop the pages built so far, no one knows of them*/
+    for (auto &level : levels) {
+      for (page_id_t page_id : level.pages_) {
+        buffer_pool_manager_->DeletePage(page_id);
+      }
+    }
+    tree_latch_.WUnlock();
+    return false;
+  }
+  if (!levels.empty()) {
+    root_page_id_ = levels.back().page_->GetPageId();
+    UpdateRootPageId(0);
+  }
+  tree_latch_.WUnlock();
+  return true;
+}
+
+/*
+ * Close the page being filled on level and start the next one, whose key in its parent is key
+ * @return: the new page, nullptr if it or its parent can't be allocated
+ */
+INDEX_TEMPLATE_ARGUMENTS
+BPlusTreePage *BPLUSTREE_TYPE::BulkLoadNewPage(std::vector<BulkLoadLevel> &levels, size_t level,
+                                               const KeyType &key) {
+  BulkLoadLevel &current = levels[level];
+  page_id_t page_id = INVALID_PAGE_ID;
+  Page *page = buffer_pool_manager_->NewPage(page_id);
+  if (page == nullptr) {
+    LOG(WARNING) << "Fail to new page in bulk loading" << std::endl;
+    return nullptr;
+  }
+  current.pages_.push_back(page_id);
+  BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  if (level == 0) {
+    reinterpret_cast<LeafPage *>(node)->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
   } else {
-    return InsertIntoLeaf(key, value, transaction);
+    reinterpret_cast<InternalPage *>(node)->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+  }
+  if (current.page_ != nullptr) {
+    if (level == 0) {
+      reinterpret_cast<LeafPage *>(current.page_)->SetNextPageId(page_id);
+    }
+    buffer_pool_manager_->UnpinPage(current.page_->GetPageId(), true);
+  }
+  current.page_ = node;
+  current.node_++;
+  if (level + 1 < levels.size()) {
+    page_id_t parent_id = BulkLoadAppend(levels, level + 1, key, page_id);
+    if (parent_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
+    node->SetParentPageId(parent_id);
   }
+  return node;
 }
+
+/*
+ * Append child with key key to the page being filled on level
+ * @return: the page the child was appended to, INVALID_PAGE_ID if a page can't be allocated
+ */
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t BPLUSTREE_TYPE::BulkLoadAppend(std::vector<BulkLoadLevel> &levels, size_t level, const KeyType &key,
+                                         page_id_t child) {
+  if (levels[level].page_ == nullptr || levels[level].page_->GetSize() == levels[level].GetNodeSize()) {
+    if (BulkLoadNewPage(levels, level, key) == nullptr) {
+      return INVALID_PAGE_ID;
+    }
+  }
+  InternalPage *internal = reinterpret_cast<InternalPage *>(levels[level].page_);
+  /*array_[0].first holds the first key as well*/
+  internal->Append(key, child);
+  return internal->GetPageId();
+}
+
 /*
  * Insert constant key & value pair into an empty tree
- * User needs to first ask for new page from buffer pool manager(NOTICE: throw
- * an "out of memory" exception if returned value is nullptr), then update b+
+ * User needs to first ask for new page from buffer pool manager, then update b+
  * tree's root page id and insert entry directly into leaf page.
+ * @return: false if the page can't be allocated, the tree stays empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
-  Page *page = buffer_pool_manager_->NewPage(root_page_id_);
-  UpdateRootPageId(0);//insert a new index
+bool BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  page_id_t page_id = INVALID_PAGE_ID;
+  Page *page = buffer_pool_manager_->NewPage(page_id);
   if (page == nullptr) {
     LOG(WARNING) << "Fail to new page in insertion" << std::endl;
-    throw "out of memory";
+    return false;
   }
+  root_page_id_ = page_id;
+  UpdateRootPageId(0);//insert a new index
   BPlusTreeLeafPage<KeyType, ValueType, KeyComparator> *insert_pos =
       reinterpret_cast<BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>*>(page->GetData());
   insert_pos->Init(root_page_id_, INVALID_PAGE_ID, leaf_max_size_);
   insert_pos->Insert(key, value, comparator_);
   buffer_pool_manager_->UnpinPage(insert_pos->GetPageId(),true);
+  return true;
 }
 
 /*
@@ -137,7 +357,7 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  * through leaf page to see whether insert key exist or not. If exist, return
  * immediately, otherwise insert entry. Remember to deal with split if necessary.
  * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * keys return false, otherwise return true. False as well if a split is out of pages, the tree is unchanged then.
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) { 
@@ -148,47 +368,132 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
   }
   /*find the right leaf page to insert*/
   LeafPage *target_leaf = reinterpret_cast<LeafPage *>(FindLeafPage(key)->GetData());
-  if (target_leaf->GetSize() < target_leaf->GetMaxSize()) {
-    /*if the size can hold one more new value, just insert*/
-    int size=target_leaf->Insert(key, value, comparator_);
-    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(),true);
-    return (size==-1)?false:true;
-  } else {
-    int size=target_leaf->Insert(key, value, comparator_);
-    if (size == -1) return false;
-    LeafPage *copy_leaf = Split(target_leaf);
-    InsertIntoParent(target_leaf, copy_leaf->KeyAt(0), copy_leaf,nullptr);
-    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(),true);
-    buffer_pool_manager_->UnpinPage(copy_leaf->GetPageId(), true);
+  int index = target_leaf->KeyIndex(key, comparator_);
+  if (index < target_leaf->GetSize() && comparator_(target_leaf->KeyAt(index), key) == 0) {
+    LOG(WARNING) << "Insert duplicated keys!" << std::endl;
+    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), false);
+    return false;
+  }
+  if (target_leaf->HasRoomFor(key)) {
+    /*if the page can hold the new key, just insert*/
+    target_leaf->Insert(key, value, comparator_);
+    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), true);
     return true;
   }
+  /*the splits up to the root take their pages from the reserve, none of them can fail halfway*/
+  if (!ReservePages(target_leaf)) {
+    LOG(WARNING) << "Fail to new page in insertion" << std::endl;
+    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), false);
+    return false;
+  }
+  LeafPage *copy_leaf = Split(target_leaf, key, value);
+  InsertIntoParent(target_leaf,
+                   LeafArray::Separator(target_leaf->KeyAt(target_leaf->GetSize() - 1), copy_leaf->KeyAt(0)),
+                   copy_leaf, nullptr);
+  ReleaseReservedPages();
+  buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), true);
+  buffer_pool_manager_->UnpinPage(copy_leaf->GetPageId(), true);
+  return true;
+}
 
+/*
+ * Allocate the pages an insertion into the full leaf may need before any page is changed: the new
+ * leaf, one for every ancestor too full to take another key, and a new root if the split reaches it.
+ * An ancestor counted full may still take the actual separator, its page is given back unused.
+ * The ancestors stay pinned until ReleaseReservedPages, the split fetches them again.
+ * @return: false if a page can't be allocated or fetched, nothing is reserved or pinned then
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::ReservePages(LeafPage *leaf) {
+  size_t needed = 1;
+  page_id_t parent_id = leaf->GetParentPageId();
+  while (parent_id != INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->FetchPage(parent_id);
+    if (page == nullptr) {
+      ReleaseReservedPages();
+      return false;
+    }
+    reserved_path_.push_back(parent_id);
+    InternalPage *parent = reinterpret_cast<InternalPage *>(page->GetData());
+    if (parent->HasRoomForAnyKey()) {
+      break;
+    }
+    needed++;
+    parent_id = parent->GetParentPageId();
+  }
+  if (parent_id == INVALID_PAGE_ID) {
+    needed++;
+  }
+  while (reserved_pages_.size() < needed) {
+    page_id_t page_id = INVALID_PAGE_ID;
+    Page *page = buffer_pool_manager_->NewPage(page_id);
+    if (page == nullptr) {
+      ReleaseReservedPages();
+      return false;
+    }
+    reserved_pages_.push_back(page);
+  }
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::NewNodePage(page_id_t &page_id) {
+  if (reserved_pages_.empty()) {
+    return buffer_pool_manager_->NewPage(page_id);
+  }
+  Page *page = reserved_pages_.back();
+  reserved_pages_.pop_back();
+  page_id = page->GetPageId();
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseReservedPages() {
+  for (Page *page : reserved_pages_) {
+    page_id_t page_id = page->GetPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  reserved_pages_.clear();
+  for (page_id_t page_id : reserved_path_) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+  }
+  reserved_path_.clear();
 }
 
 /*
  * Split input page and return newly created page.
- * Using template N to represent either internal page or leaf page.
- * User needs to first ask for new page from buffer pool manager(NOTICE: throw
- * an "out of memory" exception if returned value is nullptr), then move half
- * of key & value pairs from input page to newly created page
+ * User needs to first ask for new page from buffer pool manager (NOTICE: return
+ * nullptr before touching input page if there is none, the exclusive path takes
+ * it from the pages reserved for the whole split), then move the pairs after the
+ * split point, the new one included, from input page to newly created page
  */
 INDEX_TEMPLATE_ARGUMENTS
-template<typename N>
-N *BPLUSTREE_TYPE::Split(N *node) {
+typename BPLUSTREE_TYPE::LeafPage *BPLUSTREE_TYPE::Split(LeafPage *node, const KeyType &key, const ValueType &value) {
   page_id_t created_page_id = INVALID_PAGE_ID;
-  N *created_page = reinterpret_cast<N *>(buffer_pool_manager_->NewPage(created_page_id)->GetData());
-  /*Init function has its default parameter*/
-  if (node->IsLeafPage()) {
-    created_page->Init(created_page_id, INVALID_PAGE_ID, leaf_max_size_);
-    LeafPage *leaf = reinterpret_cast<LeafPage *> (node);
-    leaf->MoveHalfTo(reinterpret_cast<LeafPage*>(created_page));
+  Page *page = NewNodePage(created_page_id);
+  if (page == nullptr) {
+    LOG(WARNING) << "Fail to new page in split" << std::endl;
+    return nullptr;
   }
-    
-  else {
-    created_page->Init(created_page_id, INVALID_PAGE_ID, internal_max_size_);
-    InternalPage *internal = reinterpret_cast<InternalPage *> (node);
-    internal->MoveHalfTo(reinterpret_cast<InternalPage *> (created_page), buffer_pool_manager_);
+  LeafPage *created_page = reinterpret_cast<LeafPage *>(page->GetData());
+  created_page->Init(created_page_id, INVALID_PAGE_ID, leaf_max_size_);
+  node->MoveHalfTo(created_page, key, value, comparator_);
+  return created_page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+typename BPLUSTREE_TYPE::InternalPage *BPLUSTREE_TYPE::Split(InternalPage *node, page_id_t old_id, const KeyType &key,
+                                                             page_id_t new_id) {
+  page_id_t created_page_id = INVALID_PAGE_ID;
+  Page *page = NewNodePage(created_page_id);
+  if (page == nullptr) {
+    LOG(WARNING) << "Fail to new page in split" << std::endl;
+    return nullptr;
   }
+  InternalPage *created_page = reinterpret_cast<InternalPage *>(page->GetData());
+  created_page->Init(created_page_id, INVALID_PAGE_ID, internal_max_size_);
+  node->MoveHalfTo(created_page, old_id, key, new_id, buffer_pool_manager_);
   return created_page;
 }
 
@@ -207,31 +512,21 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   /*code in textbook P644*/
   if (old_node->IsRootPage()) {
     /*replace PopulateRootPage()*/
+    /*the page comes from the reserve of InsertIntoLeaf, which counted the new root*/
     page_id_t new_root_page_id = INVALID_PAGE_ID;
-    InternalPage *new_root =
-        reinterpret_cast<InternalPage *>(buffer_pool_manager_->NewPage(new_root_page_id)->GetData());
-
-    if (new_root == nullptr) {
-      LOG(WARNING) << "New Page fails " << std::endl;
-      return;
-    }
+    Page *page = NewNodePage(new_root_page_id);
+    ASSERT(page != nullptr, "No page reserved for the new root.");
+    InternalPage *new_root = reinterpret_cast<InternalPage *>(page->GetData());
     new_root->Init(new_root_page_id, INVALID_PAGE_ID, internal_max_size_);
     root_page_id_ = new_root_page_id;
     UpdateRootPageId(1);
     /*here I choose to maintain the array_[0].first*/
     if (old_node->IsLeafPage()) {
-      LeafPage *old_leaf = reinterpret_cast<LeafPage *> (old_node);
-      new_root->SetKeyAt(0, old_leaf->KeyAt(0));
+      new_root->Append(reinterpret_cast<LeafPage *>(old_node)->KeyAt(0), old_node->GetPageId());
     } else {
-      InternalPage *old_internal = reinterpret_cast<InternalPage *> (old_node);
-      new_root->SetKeyAt(0, old_internal->KeyAt(0));
-    }
-    /*it's the function of poculate function*/
-    /*set key, value, and size of new root*/
-    new_root->SetKeyAt(1, key);
-    new_root->SetSize(2);
-    new_root->SetValueAt(0, old_node->GetPageId());
-    new_root->SetValueAt(1, new_node->GetPageId());
+      new_root->Append(reinterpret_cast<InternalPage *>(old_node)->KeyAt(0), old_node->GetPageId());
+    }
+    new_root->Append(key, new_node->GetPageId());
     /*make new root as parent as old_node and new_node*/
     old_node->SetParentPageId(new_root_page_id);
     new_node->SetParentPageId(new_root_page_id);
@@ -241,13 +536,12 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
   page_id_t parent_id = old_node->GetParentPageId();
   InternalPage *parent_node = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
   /*if parent could hold one more node*/
-  if (parent_node->GetSize() < parent_node->GetMaxSize()) {
+  new_node->SetParentPageId(parent_id);
+  if (parent_node->HasRoomFor(key)) {
     parent_node->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-    new_node->SetParentPageId(parent_node->GetPageId());
   } else {
-    parent_node->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
-    new_node->SetParentPageId(parent_node->GetPageId());
-    InternalPage *copy_internal = Split(parent_node);
+    /*the pairs moved to the new page, new_node may be one of them, are adopted by it*/
+    InternalPage *copy_internal = Split(parent_node, old_node->GetPageId(), key, new_node->GetPageId());
     InsertIntoParent(parent_node, copy_internal->KeyAt(0), copy_internal);
     buffer_pool_manager_->UnpinPage(copy_internal->GetPageId(),true);
   }
@@ -267,49 +561,56 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  tree_latch_.RLock();
+  if (IsEmpty()) {
+    tree_latch_.RUnlock();
+    return;
+  }
+  Page *page = LatchLeafPage(FindLeafPage(key), key, true);
+  LeafPage *target_leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = target_leaf->KeyIndex(key, comparator_);
+  bool found = index < target_leaf->GetSize() && comparator_(target_leaf->KeyAt(index), key) == 0;
+  if (found) {
+    target_leaf->RemoveAndDeleteRecord(key, comparator_);
+  }
+  /*the separators are lower bounds and stay valid, only an underflow reaches the siblings*/
+  bool rebalance = found && (target_leaf->IsRootPage() ? target_leaf->GetSize() == 0 : target_leaf->IsUnderflow());
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), found);
+  tree_latch_.RUnlock();
+  if (rebalance) {
+    tree_latch_.WLock();
+    structure_version_++;
+    RemoveFromLeaf(key, transaction);
+    tree_latch_.WUnlock();
+  }
+}
+
+/*
+ * Remove with the tree latched exclusively, then merge or redistribute the leaf if it underflows.
+ * The key may be gone already, removed while the tree was shared.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveFromLeaf(const KeyType &key, Transaction *transaction) {
   if (IsEmpty()) return;
   /*find where the key is*/
   LeafPage *target_leaf = reinterpret_cast<LeafPage *>(FindLeafPage(key)->GetData());
   target_leaf->RemoveAndDeleteRecord(key, comparator_);
-  /*update the value in ancestor*/
-  InternalPage *parent = nullptr;
-  int update_index = -1; /*update_index is the updated key index, 
-                         if it is 0, we need to go to parent to update*/
-  if (!target_leaf->IsRootPage()) {
-    parent =
-        reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(target_leaf->GetParentPageId())->GetData());
-      /*if the key in parent is smaller, 
-      the smallest key in target leaf is deleted,we need to update*/
-    update_index = parent->ValueIndex(target_leaf->GetPageId());
-    parent->SetKeyAt(update_index, target_leaf->KeyAt(0));
-  }
-  InternalPage *p_parent = nullptr;
-  while (update_index == 0 && (!parent->IsRootPage())) {
-    p_parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent->GetParentPageId())->GetData());
-    update_index = p_parent->ValueIndex(parent->GetPageId());
-    p_parent->SetKeyAt(update_index, parent->KeyAt(0));
-    /*move higher and unpin*/
-    buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-    parent = p_parent;
-  }
-  if (parent != nullptr) {
-    buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-  }
-
-
-  /*check if this leaf is root and if the size is less than minsize*/
-  if (target_leaf->GetSize() < target_leaf->GetMinSize()) {
-    CoalesceOrRedistribute(target_leaf, transaction);
+  bool deleted = false;
+  if (target_leaf->IsRootPage() ? target_leaf->GetSize() == 0 : target_leaf->IsUnderflow()) {
+    deleted = CoalesceOrRedistribute(target_leaf, transaction);
   }
   /*else, delete is successful*/
-  buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), true);
+  if (!deleted) {
+    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), true);
+  }
 }
 
 /*
- * User needs to first find the sibling of input page. If sibling's size + input
- * page's size > page's max size, then redistribute. Otherwise, merge.
+ * User needs to first find the sibling of input page. If both fit in one page,
+ * merge. Otherwise, redistribute one pair if it fits, or leave the page as it is.
  * Using template N to represent either internal page or leaf page.
- * @return: true means target leaf page should be deleted, false means no
+ * @return: true means target leaf page is deleted, false means no
  * deletion happens
  */
 INDEX_TEMPLATE_ARGUMENTS
@@ -317,50 +618,40 @@ template<typename N>
 bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
   /*first process the special case when node is the root*/
   if (node->GetPageId() == root_page_id_) {
-    if (node->GetSize() > 1) {
-      return false;
-    } else {
-      AdjustRoot(node);
-      return false;
-    }
+    return AdjustRoot(node);
   }
   bool deleted = false; /*denote node is deleted or not*/
+  bool parent_deleted = false;
   InternalPage *parent =
       reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
   int this_index = parent->ValueIndex(node->GetPageId());
   N *pre_sibling = nullptr;
   N *next_sibling = nullptr;
   /*if N index is not 0 or the last child, it has previous and next siblings*/
-  if (this_index != 0 && this_index != parent->GetSize()-1) {
+  if (this_index > 0) {
     pre_sibling = reinterpret_cast<N *>(buffer_pool_manager_->FetchPage(parent->ValueAt(this_index - 1))->GetData());
-    next_sibling = reinterpret_cast<N *>(buffer_pool_manager_->FetchPage(parent->ValueAt(this_index + 1))->GetData());
   }
-  else if (this_index == 0) {
+  if (this_index < parent->GetSize() - 1) {
     next_sibling = reinterpret_cast<N *>(buffer_pool_manager_->FetchPage(parent->ValueAt(this_index + 1))->GetData());
-  } else if (this_index == parent->GetSize() - 1) {
-    pre_sibling = reinterpret_cast<N *>(buffer_pool_manager_->FetchPage(parent->ValueAt(this_index - 1))->GetData());
   }
-  /*first we try distribute*/
-  if (pre_sibling&&pre_sibling->GetSize() + node->GetSize() > node->GetMaxSize()) {
-    Redistribute(pre_sibling, node, 1);
-  } else if (next_sibling&&next_sibling->GetSize() + node->GetSize() > node->GetMaxSize()) {
-    Redistribute(next_sibling, node, 0);
-  } /*else we try merge*/ 
-  else if (pre_sibling&&pre_sibling->GetSize() +node->GetSize() >= pre_sibling->GetMinSize()) {
+  /*first we try merge, the pairs of both pages must fit in one*/
+  if (pre_sibling && pre_sibling->CanMergeWith(node)) {
     deleted = true;
     if (Coalesce(&pre_sibling, &node, &parent, this_index, transaction)) {
       /*means the parent size is too small, process parent*/
-      if (!CoalesceOrRedistribute(parent, transaction)) {
-        /*parent is not deleted, we will unpin it*/
-        buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-      }
+      parent_deleted = CoalesceOrRedistribute(parent, transaction);
     }
-  } else if (next_sibling && next_sibling->GetSize() + node->GetSize() >= next_sibling->GetMinSize()) {
+  } else if (next_sibling && node->CanMergeWith(next_sibling)) {
     if (Coalesce(&node, &next_sibling, &parent, this_index + 1, transaction)) {
-      if (!CoalesceOrRedistribute(parent, transaction)) {
-        buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
-      }
+      parent_deleted = CoalesceOrRedistribute(parent, transaction);
     }
+  } /*else we try distribute*/
+  else if (!(pre_sibling && Redistribute(pre_sibling, node, 1)) && next_sibling) {
+    Redistribute(next_sibling, node, 0);
+  }
+  /*parent is not deleted, we will unpin it*/
+  if (!parent_deleted) {
+    buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
   }
   if (pre_sibling) {
     buffer_pool_manager_->UnpinPage(pre_sibling->GetPageId(),true);
@@ -380,7 +671,7 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
  * @param   parent             parent page of input "node"
- * @return  true means parent node should be deleted, false means no deletion happened
+ * @return  true means parent node should be merged or redistributed, false means it is fine
  */
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
@@ -392,8 +683,8 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
   if (reinterpret_cast<BPlusTreePage *>(*node)->IsLeafPage())
     reinterpret_cast<LeafPage *>(*node)->MoveAllTo(reinterpret_cast<LeafPage *>(*neighbor_node));
   else {
-    int index = reinterpret_cast<InternalPage *>(*node)->ValueIndex((*node)->GetPageId());
-    KeyType key = reinterpret_cast<InternalPage *>(*node)->KeyAt(index);
+    /*the first key of node bounds its pairs in the neighbor*/
+    KeyType key = reinterpret_cast<InternalPage *>(*node)->KeyAt(0);
     reinterpret_cast<InternalPage *>(*node)->MoveAllTo(reinterpret_cast<InternalPage *>(*neighbor_node), key,
                                                        buffer_pool_manager_);
   }
@@ -401,78 +692,72 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
   buffer_pool_manager_->UnpinPage((*node)->GetPageId(), true);
   buffer_pool_manager_->DeletePage((*node)->GetPageId());
   *node = nullptr;
-  /*process their parent*/
+  /*process their parent, the key of the neighbor before still bounds the merged pairs*/
   (*parent)->Remove(index);
-  /*if index==1, we need to update the parent's parent to maintain*/
-  if (!(*parent)->IsRootPage()&&index==0) {
-    InternalPage *p_parent =
-        reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage((*parent)->GetParentPageId())->GetData());
-    p_parent->SetKeyAt(p_parent->ValueIndex((*parent)->GetPageId()), (*parent)->KeyAt(0));
-    buffer_pool_manager_->UnpinPage(p_parent->GetPageId(),true);
-  }
   /*check parent*/
-  if ((*parent)->GetSize() < (*parent)->GetMinSize())
-    return true;
-  else
-    return false;
-
+  return (*parent)->IsRootPage() ? (*parent)->GetSize() == 1 : (*parent)->IsUnderflow();
 }
 
 /*
  * Redistribute key & value pairs from one page to its sibling page. If index ==
  * 0, move sibling page's first key & value pair into end of input "node",
  * otherwise move sibling page's last key & value pair into head of input
- * "node".
+ * "node". The key of the page on the right in the parent becomes a separator of
+ * the pairs on both sides.
  * Using template N to represent either internal page or leaf page.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
+ * @return  false if nothing moved: node has no room for the pair, or the parent none for the separator
  */
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
-void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
+bool BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
+  if (neighbor_node->GetSize() < 2) {
+    return false;
+  }
+  InternalPage *parent =
+      reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
+  /*the page on the right of the two*/
+  page_id_t right_id = index == 0 ? neighbor_node->GetPageId() : node->GetPageId();
+  bool moved = false;
   if (node->IsLeafPage()) {
+    LeafPage *neighbor = reinterpret_cast<LeafPage *>(neighbor_node);
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(node);
     if (index == 0) {
-      reinterpret_cast<LeafPage *>(neighbor_node)->MoveFirstToEndOf(reinterpret_cast<LeafPage *>(node));
-      /*because we move the first element, so we need to update the key in parent*/
-      if (!neighbor_node->IsRootPage()) {
-        InternalPage *parent = reinterpret_cast<InternalPage *>(
-            buffer_pool_manager_->FetchPage(neighbor_node->GetParentPageId())->GetData());
-        parent->SetKeyAt(parent->ValueIndex(neighbor_node->GetPageId()), neighbor_node->KeyAt(0));
-        buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
+      KeyType key = neighbor->KeyAt(0);
+      moved = leaf->HasRoomFor(key) &&
+              parent->SetKeyAt(parent->ValueIndex(right_id), LeafArray::Separator(key, neighbor->KeyAt(1)));
+      if (moved) {
+        neighbor->MoveFirstToEndOf(leaf);
       }
     } else {
-      reinterpret_cast<LeafPage *>(neighbor_node)->MoveLastToFrontOf(reinterpret_cast<LeafPage *>(node));
-      if (!node->IsRootPage()) {
-        InternalPage *parent = reinterpret_cast<InternalPage *>(
-            buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
-        parent->SetKeyAt(parent->ValueIndex(node->GetPageId()), node->KeyAt(0));
-        buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
+      KeyType key = neighbor->KeyAt(neighbor->GetSize() - 1);
+      moved = leaf->HasRoomFor(key) &&
+              parent->SetKeyAt(parent->ValueIndex(right_id),
+                               LeafArray::Separator(neighbor->KeyAt(neighbor->GetSize() - 2), key));
+      if (moved) {
+        neighbor->MoveLastToFrontOf(leaf);
       }
     }
   } else {
-    
-    KeyType key = reinterpret_cast<InternalPage *>(node)->KeyAt(0);
+    InternalPage *neighbor = reinterpret_cast<InternalPage *>(neighbor_node);
+    InternalPage *internal = reinterpret_cast<InternalPage *>(node);
     if (index == 0) {
-      reinterpret_cast<InternalPage *>(neighbor_node)
-          ->MoveFirstToEndOf(reinterpret_cast<InternalPage *>(node), key, buffer_pool_manager_);
-      /*the same as above to update parent*/
-      if (!neighbor_node->IsRootPage()) {
-        InternalPage *parent = reinterpret_cast<InternalPage *>(
-            buffer_pool_manager_->FetchPage(neighbor_node->GetParentPageId())->GetData());
-        parent->SetKeyAt(parent->ValueIndex(neighbor_node->GetPageId()), neighbor_node->KeyAt(0));
-        buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
+      KeyType key = neighbor->KeyAt(0);
+      moved = internal->HasRoomFor(key) && parent->SetKeyAt(parent->ValueIndex(right_id), neighbor->KeyAt(1));
+      if (moved) {
+        neighbor->MoveFirstToEndOf(internal, key, buffer_pool_manager_);
       }
     } else {
-      reinterpret_cast<InternalPage *>(neighbor_node)
-          ->MoveLastToFrontOf(reinterpret_cast<InternalPage *>(node), key, buffer_pool_manager_);
-      if (!node->IsRootPage()) {
-        InternalPage *parent =
-            reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
-        parent->SetKeyAt(parent->ValueIndex(node->GetPageId()), node->KeyAt(0));
-        buffer_pool_manager_->UnpinPage(parent->GetPageId(), true);
+      KeyType key = neighbor->KeyAt(neighbor->GetSize() - 1);
+      moved = internal->HasRoomFor(key) && parent->SetKeyAt(parent->ValueIndex(right_id), key);
+      if (moved) {
+        neighbor->MoveLastToFrontOf(internal, key, buffer_pool_manager_);
       }
     }
   }
+  buffer_pool_manager_->UnpinPage(parent->GetPageId(), moved);
+  return moved;
 }
 /*
  * Update root page if necessary
@@ -522,9 +807,15 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() { 
+  tree_latch_.RLock();
+  if (IsEmpty()) {
+    tree_latch_.RUnlock();
+    return End();
+  }
   KeyType key{};
-  LeafPage *target_leaf = reinterpret_cast<LeafPage *> (FindLeafPage(key, true)->GetData());
-  return INDEXITERATOR_TYPE(target_leaf, 0, buffer_pool_manager_);
+  INDEXITERATOR_TYPE iterator(FindLeafPage(key, true), 0, buffer_pool_manager_, this);
+  tree_latch_.RUnlock();
+  return iterator;
 }
 
 /*
@@ -534,12 +825,131 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
-  LeafPage *target_leaf = reinterpret_cast<LeafPage *> (FindLeafPage(key, false)->GetData());
+  tree_latch_.RLock();
+  if (IsEmpty()) {
+    tree_latch_.RUnlock();
+    return End();
+  }
+  Page *page = LatchLeafPage(FindLeafPage(key, false), key, false);
+  LeafPage *target_leaf = reinterpret_cast<LeafPage *> (page->GetData());
   int index = target_leaf->KeyIndex(key, comparator_);
-  if (comparator_( target_leaf->KeyAt(index) , key)!=0) {
+  page->RUnlatch();
+  /*the iterator copies the pair under the leaf latch, check the key on that copy*/
+  INDEXITERATOR_TYPE iterator(page, index, buffer_pool_manager_, this);
+  tree_latch_.RUnlock();
+  if (iterator.IsEnd() || comparator_((*iterator).first, key) != 0) {
     return this->End();
   } 
-  return INDEXITERATOR_TYPE(target_leaf, index, buffer_pool_manager_);
+  return iterator;
+}
+
+/*
+ * Input parameters are the bounds of a range, either may be null to leave that
+ * side open. The iterator stops at the end of the range, so a scan touches only
+ * the leaves holding keys in range.
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Scan(const KeyType *lower, bool lower_inclusive, const KeyType *upper,
+                                        bool upper_inclusive) {
+  tree_latch_.RLock();
+  if (IsEmpty()) {
+    tree_latch_.RUnlock();
+    return End();
+  }
+  Page *page;
+  int index = 0;
+  if (lower == nullptr) {
+    KeyType key{};
+    page = FindLeafPage(key, true);
+  } else {
+    page = LatchLeafPage(FindLeafPage(*lower, false), *lower, false);
+    index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(*lower, comparator_);
+    page->RUnlatch();
+  }
+  INDEXITERATOR_TYPE iterator(page, index, buffer_pool_manager_, this);
+  tree_latch_.RUnlock();
+  /*
+   * step over the lower key if it is excluded, or keys a split moved in before the iterator latched the leaf;
+   * the iterator takes the latch of the tree itself on every step
+   */
+  while (lower != nullptr && !iterator.IsEnd()) {
+    int result = comparator_((*iterator).first, *lower);
+    if (result > 0 || (result == 0 && lower_inclusive)) {
+      break;
+    }
+    ++iterator;
+  }
+  if (upper != nullptr) {
+    iterator.SetUpperBound(*upper, upper_inclusive);
+  }
+  return iterator;
+}
+
+/*
+ * Input parameter is void, find the last leaf page and construct an index
+ * iterator on its last pair, to move backward
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin() {
+  tree_latch_.RLock();
+  if (IsEmpty()) {
+    tree_latch_.RUnlock();
+    return End();
+  }
+  Page *page = FindLeafPageBefore(nullptr);
+  if (page == nullptr) {
+    tree_latch_.RUnlock();
+    return End();
+  }
+  LeafPage *target_leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = target_leaf->GetSize() - 1;
+  page->RUnlatch();
+  INDEXITERATOR_TYPE iterator(page, index, buffer_pool_manager_, this);
+  tree_latch_.RUnlock();
+  return iterator;
+}
+
+/*
+ * Input parameter is the upper key, construct an index iterator on the last
+ * pair before it, or on it if inclusive and the key is there
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &upper, bool inclusive) {
+  tree_latch_.RLock();
+  if (IsEmpty()) {
+    tree_latch_.RUnlock();
+    return End();
+  }
+  Page *page = LatchLeafPage(FindLeafPage(upper), upper, false);
+  LeafPage *target_leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = target_leaf->KeyIndex(upper, comparator_);
+  if (!inclusive || index == target_leaf->GetSize() || comparator_(target_leaf->KeyAt(index), upper) != 0) {
+    /*the last key before upper, in the leaf before if upper would be the first key of this one*/
+    index--;
+  }
+  if (index < 0) {
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(target_leaf->GetPageId(), false);
+    page = FindLeafPageBefore(&upper);
+    if (page == nullptr) {
+      tree_latch_.RUnlock();
+      return End();
+    }
+    target_leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    index = target_leaf->KeyIndex(upper, comparator_) - 1;
+  }
+  page->RUnlatch();
+  INDEXITERATOR_TYPE iterator(page, index, buffer_pool_manager_, this);
+  tree_latch_.RUnlock();
+  return iterator;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::REnd() {
+  return End();
 }
 
 /*
@@ -552,6 +962,14 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
  return INDEXITERATOR_TYPE(nullptr, 0, buffer_pool_manager_); 
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::IteratorAt(page_id_t leaf_page_id, int position) {
+  tree_latch_.RLock();
+  INDEXITERATOR_TYPE iterator(leaf_page_id, position, buffer_pool_manager_, this);
+  tree_latch_.RUnlock();
+  return iterator;
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
@@ -565,10 +983,13 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
     page_id_t target = root_page_id_;
     Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
     BPlusTreePage *bptp = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    /*one latch at a time, a child split meanwhile is caught by moving right at the leaves*/
     while (!bptp->IsLeafPage()) {
       InternalPage *internal_page = reinterpret_cast<InternalPage *>(bptp);
+      page->RLatch();
       target = leftMost ? internal_page->ValueAt(0) : internal_page->Lookup(key, comparator_);
-      buffer_pool_manager_->UnpinPage(bptp->GetPageId(), true);
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(bptp->GetPageId(), false);
       page = buffer_pool_manager_->FetchPage(target);
       bptp = reinterpret_cast<BPlusTreePage *>(page->GetData());
     }
@@ -576,6 +997,130 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
     return page;
 }
 
+/*
+ * Whether a key between lower and upper is in the tree, the tree being latched exclusive
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::HasKeyIn(const KeyType &lower, const KeyType &upper) {
+  LeafPage *leaf = reinterpret_cast<LeafPage *>(FindLeafPage(lower)->GetData());
+  int index = leaf->KeyIndex(lower, comparator_);
+  while (index == leaf->GetSize() && leaf->GetNextPageId() != INVALID_PAGE_ID) {
+    page_id_t next_page_id = leaf->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(next_page_id)->GetData());
+    index = 0;
+  }
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), upper) <= 0;
+  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+  return found;
+}
+
+/*
+ * Latch the leaf page found by FindLeafPage and move right while the key belongs to a later
+ * leaf: the first key of the next leaf is the high key of this one. A split that the parent
+ * did not show yet when we passed it is found this way.
+ * @return: the latched leaf page, still pinned
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::LatchLeafPage(Page *page, const KeyType &key, bool exclusive) {
+  exclusive ? page->WLatch() : page->RLatch();
+  while (true) {
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    page_id_t next_page_id = leaf->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID ||
+        (leaf->GetSize() > 0 && comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) <= 0)) {
+      return page;
+    }
+    /*latches are always taken left to right along the leaves*/
+    Page *next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    exclusive ? next_page->WLatch() : next_page->RLatch();
+    LeafPage *next_leaf = reinterpret_cast<LeafPage *>(next_page->GetData());
+    if (next_leaf->GetSize() == 0 || comparator_(key, next_leaf->KeyAt(0)) < 0) {
+      exclusive ? next_page->WUnlatch() : next_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(next_page_id, false);
+      return page;
+    }
+    exclusive ? page->WUnlatch() : page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    page = next_page;
+  }
+}
+
+/*
+ * Find the leaf page holding the last key before key, or the last leaf page if key is null.
+ * Every internal key is a lower bound of its child, so the child before the first internal key
+ * that is not before key holds it, unless the keys of that child all come after its lower bound:
+ * the search is then run again for the last key before the lower bound of the deepest child taken
+ * after the first one of its page. A split the parent did not show yet is caught by moving right.
+ * @return: the leaf page latched in read mode and pinned, nullptr if no key is before key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafPageBefore(const KeyType *key) {
+  KeyType bound;
+  while (true) {
+    bool bounded = false;
+    KeyType lower_bound;
+    Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+    BPlusTreePage *bptp = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    while (!bptp->IsLeafPage()) {
+      InternalPage *internal_page = reinterpret_cast<InternalPage *>(bptp);
+      page->RLatch();
+      int index = key == nullptr ? internal_page->GetSize() - 1 : internal_page->LookupBefore(*key, comparator_);
+      if (index > 0) {
+        bounded = true;
+        lower_bound = internal_page->KeyAt(index);
+      }
+      page_id_t target = internal_page->ValueAt(index);
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(bptp->GetPageId(), false);
+      page = buffer_pool_manager_->FetchPage(target);
+      bptp = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    }
+    page->RLatch();
+    page = MoveRightBefore(page, key);
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    if (leaf->GetSize() > 0 && (key == nullptr || comparator_(leaf->KeyAt(0), *key) < 0)) {
+      return page;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    if (!bounded) {
+      return nullptr;
+    }
+    /*the bound is before key, the search ends*/
+    bound = lower_bound;
+    key = &bound;
+  }
+}
+
+/*
+ * Move right from the leaf page latched in read mode while the next leaf starts before key,
+ * to the last leaf if key is null.
+ * @return: the leaf page latched in read mode, still pinned
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::MoveRightBefore(Page *page, const KeyType *key) {
+  while (true) {
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    page_id_t next_page_id = leaf->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      return page;
+    }
+    /*latches are always taken left to right along the leaves*/
+    Page *next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    next_page->RLatch();
+    LeafPage *next_leaf = reinterpret_cast<LeafPage *>(next_page->GetData());
+    if (next_leaf->GetSize() == 0 || (key != nullptr && comparator_(next_leaf->KeyAt(0), *key) >= 0)) {
+      next_page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(next_page_id, false);
+      return page;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    page = next_page;
+  }
+}
+
 /*
  * Update/Insert root page id in header page(where page_id = 0, header_page is
  * defined under include/page/header_page.h)
@@ -736,6 +1281,9 @@ bool BPLUSTREE_TYPE::Check() {
 template
 class BPlusTree<int, int, BasicComparator<int>>;
 
+template
+class BPlusTree<int, RowId, BasicComparator<int>>;
+
 template
 class BPlusTree<GenericKey<4>, RowId, GenericComparator<4>>;
 
@@ -745,8 +1293,20 @@ class BPlusTree<GenericKey<8>, RowId, GenericComparator<8>>;
 template
 class BPlusTree<GenericKey<16>, RowId, GenericComparator<16>>;
 
+template
+class BPlusTree<GenericKey<24>, RowId, GenericComparator<24>>;
+
 template
 class BPlusTree<GenericKey<32>, RowId, GenericComparator<32>>;
 
+template
+class BPlusTree<GenericKey<48>, RowId, GenericComparator<48>>;
+
 template
 class BPlusTree<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTree<GenericKey<96>, RowId, GenericComparator<96>>;
+
+template
+class BPlusTree<GenericKey<128>, RowId, GenericComparator<128>>;
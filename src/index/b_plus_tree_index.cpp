@@ -1,11 +1,113 @@
+#include <algorithm>
+
 #include "index/b_plus_tree_index.h"
+#include "index/basic_comparator.h"
 #include "index/generic_key.h"
 
+/*generic keys hold the whole key row in the encoding of KeyCodec*/
+template<size_t KeySize>
+static inline bool MakeIndexKey(const Row &key, Schema *key_schema, GenericKey<KeySize> &index_key) {
+  index_key.SerializeFromKey(key, key_schema);
+  return true;
+}
+
+/*int keys are the value of the single int column, null has no place among them and is not indexed*/
+static inline bool MakeIndexKey(const Row &key, Schema *, int32_t &index_key) {
+  Field *field = key.GetField(0);
+  if (field->IsNull()) {
+    return false;
+  }
+  char buf[sizeof(int32_t)];
+  field->SerializeTo(buf);
+  index_key = MACH_READ_INT32(buf);
+  return true;
+}
+
+/*a non-unique index appends the row id, so that the tree still holds every key once*/
+template<size_t KeySize>
+static inline bool MakeIndexKey(const Row &key, RowId row_id, Schema *key_schema, GenericKey<KeySize> &index_key) {
+  index_key.SerializeFromKey(key, row_id, key_schema);
+  return true;
+}
+
+static inline bool MakeIndexKey(const Row &, RowId, Schema *, int32_t &) {
+  ASSERT(false, "Int keys are for unique indexes only.");
+  return false;
+}
+
+/*the entries of a key lie between the bounds of it, the bytes after the key all 0x00 or all 0xFF*/
+template<size_t KeySize>
+static inline bool MakeBoundIndexKey(const Row &key, Schema *key_schema, bool low, GenericKey<KeySize> &index_key) {
+  index_key.SerializeBoundFromKey(key, key_schema, low);
+  return true;
+}
+
+static inline bool MakeBoundIndexKey(const Row &, Schema *, bool, int32_t &) {
+  ASSERT(false, "Int keys are the whole entry.");
+  return false;
+}
+
+/*the bound of the entries sharing the key columns of entry_key*/
+template<size_t KeySize>
+static inline void MakeBoundIndexKey(const GenericKey<KeySize> &entry_key, Schema *key_schema, bool low,
+                                     GenericKey<KeySize> &index_key) {
+  uint32_t size = KeyCodec::GetEncodedSize(entry_key.data, key_schema);
+  memcpy(index_key.data, entry_key.data, size);
+  memset(index_key.data + size, low ? 0 : 0xFF, KeySize - size);
+}
+
+static inline void MakeBoundIndexKey(const int32_t &, Schema *, bool, int32_t &) {
+  ASSERT(false, "Int keys are the whole entry.");
+}
+
+/*order by the key columns alone, no encoded key is a prefix of another*/
+template<size_t KeySize>
+static inline int CompareKeyColumns(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs,
+                                    Schema *key_schema) {
+  uint32_t size = std::min(KeyCodec::GetEncodedSize(lhs.data, key_schema),
+                           KeyCodec::GetEncodedSize(rhs.data, key_schema));
+  int result = memcmp(lhs.data, rhs.data, size);
+  return (result > 0) - (result < 0);
+}
+
+static inline int CompareKeyColumns(const int32_t &, const int32_t &, Schema *) {
+  ASSERT(false, "Int keys are the whole entry.");
+  return 0;
+}
+
+template<size_t KeySize>
+static inline void DecodeIndexKey(const GenericKey<KeySize> &index_key, Schema *entry_schema, Row &entry) {
+  index_key.DeserializeToKey(entry, entry_schema);
+}
+
+/*the row is filled by deserializing, the same way as KeyCodec::Decode does*/
+static inline void DecodeIndexKey(const int32_t &index_key, Schema *entry_schema, Row &entry) {
+  std::vector<Field> fields{Field(TypeId::kTypeInt, index_key)};
+  Row decoded(fields);
+  std::vector<char> buf(decoded.GetSerializedSize(entry_schema));
+  decoded.SerializeTo(buf.data(), entry_schema);
+  entry.DeserializeFrom(buf.data(), entry_schema);
+}
+
+/*null sorts first among generic keys, int keys hold no null*/
+template<size_t KeySize>
+static inline bool MakeMinNotNullKey(GenericKey<KeySize> &index_key) {
+  index_key.SetMinNotNull();
+  return true;
+}
+
+static inline bool MakeMinNotNullKey(int32_t &) {
+  return false;
+}
+
 /*To Update index_roots_page I add a parameter index_roots_page_id*/
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schema,
-                                     BufferPoolManager *buffer_pool_manager)
+                                     BufferPoolManager *buffer_pool_manager, bool unique,
+                                     IndexSchema *entry_schema)
         : Index(index_id, key_schema),
+          unique_(unique),
+          entry_schema_(entry_schema != nullptr ? entry_schema : key_schema),
           comparator_(key_schema_),
           container_(index_id, buffer_pool_manager, comparator_) {
 
@@ -15,9 +117,20 @@ INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transaction *txn) {
   ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
-
-  bool status = container_.Insert(index_key, row_id, txn);
+  if (!MakeEntryKey(key, row_id, index_key)) {
+    return DB_SUCCESS;
+  }
+  bool status;
+  if (unique_ && HasKeyPrefix()) {
+    /*entries differing in the include columns have different tree keys, the tree looks for any between the bounds*/
+    KeyType lower;
+    KeyType upper;
+    MakeBoundIndexKey(index_key, key_schema_, true, lower);
+    MakeBoundIndexKey(index_key, key_schema_, false, upper);
+    status = container_.Insert(index_key, row_id, txn, &lower, &upper);
+  } else {
+    status = container_.Insert(index_key, row_id, txn);
+  }
 
   if (!status) {
     return DB_FAILED;
@@ -28,7 +141,9 @@ dberr_t BPLUSTREE_INDEX_TYPE::InsertEntry(const Row &key, RowId row_id, Transact
 INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::RemoveEntry(const Row &key, RowId row_id, Transaction *txn) {
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  if (!MakeEntryKey(key, row_id, index_key)) {
+    return DB_SUCCESS;
+  }
 
   container_.Remove(index_key, txn);
   return DB_SUCCESS;
@@ -38,8 +153,29 @@ INDEX_TEMPLATE_ARGUMENTS
 dberr_t BPLUSTREE_INDEX_TYPE::ScanKey(const Row &key, vector<RowId> &result, int &position, page_id_t& leaf_page_id, Transaction *txn) {
   /*position is first index in leaf page which [position].key>=key*/
   /*leaf_page_id is the leaf page id for constructor of iterator*/
+  if (HasKeyPrefix()) {
+    /*the entries of key lie between its bounds, whatever row id or include columns follow it*/
+    KeyType lower;
+    KeyType upper;
+    MakeBoundIndexKey(key, key_schema_, true, lower);
+    MakeBoundIndexKey(key, key_schema_, false, upper);
+    std::vector<RowId> lower_result;
+    leaf_page_id = INVALID_PAGE_ID;
+    container_.GetValue(lower, lower_result, position, leaf_page_id, txn);
+    if (leaf_page_id == INVALID_PAGE_ID) {
+      return DB_KEY_NOT_FOUND;
+    }
+    size_t size = result.size();
+    for (auto iterator = container_.IteratorAt(leaf_page_id, position);
+         !iterator.IsEnd() && comparator_((*iterator).first, upper) <= 0; ++iterator) {
+      result.push_back((*iterator).second);
+    }
+    return result.size() > size ? DB_SUCCESS : DB_KEY_NOT_FOUND;
+  }
   KeyType index_key;
-  index_key.SerializeFromKey(key, key_schema_);
+  if (!MakeIndexKey(key, key_schema_, index_key)) {
+    return DB_KEY_NOT_FOUND;
+  }
   if (container_.GetValue(index_key, result, position, leaf_page_id, txn)) {
     return DB_SUCCESS;
   }
@@ -52,6 +188,102 @@ dberr_t BPLUSTREE_INDEX_TYPE::Destroy() {
   return DB_SUCCESS;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+std::unique_ptr<IndexCursor> BPLUSTREE_INDEX_TYPE::GetBeginCursor() {
+  return std::unique_ptr<IndexCursor>(new Cursor(container_.Begin(), entry_schema_));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::unique_ptr<IndexCursor> BPLUSTREE_INDEX_TYPE::GetCursor(page_id_t leaf_page_id, int position) {
+  INDEXITERATOR_TYPE iterator = container_.IteratorAt(leaf_page_id, position);
+  return std::unique_ptr<IndexCursor>(new Cursor(iterator, entry_schema_));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::unique_ptr<IndexCursor> BPLUSTREE_INDEX_TYPE::Scan(const Row *lower, bool lower_inclusive, const Row *upper,
+                                                        bool upper_inclusive) {
+  KeyType lower_key;
+  KeyType upper_key;
+  if ((lower != nullptr && !MakeBoundKey(*lower, true, lower_inclusive, lower_key)) ||
+      (upper != nullptr && !MakeBoundKey(*upper, false, upper_inclusive, upper_key))) {
+    return std::unique_ptr<IndexCursor>(new Cursor(container_.End(), entry_schema_));
+  }
+  const KeyType *lower_bound = lower != nullptr ? &lower_key : nullptr;
+  if (lower == nullptr && MakeMinNotNullKey(lower_key)) {
+    lower_bound = &lower_key;
+    lower_inclusive = true;
+  }
+  INDEXITERATOR_TYPE iterator = container_.Scan(lower_bound, lower_inclusive, upper != nullptr ? &upper_key : nullptr,
+                                                upper_inclusive);
+  return std::unique_ptr<IndexCursor>(new Cursor(iterator, entry_schema_));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::Cursor::GetEntry(Row &entry) {
+  DecodeIndexKey((*iterator_).first, entry_schema_, entry);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+std::unique_ptr<IndexBuilder> BPLUSTREE_INDEX_TYPE::GetBuilder(double fill_factor) {
+  return std::unique_ptr<IndexBuilder>(new Builder(this, fill_factor));
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::Builder::Add(const Row &key, RowId row_id) {
+  ASSERT(row_id.Get() != INVALID_ROWID.Get(), "Invalid row id for index insert.");
+  KeyType index_key;
+  if (index_->MakeEntryKey(key, row_id, index_key)) {
+    entries_.emplace_back(index_key, row_id);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+dberr_t BPLUSTREE_INDEX_TYPE::Builder::Finish(Transaction *) {
+  const KeyComparator &comparator = index_->comparator_;
+  /*
+   * a unique index with include columns keeps one entry per key columns, they order the entries alone then;
+   * with one entry left per key the entries are in the order of the tree as well
+   */
+  Schema *key_schema = index_->unique_ && index_->HasKeyPrefix() ? index_->key_schema_ : nullptr;
+  auto compare = [&comparator, key_schema](const MappingType &lhs, const MappingType &rhs) {
+    return key_schema != nullptr ? CompareKeyColumns(lhs.first, rhs.first, key_schema)
+                                 : comparator(lhs.first, rhs.first);
+  };
+  /*stable, so that the first entry of a key is the one kept, as inserting one by one would*/
+  std::stable_sort(entries_.begin(), entries_.end(), [&compare](const MappingType &lhs, const MappingType &rhs) {
+    return compare(lhs, rhs) < 0;
+  });
+  auto last = std::unique(entries_.begin(), entries_.end(), [&compare](const MappingType &lhs, const MappingType &rhs) {
+    return compare(lhs, rhs) == 0;
+  });
+  entries_.erase(last, entries_.end());
+  if (!index_->container_.BulkLoad(entries_, fill_factor_)) {
+    return DB_FAILED;
+  }
+  entries_.clear();
+  return DB_SUCCESS;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::MakeEntryKey(const Row &key, RowId row_id, KeyType &index_key) const {
+  if (unique_) {
+    return MakeIndexKey(key, entry_schema_, index_key);
+  }
+  return MakeIndexKey(key, row_id, entry_schema_, index_key);
+}
+
+/*
+ * the entries of a key are ordered by what follows it: an inclusive bound lies before the first of them
+ * on the lower side and after the last on the upper side, an exclusive one the other way round
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_INDEX_TYPE::MakeBoundKey(const Row &key, bool lower, bool inclusive, KeyType &index_key) const {
+  if (!HasKeyPrefix()) {
+    return MakeIndexKey(key, key_schema_, index_key);
+  }
+  return MakeBoundIndexKey(key, key_schema_, lower == inclusive, index_key);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() {
   return container_.Begin();
@@ -68,6 +300,14 @@ INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() {
   return container_.End();
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetRBeginIterator() {
+  return container_.RBegin();
+}
+
+template
+class BPlusTreeIndex<int, RowId, BasicComparator<int>>;
+
 template
 class BPlusTreeIndex<GenericKey<4>, RowId, GenericComparator<4>>;
 
@@ -77,8 +317,20 @@ class BPlusTreeIndex<GenericKey<8>, RowId, GenericComparator<8>>;
 template
 class BPlusTreeIndex<GenericKey<16>, RowId, GenericComparator<16>>;
 
+template
+class BPlusTreeIndex<GenericKey<24>, RowId, GenericComparator<24>>;
+
 template
 class BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeIndex<GenericKey<48>, RowId, GenericComparator<48>>;
+
+template
+class BPlusTreeIndex<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeIndex<GenericKey<96>, RowId, GenericComparator<96>>;
+
+template
+class BPlusTreeIndex<GenericKey<128>, RowId, GenericComparator<128>>;
\ No newline at end of file
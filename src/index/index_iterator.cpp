@@ -1,49 +1,187 @@
 #include "index/basic_comparator.h"
+#include "index/b_plus_tree.h"
 #include "index/generic_key.h"
 #include "index/index_iterator.h"
 
-INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(LeafPage *target_leaf, int index,
-                                                           BufferPoolManager *buffer_pool_manager):target_leaf_(target_leaf),index_(index),buffer_pool_manager_(buffer_pool_manager) {
-
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(Page *page, int index,
+                                                           BufferPoolManager *buffer_pool_manager, Tree *tree)
+    : page_(page), index_(index), buffer_pool_manager_(buffer_pool_manager), tree_(tree),
+      structure_version_(0), bounded_(false), upper_inclusive_(false), upper_() {
+  Load(false);
 }
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(page_id_t leaf_page, int position,
-                                                           BufferPoolManager *buffer_pool_manager)
-    : target_leaf_(nullptr), index_(position), buffer_pool_manager_(buffer_pool_manager) {
-  target_leaf_ = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(leaf_page)->GetData());
+                                                           BufferPoolManager *buffer_pool_manager, Tree *tree)
+    : page_(nullptr), index_(position), buffer_pool_manager_(buffer_pool_manager), tree_(tree),
+      structure_version_(0), bounded_(false), upper_inclusive_(false), upper_() {
+  page_ = buffer_pool_manager_->FetchPage(leaf_page);
+  Load(false);
+}
+
+/*a copy holds its own pin on the leaf*/
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(const IndexIterator &other)
+    : page_(other.page_), index_(other.index_), buffer_pool_manager_(other.buffer_pool_manager_),
+      tree_(other.tree_), structure_version_(other.structure_version_), item_(other.item_),
+      bounded_(other.bounded_), upper_inclusive_(other.upper_inclusive_), upper_(other.upper_) {
+  if (page_ != nullptr) {
+    buffer_pool_manager_->FetchPage(page_->GetPageId());
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::~IndexIterator() {
-  buffer_pool_manager_->UnpinPage(target_leaf_->GetPageId(), true);
+  /*the end iterator holds no page*/
+  if (page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(const IndexIterator &other) {
+  if (this == &other) {
+    return *this;
+  }
+  if (other.page_ != nullptr) {
+    other.buffer_pool_manager_->FetchPage(other.page_->GetPageId());
+  }
+  if (page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+  }
+  page_ = other.page_;
+  index_ = other.index_;
+  buffer_pool_manager_ = other.buffer_pool_manager_;
+  tree_ = other.tree_;
+  structure_version_ = other.structure_version_;
+  item_ = other.item_;
+  bounded_ = other.bounded_;
+  upper_inclusive_ = other.upper_inclusive_;
+  upper_ = other.upper_;
+  return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS const MappingType &INDEXITERATOR_TYPE::operator*() { 
-  return target_leaf_->GetItem(index_); 
+  return item_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
-  if (index_ < target_leaf_->GetSize()-1){
+  /*past the end there is nothing to move to*/
+  if (page_ == nullptr) {
+    return *this;
+  }
+  if (tree_ == nullptr) {
     index_++;
-  } else {
-    /*find the next leaf*/
-    if (target_leaf_->GetNextPageId() != INVALID_PAGE_ID) {
-      LeafPage* next_leaf = reinterpret_cast<LeafPage *>(buffer_pool_manager_->FetchPage(target_leaf_->GetNextPageId())->GetData());
-      buffer_pool_manager_->UnpinPage(target_leaf_->GetPageId(),true);
-      target_leaf_ = next_leaf;
-      index_ = 0;
-    } else {
-      /*no next leaf*/
-      buffer_pool_manager_->UnpinPage(target_leaf_->GetPageId(),true);
-      target_leaf_=nullptr;
+    Load(false);
+    return *this;
+  }
+  tree_->tree_latch_.RLock();
+  if (structure_version_ != tree_->structure_version_) {
+    /*the tree was latched exclusively since the last step, pages may be merged: find the leaf of the last key again*/
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = tree_->FindLeafPage(item_.first);
+  }
+  Load(true);
+  tree_->tree_latch_.RUnlock();
+  CheckUpperBound();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator--() {
+  if (page_ == nullptr) {
+    return *this;
+  }
+  ASSERT(tree_ != nullptr, "Only iterators of a tree move backward.");
+  tree_->tree_latch_.RLock();
+  if (structure_version_ != tree_->structure_version_) {
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = tree_->FindLeafPage(item_.first);
+  }
+  page_->RLatch();
+  /*keys before item_ may have moved to a new right sibling in a split since the last step*/
+  page_ = tree_->MoveRightBefore(page_, &item_.first);
+  index_ = Leaf()->KeyIndex(item_.first, tree_->comparator_) - 1;
+  if (index_ < 0) {
+    /*no link leads to the leaf before, find it from the root*/
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = tree_->FindLeafPageBefore(&item_.first);
+    if (page_ == nullptr) {
       index_ = 0;
+      tree_->tree_latch_.RUnlock();
+      return *this;
     }
+    index_ = Leaf()->KeyIndex(item_.first, tree_->comparator_) - 1;
   }
+  item_ = Leaf()->GetItem(index_);
+  structure_version_ = tree_->structure_version_;
+  page_->RUnlatch();
+  tree_->tree_latch_.RUnlock();
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS void INDEXITERATOR_TYPE::Load(bool after_item) {
+  if (page_ == nullptr) {
+    return;
+  }
+  page_->RLatch();
+  /*the first key after item_, a split may have moved keys we returned already to the next leaf*/
+  auto after = [this]() {
+    int index = Leaf()->KeyIndex(item_.first, tree_->comparator_);
+    if (index < Leaf()->GetSize() && tree_->comparator_(Leaf()->KeyAt(index), item_.first) == 0) {
+      index++;
+    }
+    return index;
+  };
+  if (after_item) {
+    index_ = after();
+  }
+  while (index_ >= Leaf()->GetSize()) {
+    /*find the next leaf, latched before the current one is released*/
+    page_id_t next_page_id = Leaf()->GetNextPageId();
+    if (next_page_id == INVALID_PAGE_ID) {
+      /*no next leaf*/
+      page_->RUnlatch();
+      Finish();
+      return;
+    }
+    Page *next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    next_page->RLatch();
+    page_->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = next_page;
+    index_ = after_item ? after() : 0;
+  }
+  item_ = Leaf()->GetItem(index_);
+  if (tree_ != nullptr) {
+    structure_version_ = tree_->structure_version_;
+  }
+  page_->RUnlatch();
+}
+
+INDEX_TEMPLATE_ARGUMENTS void INDEXITERATOR_TYPE::SetUpperBound(const KeyType &upper, bool inclusive) {
+  bounded_ = true;
+  upper_inclusive_ = inclusive;
+  upper_ = upper;
+  CheckUpperBound();
+}
+
+INDEX_TEMPLATE_ARGUMENTS void INDEXITERATOR_TYPE::CheckUpperBound() {
+  if (!bounded_ || page_ == nullptr) {
+    return;
+  }
+  int result = tree_->comparator_(item_.first, upper_);
+  if (result < 0 || (result == 0 && upper_inclusive_)) {
+    return;
+  }
+  Finish();
+}
+
+INDEX_TEMPLATE_ARGUMENTS void INDEXITERATOR_TYPE::Finish() {
+  buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+  page_ = nullptr;
+  index_ = 0;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const {
-  return (itr.target_leaf_ == target_leaf_) && (itr.index_ == index_);
+  return (itr.page_ == page_) && (itr.index_ == index_);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -54,6 +192,9 @@ bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const {
 template
 class IndexIterator<int, int, BasicComparator<int>>;
 
+template
+class IndexIterator<int, RowId, BasicComparator<int>>;
+
 template
 class IndexIterator<GenericKey<4>, RowId, GenericComparator<4>>;
 
@@ -63,8 +204,20 @@ class IndexIterator<GenericKey<8>, RowId, GenericComparator<8>>;
 template
 class IndexIterator<GenericKey<16>, RowId, GenericComparator<16>>;
 
+template
+class IndexIterator<GenericKey<24>, RowId, GenericComparator<24>>;
+
 template
 class IndexIterator<GenericKey<32>, RowId, GenericComparator<32>>;
 
+template
+class IndexIterator<GenericKey<48>, RowId, GenericComparator<48>>;
+
 template
 class IndexIterator<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class IndexIterator<GenericKey<96>, RowId, GenericComparator<96>>;
+
+template
+class IndexIterator<GenericKey<128>, RowId, GenericComparator<128>>;
@@ -0,0 +1,153 @@
+#include <cstring>
+#include <string>
+
+#include "index/key_codec.h"
+
+uint32_t KeyCodec::Encode(const Row &key, Schema *key_schema, char *buf, uint32_t size) {
+  ASSERT(key.GetFieldCount() == key_schema->GetColumnCount(), "field nums not match.");
+  char *begin = buf;
+  char *end = buf + size;
+  char value[sizeof(uint32_t)];
+  for (uint32_t i = 0; i < key.GetFieldCount(); i++) {
+    Field *field = key.GetField(i);
+    if (buf == end) {
+      return 0;
+    }
+    if (field->IsNull()) {
+      *buf++ = 0;
+      continue;
+    }
+    *buf++ = NOT_NULL;
+    switch (key_schema->GetColumn(i)->GetType()) {
+      case TypeId::kTypeInt: {
+        if (end - buf < static_cast<ptrdiff_t>(sizeof(uint32_t))) {
+          return 0;
+        }
+        field->SerializeTo(value);
+        WriteBigEndian(buf, static_cast<uint32_t>(MACH_READ_INT32(value)) ^ SIGN_BIT);
+        buf += sizeof(uint32_t);
+        break;
+      }
+      case TypeId::kTypeFloat: {
+        if (end - buf < static_cast<ptrdiff_t>(sizeof(uint32_t))) {
+          return 0;
+        }
+        field->SerializeTo(value);
+        float f = MACH_READ_FROM(float, value);
+        /*-0.0 and 0.0 are equal, give them the same bits*/
+        if (f == 0.0f) {
+          f = 0.0f;
+        }
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(uint32_t));
+        WriteBigEndian(buf, (bits & SIGN_BIT) ? ~bits : (bits ^ SIGN_BIT));
+        buf += sizeof(uint32_t);
+        break;
+      }
+      case TypeId::kTypeChar: {
+        const char *chars = field->GetData();
+        uint32_t len = field->GetLength();
+        for (uint32_t j = 0; j < len; j++) {
+          if (buf == end) {
+            return 0;
+          }
+          *buf++ = chars[j];
+          if (chars[j] == 0) {
+            if (buf == end) {
+              return 0;
+            }
+            *buf++ = CHAR_ESCAPE;
+          }
+        }
+        if (end - buf < 2) {
+          return 0;
+        }
+        *buf++ = 0;
+        *buf++ = 0;
+        break;
+      }
+      default:
+        ASSERT(false, "Unsupported key type.");
+        return 0;
+    }
+  }
+  return buf - begin;
+}
+
+void KeyCodec::Decode(const char *buf, Schema *key_schema, Row &key) {
+  std::vector<Field> fields;
+  fields.reserve(key_schema->GetColumnCount());
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    TypeId type = key_schema->GetColumn(i)->GetType();
+    if (*buf++ == 0) {
+      fields.emplace_back(type);
+      continue;
+    }
+    switch (type) {
+      case TypeId::kTypeInt:
+        fields.emplace_back(type, static_cast<int32_t>(ReadBigEndian(buf) ^ SIGN_BIT));
+        buf += sizeof(uint32_t);
+        break;
+      case TypeId::kTypeFloat: {
+        uint32_t bits = ReadBigEndian(buf);
+        bits = (bits & SIGN_BIT) ? (bits ^ SIGN_BIT) : ~bits;
+        float f;
+        memcpy(&f, &bits, sizeof(float));
+        fields.emplace_back(type, f);
+        buf += sizeof(uint32_t);
+        break;
+      }
+      case TypeId::kTypeChar: {
+        std::string chars;
+        while (buf[0] != 0 || buf[1] != 0) {
+          chars.push_back(buf[0]);
+          /*an escaped 0x00 takes two bytes*/
+          buf += buf[0] == 0 ? 2 : 1;
+        }
+        buf += 2;
+        fields.emplace_back(type, &chars[0], chars.size(), true);
+        break;
+      }
+      default:
+        ASSERT(false, "Unsupported key type.");
+        return;
+    }
+  }
+  /*go through the row format, the key row may only be filled by deserializing*/
+  Row decoded(fields);
+  std::vector<char> row_buf(decoded.GetSerializedSize(key_schema));
+  decoded.SerializeTo(row_buf.data(), key_schema);
+  key.DeserializeFrom(row_buf.data(), key_schema);
+}
+
+uint32_t KeyCodec::GetEncodedSize(const char *buf, Schema *key_schema) {
+  const char *begin = buf;
+  for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+    if (*buf++ == 0) {
+      continue;
+    }
+    if (key_schema->GetColumn(i)->GetType() == TypeId::kTypeChar) {
+      while (buf[0] != 0 || buf[1] != 0) {
+        buf += buf[0] == 0 ? 2 : 1;
+      }
+      buf += 2;
+    } else {
+      buf += sizeof(uint32_t);
+    }
+  }
+  return buf - begin;
+}
+
+uint32_t KeyCodec::GetMaxEncodedSize(const Schema *key_schema) {
+  uint32_t size = 0;
+  for (auto column : key_schema->GetColumns()) {
+    /*null byte*/
+    size += 1;
+    if (column->GetType() == TypeId::kTypeChar) {
+      size += column->GetLength() + 2;
+    } else {
+      size += Type::GetTypeSize(column->GetType());
+    }
+  }
+  return size;
+}
@@ -18,6 +18,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
   SetMaxSize(max_size);
   SetSize(0);
   SetPageType(IndexPageType::INTERNAL_PAGE);
+  array_.Init(PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE);
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
@@ -26,18 +27,17 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
  */
 INDEX_TEMPLATE_ARGUMENTS
 KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const { 
-  return array_[index].first;
+  return array_.KeyAt(index);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { 
-  array_[index].first = key; 
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { 
+  return array_.SetKeyAt(GetSize(), index, key);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) { 
-  array_[index].second = value; 
-
+  array_.SetValueAt(index, value);
 }
     /*
  * Helper method to find and return array index(or offset), so that its value
@@ -48,7 +48,7 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
   /*notice: Value has no order, so linear search*/
   int ret_index = -1;
   for (int i = 0; i < GetSize(); i++) {
-    if (array_[i].second == value) {
+    if (array_.ValueAt(i) == value) {
       ret_index = i;
       break;
     }
@@ -62,7 +62,36 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { 
-  return array_[index].second; 
+  return array_.ValueAt(index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(const KeyType &key) const {
+  return GetSize() < GetMaxSize() && array_.HasRoom(GetSize(), key);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomForAnyKey() const {
+  return GetSize() < GetMaxSize() && array_.HasRoomForAny(GetSize());
+}
+
+/*
+ * A page just split is about half full, the third leaves room for removes before it counts as underflow
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsUnderflow() const {
+  return GetSize() < GetMinSize() && array_.UsedBytes(GetSize()) < array_.GetCapacity() / 3;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanMergeWith(const BPlusTreeInternalPage *next) const {
+  if (GetSize() + next->GetSize() > GetMaxSize()) {
+    return false;
+  }
+  std::vector<MappingType> items = array_.Items(GetSize());
+  std::vector<MappingType> next_items = next->array_.Items(next->GetSize());
+  items.insert(items.end(), next_items.begin(), next_items.end());
+  return PrefixKeyArray<KeyType, ValueType>::PackedSize(items.data(), items.size()) <= array_.GetCapacity();
 }
 
 /*****************************************************************************
@@ -77,21 +106,20 @@ INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const { 
   /*notice: key has an order: binary search*/
   /*we need to find the first element > key*/
-  /*suppose we always keep the minimum key in array_[0].first*/
-  int left = 0;
-  int right = GetSize();
-  int mid = -1;
-
-  while (left < right) {
-    mid = (left + right) / 2;
-    if (comparator(key, array_[mid].first) >= 0) {
-      left = mid + 1;
-    } else {
-      right = mid;
-    }
-  }
-  if (left == 0) return array_[0].second;
-  return array_[left - 1].second;
+  /*suppose we always keep a lower bound of the subtree in array_[0].first*/
+  auto probe = array_.MakeProbe(key);
+  int left = KeyUpperBound(GetSize(), [&](int index) { return array_.Compare(index, probe, comparator); });
+  if (left == 0) return array_.ValueAt(0);
+  return array_.ValueAt(left - 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::LookupBefore(const KeyType &key, const KeyComparator &comparator) const {
+  /*the keys are lower bounds of the children, the child before the first key >= key starts before key*/
+  auto probe = array_.MakeProbe(key);
+  int left = KeyLowerBound(GetSize(), [&](int index) { return array_.Compare(index, probe, comparator); });
+  if (left == 0) return 0;
+  return left - 1;
 }
 
 /*****************************************************************************
@@ -120,28 +148,39 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value,
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
                                                     const ValueType &new_value) {
-  /*find the index*/
+  /*find the index, the caller makes sure the page has room for new_key*/
   int old_index = ValueIndex(old_value);
-  for (int i = GetSize(); i > old_index + 1; i--) {
-    array_[i] = array_[i - 1];
-  }
-  array_[old_index + 1] = MappingType(new_key, new_value);
+  array_.Insert(GetSize(), old_index + 1, new_key, new_value);
   SetSize(GetSize() + 1);
   return GetSize();
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  array_.Insert(GetSize(), GetSize(), key, value);
+  IncreaseSize(1);
+}
+
 /*****************************************************************************
  * SPLIT
  *****************************************************************************/
 /*
- * Remove half of key & value pairs from this page to "recipient" page
+ * Insert new_key & new_value after old_value into the page without room for
+ * them, then remove the pairs after the split point to "recipient" page
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage* recipient,
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient, const ValueType &old_value,
+                                                const KeyType &new_key, const ValueType &new_value,
                                                 BufferPoolManager *buffer_pool_manager) {
-  /*here I always use this function when there are maxsize+1 elements*/ 
-  recipient->CopyNFrom(&array_[GetMinSize()], GetMaxSize() - GetMinSize() + 1, buffer_pool_manager);
-  SetSize(GetMinSize());
+  int index = ValueIndex(old_value) + 1;
+  std::vector<MappingType> items = array_.Items(GetSize());
+  items.insert(items.begin() + index, MappingType(new_key, new_value));
+  /*no child goes alone to the new page, a page without siblings could not merge when it underflows*/
+  int split = PrefixKeyArray<KeyType, ValueType>::SplitPoint(items, -1, array_.GetCapacity(), GetMaxSize(),
+                                                             GetMinSize());
+  array_.Assign(items.data(), split);
+  SetSize(split);
+  recipient->CopyNFrom(items.data() + split, items.size() - split, buffer_pool_manager);
 }
 
 /* Copy entries into me, starting from {items} and copy {size} entries.
@@ -149,15 +188,16 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage* recipient
  * So I need to 'adopt' them by changing their parent page id, which needs to be persisted with BufferPoolManger
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
-  /*always call this function when array is empty*/
-  for (int i = 0; i < size; i++) {
-    array_[i] = items[i];
-  }
-  SetSize(size);
-  /*adopt all the children*/
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(const MappingType *items, int size,
+                                               BufferPoolManager *buffer_pool_manager) {
+  /*items are appended after the current ones, the caller makes sure they fit*/
+  std::vector<MappingType> all = array_.Items(GetSize());
+  all.insert(all.end(), items, items + size);
+  array_.Assign(all.data(), all.size());
+  IncreaseSize(size);
+  /*adopt the new children*/
   for (int i = 0; i < size; i++) {
-    BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager->FetchPage(ValueAt(i))->GetData());
+    BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager->FetchPage(items[i].second)->GetData());
     page->SetParentPageId(GetPageId());
     buffer_pool_manager->UnpinPage(page->GetPageId(),true);
   }
@@ -173,9 +213,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, Buf
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
-  for (int i = index; i < GetSize()-1; i++) {
-    array_[i] = array_[i + 1];
-  }
+  array_.Remove(GetSize(), index);
   SetSize(GetSize() - 1);
 }
 
@@ -203,19 +241,13 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                BufferPoolManager *buffer_pool_manager) {
-  /*we always assume recipient is the previous sibling of this node*/
+  /*we always assume recipient is the previous sibling of this node, with room for all pairs*/
   /*we don't need middle_key because we store the key in array[0].first*/
-  for (int i = 0; i < GetSize(); i++) {
-    recipient->array_[i + recipient->GetSize()] = array_[i];
-  }
   /*recipient will adopt all the children*/
-  for (int i = 0; i < GetSize(); i++) {
-    BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(
-        buffer_pool_manager->FetchPage(recipient->ValueAt(i + recipient->GetSize()))->GetData());
-    page->SetParentPageId(recipient->GetPageId());
-    buffer_pool_manager->UnpinPage(page->GetPageId(), true);
-  }
-  recipient->SetSize(recipient->GetSize() + GetSize());
+  std::vector<MappingType> items = array_.Items(GetSize());
+  recipient->CopyNFrom(items.data(), items.size(), buffer_pool_manager);
+  array_.Init(array_.GetCapacity());
+  SetSize(0);
 }
 
 /*****************************************************************************
@@ -233,17 +265,8 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                       BufferPoolManager *buffer_pool_manager) {
   /*the same as Move all, we have maintain the value in array[0].first*/
-  recipient->array_[recipient->GetSize()] = array_[0];
-  recipient->SetSize(recipient->GetSize() + 1);
-  for (int i = 0; i < GetSize() - 1; i++) {
-    array_[i] = array_[i + 1];
-  }
-  SetSize(GetSize() - 1);
-  /*adopt the child*/
-  BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(
-      buffer_pool_manager->FetchPage(recipient->array_[recipient->GetSize() - 1].second)->GetData());
-  page->SetParentPageId(recipient->GetPageId());
-  buffer_pool_manager->UnpinPage(page->GetPageId(), true);
+  recipient->CopyLastFrom(array_.ItemAt(0), buffer_pool_manager);
+  Remove(0);
 }
 
 /* Append an entry at the end.
@@ -252,7 +275,10 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *rec
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
-
+  Append(pair.first, pair.second);
+  BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager->FetchPage(pair.second)->GetData());
+  page->SetParentPageId(GetPageId());
+  buffer_pool_manager->UnpinPage(page->GetPageId(), true);
 }
 
 /*
@@ -265,17 +291,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, Buffe
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                       BufferPoolManager *buffer_pool_manager) {
-  for (int i = recipient->GetSize(); i > 0; i--) {
-    recipient->array_[i] = recipient->array_[i - 1];
-  }
-  recipient->array_[0] = array_[GetSize() - 1];
-  recipient->SetSize(recipient->GetSize() + 1);
-  SetSize(GetSize() - 1);
-  /*adopt the child*/
-  BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(
-      buffer_pool_manager->FetchPage(recipient->array_[0].second)->GetData());
-  page->SetParentPageId(recipient->GetPageId());
-  buffer_pool_manager->UnpinPage(page->GetPageId(), true);
+  recipient->CopyFirstFrom(array_.ItemAt(GetSize() - 1), buffer_pool_manager);
+  Remove(GetSize() - 1);
 }
 
 /* Append an entry at the beginning.
@@ -284,7 +301,11 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *re
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
-
+  array_.Insert(GetSize(), 0, pair.first, pair.second);
+  IncreaseSize(1);
+  BPlusTreePage *page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager->FetchPage(pair.second)->GetData());
+  page->SetParentPageId(GetPageId());
+  buffer_pool_manager->UnpinPage(page->GetPageId(), true);
 }
 
 template
@@ -299,8 +320,20 @@ class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
 template
 class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 
+template
+class BPlusTreeInternalPage<GenericKey<24>, page_id_t, GenericComparator<24>>;
+
 template
 class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 
 template
-class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeInternalPage<GenericKey<48>, page_id_t, GenericComparator<48>>;
+
+template
+class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+template
+class BPlusTreeInternalPage<GenericKey<96>, page_id_t, GenericComparator<96>>;
+
+template
+class BPlusTreeInternalPage<GenericKey<128>, page_id_t, GenericComparator<128>>;
\ No newline at end of file
@@ -20,6 +20,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, in
   SetSize(0);
   SetNextPageId(INVALID_PAGE_ID);
   SetPageType(IndexPageType::LEAF_PAGE);
+  array_.Init(PAGE_SIZE - LEAF_PAGE_HEADER_SIZE);
 }
 /**
  * Helper methods to set/get next page id
@@ -40,19 +41,10 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  int left = 0;
-  int right = GetSize();
-  /*find first key that array_[i].first>=key, the result will be store in left*/
-  while (left < right) {
-    int mid = (left + right) / 2;
-    if (comparator(key, array_[mid].first) > 0) {
-      left = mid + 1;
-    } else {
-      right = mid;
-    }
-  }
-  return left;
-  //if left== getsize(),it means all element in array_< key
+  /*find first key that array_[i].first>=key*/
+  auto probe = array_.MakeProbe(key);
+  return KeyLowerBound(GetSize(), [&](int index) { return array_.Compare(index, probe, comparator); });
+  //if the result == getsize(),it means all element in array_< key
 }
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
@@ -60,7 +52,7 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator
  */
 INDEX_TEMPLATE_ARGUMENTS
 KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
-  return array_[index].first;
+  return array_.KeyAt(index);
 }
 
 /*
@@ -68,9 +60,32 @@ KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
  * "index"(a.k.a array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
-  
-  return array_[index];
+MappingType B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const {
+  return array_.ItemAt(index);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(const KeyType &key) const {
+  return GetSize() < GetMaxSize() && array_.HasRoom(GetSize(), key);
+}
+
+/*
+ * A page just split is about half full, the third leaves room for removes before it counts as underflow
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsUnderflow() const {
+  return GetSize() < GetMinSize() && array_.UsedBytes(GetSize()) < array_.GetCapacity() / 3;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::CanMergeWith(const BPlusTreeLeafPage *next) const {
+  if (GetSize() + next->GetSize() > GetMaxSize()) {
+    return false;
+  }
+  std::vector<MappingType> items = array_.Items(GetSize());
+  std::vector<MappingType> next_items = next->array_.Items(next->GetSize());
+  items.insert(items.end(), next_items.begin(), next_items.end());
+  return PrefixKeyArray<KeyType, ValueType>::PackedSize(items.data(), items.size()) <= array_.GetCapacity();
 }
 
 /*****************************************************************************
@@ -82,36 +97,14 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
-  /*if (GetSize() == GetMaxSize()) {
-    LOG(WARNING) << "Insert into leaf page while the size is maxsize" << std::endl;
-    return GetSize();
-  }*/
-
-  /*before insertion, caller should make sure the size is less than maxsize*/
-  /*we will find the first element greater than key*/
-  int left = 0;
-  int right = GetSize();
-  int mid = -1;
-
-  while (left < right) {
-    mid = (left + right) / 2;
-    if (comparator(key, array_[mid].first) > 0) {
-      left = mid + 1;
-    } else {
-      right = mid;
-    }
-  }
-  /*the value in left is the result*/
-  if (left != GetSize() && comparator(key, array_[left].first) == 0) {
+  /*before insertion, caller should make sure the page has room for key*/
+  /*we will find the first element not less than key*/
+  int index = KeyIndex(key, comparator);
+  if (index != GetSize() && comparator(key, array_.KeyAt(index)) == 0) {
     LOG(WARNING) << "Insert duplicated keys!" << std::endl;
     return -1;
   }
-  /*move the element*/
-  for (int i = GetSize() - 1; i >= left; i--) {
-    array_[i + 1] = array_[i];
-  }
-
-  array_[left] = MappingType(key, value);
+  array_.Insert(GetSize(), index, key, value);
   SetSize(GetSize() + 1);
   return GetSize();
 }
@@ -120,31 +113,37 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
  * SPLIT
  *****************************************************************************/
 /*
- * Remove half of key & value pairs from this page to "recipient" page
+ * Insert key & value pair into the page without room for it, then remove the pairs
+ * after the split point to "recipient" page, which is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
-  /*when call this function, there are GetMaxSize()+1 elements*/
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient, const KeyType &key, const ValueType &value,
+                                            const KeyComparator &comparator) {
   /*set next page id to link these 2 page*/
   recipient->SetNextPageId(GetNextPageId());
   SetNextPageId(recipient->GetPageId());
-  /*move [GetMinSize()] TO [GetMaxSize()] into recipient*/
-  for (int i = GetMinSize(); i <= GetMaxSize(); i++) {
-    recipient->array_[i - GetMinSize()] = array_[i];
-  } 
-  recipient->SetSize(GetMaxSize() - GetMinSize() + 1);
-  SetSize(GetMinSize());
-
+  int index = KeyIndex(key, comparator);
+  std::vector<MappingType> items = array_.Items(GetSize());
+  items.insert(items.begin() + index, MappingType(key, value));
+  int split = PrefixKeyArray<KeyType, ValueType>::SplitPoint(items, index, array_.GetCapacity(), GetMaxSize(),
+                                                             GetMinSize());
+  /*each half gets the prefix of its own keys, which is at least as long as the one of all*/
+  array_.Assign(items.data(), split);
+  SetSize(split);
+  recipient->array_.Assign(items.data() + split, items.size() - split);
+  recipient->SetSize(items.size() - split);
 }
 
 /*
  * Copy starting from items, and copy {size} number of elements into me.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
-  /*for (int i = 0; i < size; i++) {
-    array_[]
-  }*/
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const MappingType *items, int size) {
+  /*items are appended after the current ones, the caller keeps them sorted and makes sure they fit*/
+  std::vector<MappingType> all = array_.Items(GetSize());
+  all.insert(all.end(), items, items + size);
+  array_.Assign(all.data(), all.size());
+  IncreaseSize(size);
 }
 
 /*****************************************************************************
@@ -157,23 +156,13 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const {
-  /*find the first element >=key :[left,right) */
-  int left = 0;
-  int right = GetSize();
-
-  while (left < right) {
-    int mid = (left + right) / 2;
-    if (comparator(key, array_[mid].first) > 0) {
-      left = mid + 1;
-    } else {
-      right = mid;
-    }
-  }
-  /*now left is the first element >=key*/
-  if ((left == GetSize()) || (comparator(key, array_[left].first) != 0)) {
+  /*find the first element >=key*/
+  auto probe = array_.MakeProbe(key);
+  int left = KeyLowerBound(GetSize(), [&](int index) { return array_.Compare(index, probe, comparator); });
+  if ((left == GetSize()) || (array_.Compare(left, probe, comparator) != 0)) {
     return false;
   } else {
-    value = array_[left].second;
+    value = array_.ValueAt(left);
     return true;
   }
   return true;
@@ -190,15 +179,10 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, co
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
- 
-  ValueType value;
-  if (Lookup(key, value, comparator)) {
-    /*the key exist*/
-    int index = KeyIndex(key,comparator);
-    /*perform deletion*/
-    for (int i = index; i < GetSize(); i++) {
-      array_[i] = array_[i + 1];
-    }
+  int index = KeyIndex(key, comparator);
+  if (index < GetSize() && comparator(array_.KeyAt(index), key) == 0) {
+    /*the key exist, perform deletion*/
+    array_.Remove(GetSize(), index);
     SetSize(GetSize() - 1);
   }
   return GetSize();
@@ -213,13 +197,12 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
-  /*we always suppose recipent is the previous sibling of this node*/
+  /*we always suppose recipent is the previous sibling of this node, with room for all pairs*/
   /*set next_page_id*/
   recipient->SetNextPageId(GetNextPageId());
-  for (int i = 0; i < GetSize(); i++) {
-    recipient->array_[i + recipient->GetSize()] = array_[i];
-  }
-  recipient->SetSize(recipient->GetSize() + GetSize());
+  std::vector<MappingType> items = array_.Items(GetSize());
+  recipient->CopyNFrom(items.data(), items.size());
+  array_.Init(array_.GetCapacity());
   SetSize(0);
 }
 
@@ -232,11 +215,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
-  recipient->array_[recipient->GetSize()] = array_[0];
-  recipient->SetSize(recipient->GetSize() + 1);
-  for (int i = 0; i < GetSize() - 1; i++) {
-    array_[i] = array_[i + 1];
-  }
+  recipient->CopyLastFrom(array_.ItemAt(0));
+  array_.Remove(GetSize(), 0);
   SetSize(GetSize() - 1);
 }
 
@@ -245,7 +225,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient)
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
-
+  array_.Insert(GetSize(), GetSize(), item.first, item.second);
+  IncreaseSize(1);
 }
 
 /*
@@ -253,12 +234,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
-  for (int i = recipient->GetSize(); i > 0; i--) {
-    recipient->array_[i] = recipient->array_[i - 1];
-  }
-  recipient->SetSize(recipient->GetSize() + 1);
-
-  recipient->array_[0] = array_[GetSize()-1];
+  recipient->CopyFirstFrom(array_.ItemAt(GetSize() - 1));
+  array_.Remove(GetSize(), GetSize() - 1);
   SetSize(GetSize() - 1);
 }
 
@@ -268,12 +245,16 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient)
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {
-
+  array_.Insert(GetSize(), 0, item.first, item.second);
+  IncreaseSize(1);
 }
 
 template
 class BPlusTreeLeafPage<int, int, BasicComparator<int>>;
 
+template
+class BPlusTreeLeafPage<int, RowId, BasicComparator<int>>;
+
 template
 class BPlusTreeLeafPage<GenericKey<4>, RowId, GenericComparator<4>>;
 
@@ -283,8 +264,20 @@ class BPlusTreeLeafPage<GenericKey<8>, RowId, GenericComparator<8>>;
 template
 class BPlusTreeLeafPage<GenericKey<16>, RowId, GenericComparator<16>>;
 
+template
+class BPlusTreeLeafPage<GenericKey<24>, RowId, GenericComparator<24>>;
+
 template
 class BPlusTreeLeafPage<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeLeafPage<GenericKey<48>, RowId, GenericComparator<48>>;
+
+template
+class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
+
+template
+class BPlusTreeLeafPage<GenericKey<96>, RowId, GenericComparator<96>>;
+
+template
+class BPlusTreeLeafPage<GenericKey<128>, RowId, GenericComparator<128>>;
\ No newline at end of file
@@ -7,13 +7,14 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
   //MACH_WRITE_UINT32(buf, ROW_MAGIC_NUM);
   //buf += sizeof(uint32_t);  // magic number
 
-  /*number of fields*/
-  MACH_WRITE_UINT32(buf, fields_.size());
+  /*number of fields, the highest bit tells whether an offset array follows the bitmap*/
+  uint32_t field_count = fields_.size();
+  bool use_offsets = UseOffsetArray(field_count);
+  MACH_WRITE_UINT32(buf, use_offsets ? (field_count | ROW_OFFSET_ARRAY_FLAG) : field_count);
   buf += sizeof(uint32_t);
-  /*bitmap for row*/
-
-  uint32_t bitmap_size = (fields_.size() %8  == 0) ? fields_.size() / 8 : fields_.size() / 8 + 1;
-  char* bitmap=new char[bitmap_size];
+  /*bitmap for row, written in place*/
+  uint32_t bitmap_size = GetBitmapSize(field_count);
+  char *bitmap = buf;
   memset(bitmap, 0, bitmap_size);//all initialize with 0
   uint32_t byte=0;
   uint32_t bit = 0;
@@ -27,21 +28,24 @@ uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
       bit = 0;
     }
   }
-  /*write bitmap*/
-  for (uint32_t i = 0; i < bitmap_size; i++) {
-    MACH_WRITE_CHAR(buf, bitmap[i]);
-    buf += sizeof(char);
+  buf += bitmap_size;
+  /*reserve the offset array, it is filled while writing the fields*/
+  char *offsets = buf;
+  if (use_offsets) {
+    buf += sizeof(uint16_t) * field_count;
   }
   /*write each field. from the serialize function of field,we can find that if this
   field is null, we will do nothing.
   */
-  for (auto it = fields_.begin();it!=fields_.end();it++) {
-    buf += (*it)->SerializeTo(buf);
+  for (uint32_t i = 0; i < field_count; i++) {
+    if (use_offsets) {
+      MACH_WRITE_TO(uint16_t, offsets + sizeof(uint16_t) * i, static_cast<uint16_t>(buf - begin));
+    }
+    buf += fields_[i]->SerializeTo(buf);
   }
 
   uint32_t offset = buf - begin;
   buf = begin;
-  delete[] bitmap;
   return offset;
 }
 
@@ -58,15 +62,19 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
   //}
   uint32_t size = MACH_READ_UINT32(buf);
   buf += sizeof(uint32_t);
-  /*read in bitmap*/
-  uint32_t bitmap_size = (size % 8 == 0) ? size / 8 : size / 8 + 1;
-  char *bitmap = new char[bitmap_size];
-  for (uint32_t i = 0; i < bitmap_size; i++) {
-    bitmap[i] = MACH_READ_FROM(char, buf);
-    buf += sizeof(char);
+  bool use_offsets = (size & ROW_OFFSET_ARRAY_FLAG) != 0;
+  size &= ~ROW_OFFSET_ARRAY_FLAG;
+  /*bitmap is read in place*/
+  uint32_t bitmap_size = GetBitmapSize(size);
+  const char *bitmap = buf;
+  buf += bitmap_size;
+  /*fields are stored in order, so the offset array can be skipped here*/
+  if (use_offsets) {
+    buf += sizeof(uint16_t) * size;
   }
   /*bitmap[byte]<<bit&0x80 to judge if this is null*/
-  fields_.clear();
+  ClearFields();
+  fields_.reserve(size);
 
   uint32_t byte=0;
   uint32_t bit = 0;
@@ -87,15 +95,16 @@ uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
 
   uint32_t offset = buf - begin;
   buf = begin;
-  delete[] bitmap;
   return offset;
 }
 
-uint32_t Row::GetSerializedSize(Schema *schema) const { 
+uint32_t Row::GetSerializedSize(Schema *schema) const {
   //uint32_t offset = sizeof(uint32_t) * ;//magic number+ size
   uint32_t offset = sizeof(uint32_t);//size
-  uint32_t bitmap_size = (fields_.size() % 8 == 0) ? fields_.size() / 8 : fields_.size() / 8 + 1;
-  offset += sizeof(char) * bitmap_size; /*bitmap size*/
+  offset += sizeof(char) * GetBitmapSize(fields_.size()); /*bitmap size*/
+  if (UseOffsetArray(fields_.size())) {
+    offset += sizeof(uint16_t) * fields_.size(); /*offset array*/
+  }
   for (auto it=fields_.begin();it!=fields_.end();it++) {
     offset += (*it)->GetSerializedSize();
   }
@@ -0,0 +1,72 @@
+#include "record/row.h"
+#include "record/row_view.h"
+
+void RowView::Reset(const char *data, Schema *schema, RowId rid) {
+  data_ = data;
+  schema_ = schema;
+  rid_ = rid;
+  uint32_t header = MACH_READ_UINT32(data);
+  field_count_ = header & ~Row::ROW_OFFSET_ARRAY_FLAG;
+  bitmap_ = data + sizeof(uint32_t);
+  uint32_t bitmap_size = Row::GetBitmapSize(field_count_);
+  offsets_.clear();
+  if (header & Row::ROW_OFFSET_ARRAY_FLAG) {
+    offset_array_ = bitmap_ + bitmap_size;
+  } else {
+    offset_array_ = nullptr;
+    /*first field starts right after the bitmap*/
+    offsets_.push_back(sizeof(uint32_t) + bitmap_size);
+  }
+}
+
+uint32_t RowView::GetFieldOffset(uint32_t idx) const {
+  ASSERT(idx <= field_count_, "Failed to access field");
+  if (offset_array_ != nullptr) {
+    if (idx < field_count_) {
+      return MACH_READ_FROM(uint16_t, offset_array_ + sizeof(uint16_t) * idx);
+    }
+    /*end of the row: behind the last field*/
+    uint32_t last = field_count_ - 1;
+    uint32_t offset = MACH_READ_FROM(uint16_t, offset_array_ + sizeof(uint16_t) * last);
+    return offset + GetFieldSize(last, offset);
+  }
+  /*walk forward from the last decoded field, null fields take no space*/
+  while (offsets_.size() <= idx) {
+    uint32_t i = offsets_.size() - 1;
+    uint32_t offset = offsets_.back();
+    offsets_.push_back(offset + GetFieldSize(i, offset));
+  }
+  return offsets_[idx];
+}
+
+uint32_t RowView::GetFieldSize(uint32_t idx, uint32_t offset) const {
+  if (IsNull(idx)) {
+    return 0;
+  }
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (type == TypeId::kTypeChar) {
+    return sizeof(uint32_t) + MACH_READ_UINT32(data_ + offset);
+  }
+  return Type::GetTypeSize(type);
+}
+
+Field RowView::GetField(uint32_t idx) const {
+  TypeId type = schema_->GetColumn(idx)->GetType();
+  if (IsNull(idx)) {
+    return Field(type);
+  }
+  switch (type) {
+    case TypeId::kTypeInt:
+      return Field(type, GetInt(idx));
+    case TypeId::kTypeFloat:
+      return Field(type, GetFloat(idx));
+    case TypeId::kTypeChar: {
+      uint32_t len;
+      const char *chars = GetChars(idx, &len);
+      return Field(type, const_cast<char *>(chars), len, false);
+    }
+    default:
+      ASSERT(false, "Unsupported field type.");
+      return Field(type);
+  }
+}
@@ -39,6 +39,9 @@ bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
     this_page->SetNextPageId(first_page_id_);
     buffer_pool_manager_->UnpinPage(first_page_id_, true);
     first_page_id_ = page_Id;
+    if (page_count_ != 0) {
+      page_count_++;
+    }
     if (!this_page->InsertTuple(row, schema_, txn, nullptr, nullptr)) {
       LOG(WARNING) << "Inserting a tuple to a new page fails" << std::endl;
       return false;
@@ -78,8 +81,14 @@ bool TableHeap::UpdateTuple(Row &row, RowId &rid, Transaction *txn) {
     /*fetch will pin this page, after we do update, unpin it*/
     buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
     if (msg == noSpace) {
+      /*the tuple moves to a page with room for it, rid is set to its new place*/
       MarkDelete(rid, txn);
-      InsertTuple(row, txn);
+      if (!InsertTuple(row, txn)) {
+        RollbackDelete(rid, txn);
+        return false;
+      }
+      ApplyDelete(rid, txn);
+      rid = row.GetRowId();
       return true;
     } else {
       return false;
@@ -130,6 +139,19 @@ void TableHeap::FreeHeap() {
   }
 }
 
+uint32_t TableHeap::GetPageCount() {
+  if (page_count_ == 0) {
+    for (page_id_t page_id = first_page_id_; page_id != INVALID_PAGE_ID;) {
+      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+      page_id_t next_page_id = page->GetNextPageId();
+      page_count_++;
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+  }
+  return page_count_;
+}
+
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
   if (row == nullptr) {
     LOG(WARNING) << "Row is nulltpr in GetTuple" << std::endl;
@@ -142,6 +164,26 @@ bool TableHeap::GetTuple(Row *row, Transaction *txn) {
   return flag;
 }
 
+bool TableHeap::GetTupleView(const RowId &rid, RowView *view, TablePage *&page, Transaction *) {
+  if (page != nullptr && page->GetTablePageId() != rid.GetPageId()) {
+    ReleasePage(page);
+  }
+  if (page == nullptr) {
+    page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+    if (page == nullptr) {
+      return false;
+    }
+  }
+  return page->GetTupleView(rid, schema_, view);
+}
+
+void TableHeap::ReleasePage(TablePage *&page) {
+  if (page != nullptr) {
+    buffer_pool_manager_->UnpinPage(page->GetTablePageId(), false);
+    page = nullptr;
+  }
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
   TablePage *page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
   if (page == nullptr) {
@@ -158,13 +200,8 @@ TableIterator TableHeap::Begin(Transaction *txn) {
     }
     next_id = page->GetNextPageId();
   }
-  /*after we get the rowid, we will get the tuple*/
-  Row row(rid);
-  if (!page->GetTuple(&row, schema_, txn, nullptr)) {
-    LOG(WARNING) << "Fail to get tuple in .begin()" << std ::endl;
-    return End();
-  }
-  return TableIterator(row, page, this, txn);
+  /*the tuple itself is read lazily by the iterator*/
+  return TableIterator(rid, page, this, txn);
 }
 
-TableIterator TableHeap::End() { return TableIterator(Row(INVALID_ROWID), nullptr, this, nullptr); }
+TableIterator TableHeap::End() { return TableIterator(INVALID_ROWID, nullptr, this, nullptr); }
@@ -6,13 +6,19 @@
 //
 //}
 
-TableIterator::TableIterator(const TableIterator &other):row_(other.row_),cur_page_(other.cur_page_),table_heap_(other.table_heap_),txn_(other.txn_){
-
+TableIterator::TableIterator(const TableIterator &other)
+    : row_(other.row_),
+      row_loaded_(other.row_loaded_),
+      cur_page_(other.cur_page_),
+      table_heap_(other.table_heap_),
+      txn_(other.txn_) {
+  if (cur_page_ != nullptr) {
+    table_heap_->buffer_pool_manager_->FetchPage(cur_page_->GetPageId());
+  }
 }
 
-TableIterator::TableIterator(Row row, TablePage *table_page, TableHeap *table_heap, Transaction *txn):row_(row),cur_page_(table_page), table_heap_(table_heap),txn_(txn) {
-
-}
+TableIterator::TableIterator(RowId rid, TablePage *table_page, TableHeap *table_heap, Transaction *txn)
+    : row_(rid), cur_page_(table_page), table_heap_(table_heap), txn_(txn) {}
 
 TableIterator::~TableIterator() {
   if (cur_page_ != nullptr && cur_page_->GetPageId() != INVALID_PAGE_ID) {
@@ -24,9 +30,35 @@ bool TableIterator::operator==(const TableIterator &itr) const { return row_.Get
 
 bool TableIterator::operator!=(const TableIterator &itr) const { return !(itr == (*this)); } */
 
-const Row &TableIterator::operator*() { return row_; }
+void TableIterator::LoadRow() {
+  if (row_loaded_ || cur_page_ == nullptr) {
+    return;
+  }
+  if (!cur_page_->GetTuple(&row_, table_heap_->schema_, txn_, nullptr)) {
+    LOG(WARNING) << "Get tuple fails while dereferencing iterator" << std ::endl;
+  }
+  row_loaded_ = true;
+}
+
+const Row &TableIterator::operator*() {
+  LoadRow();
+  return row_;
+}
+
+Row *TableIterator::operator->() {
+  LoadRow();
+  return &row_;
+}
 
-Row *TableIterator::operator->() { return &row_; }
+const RowView &TableIterator::GetRowView() {
+  if (!view_loaded_ && cur_page_ != nullptr) {
+    if (!cur_page_->GetTupleView(row_.GetRowId(), table_heap_->schema_, &view_)) {
+      LOG(WARNING) << "Get tuple view fails while dereferencing iterator" << std ::endl;
+    }
+    view_loaded_ = true;
+  }
+  return view_;
+}
 
 TableIterator &TableIterator::operator++() { 
   
@@ -36,6 +68,8 @@ TableIterator &TableIterator::operator++() {
   }
   /*if this row is the last row in this page*/
   RowId next_rid;
+  row_loaded_ = false;
+  view_loaded_ = false;
   if (!cur_page_->GetNextTupleRid(row_.rid_, &next_rid)) {
     if (cur_page_ ->GetNextPageId()==INVALID_PAGE_ID) {
       /*this is a .end()*/
@@ -44,9 +78,13 @@ TableIterator &TableIterator::operator++() {
       cur_page_ = nullptr;
       return *this;
     }
-    cur_page_ = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(cur_page_->GetNextPageId()));
+    page_id_t next_page_id = cur_page_->GetNextPageId();
+    table_heap_->buffer_pool_manager_->UnpinPage(cur_page_->GetPageId(), false);
+    cur_page_ = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(next_page_id));
     if (cur_page_ == nullptr) {
       LOG(WARNING) << "Fetch page fails when iterator ++" << std ::endl;
+      row_.SetRowId(INVALID_ROWID);
+      return *this;
     }
     /*else, cur_page_ is the next page*/
     while (!cur_page_->GetFirstTupleRid(&next_rid)) {
@@ -56,24 +94,19 @@ TableIterator &TableIterator::operator++() {
         row_.SetRowId(INVALID_ROWID);
         return *this;
       }
-      table_heap_->buffer_pool_manager_->UnpinPage(cur_page_->GetPageId(),false);
+      next_page_id = cur_page_->GetNextPageId();
+      table_heap_->buffer_pool_manager_->UnpinPage(cur_page_->GetPageId(), false);
       /*go to next page until we get to the last page or find a valid first rid*/
-      cur_page_ =
-          reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(cur_page_->GetNextPageId()));
+      cur_page_ = reinterpret_cast<TablePage *>(table_heap_->buffer_pool_manager_->FetchPage(next_page_id));
       if (cur_page_ == nullptr) {
         LOG(WARNING) << "Fetch page fails when iterator ++" << std ::endl;
+        row_.SetRowId(INVALID_ROWID);
         return *this;
       }
     }
   } 
-  /*else we get next tuple next_rid*/
-  /*get the tuple*/
+  /*else we get next tuple next_rid, the tuple itself is read lazily*/
   row_.SetRowId(next_rid);
-  if (!cur_page_->GetTuple(&row_, table_heap_->schema_, txn_, nullptr)) {
-    LOG(WARNING) << "Get tuple fails while ++iterator" << std ::endl;
-    row_.SetRowId(INVALID_ROWID);
-    cur_page_ = nullptr;
-  }
   return *this;
  
 }
@@ -1,6 +1,7 @@
 #include "catalog/catalog.h"
 #include "common/instance.h"
 #include "gtest/gtest.h"
+#include "page/index_roots_page.h"
 #include "utils/utils.h"
 
 static string db_file_name = "catalog_test.db";
@@ -20,6 +21,7 @@ TEST(CatalogTest, CatalogMetaTest) {
     meta->GetIndexMetaPages()->emplace(i, RandomUtils::RandomInt(0, 1 << 16));
   }
   meta->GetIndexMetaPages()->emplace(index_nums, INVALID_PAGE_ID);
+  meta->GetTableStatisticsPages()->emplace(3, 42);
   // serialize
   meta->SerializeTo(buf);
   // deserialize
@@ -27,6 +29,7 @@ TEST(CatalogTest, CatalogMetaTest) {
   ASSERT_NE(nullptr, other);
   ASSERT_EQ(table_nums + 1, other->GetTableMetaPages()->size());
   ASSERT_EQ(index_nums + 1, other->GetIndexMetaPages()->size());
+  ASSERT_EQ(42, other->GetTableStatisticsPages()->at(3));
   ASSERT_EQ(INVALID_PAGE_ID, other->GetTableMetaPages()->at(table_nums));
   ASSERT_EQ(INVALID_PAGE_ID, other->GetIndexMetaPages()->at(index_nums));
   for (auto i = 0; i < table_nums; i++) {
@@ -154,4 +157,337 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, CatalogLegacyIndexTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  vector<Column> primary_key;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), primary_key, nullptr, table_info));
+  const int row_nums = 500;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name-" + std::to_string(i);
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  table_info->SetRootPageId();
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-1", {"name"}, nullptr, index_info));
+  index_id_t index_id = index_info->GetIndexMeta()->GetIndexId();
+  table_id_t table_id = table_info->GetTableId();
+  delete db_01;
+  // rewrite the metadata the way it was stored before KeyCodec, with the tree left in place
+  page_id_t old_root_id = INVALID_PAGE_ID;
+  {
+    DiskManager disk_manager(db_file_name);
+    BufferPoolManager bpm(DEFAULT_BUFFER_POOL_SIZE, &disk_manager);
+    CatalogMeta *meta = CatalogMeta::DeserializeFrom(bpm.FetchPage(CATALOG_META_PAGE_ID)->GetData(), &heap);
+    bpm.UnpinPage(CATALOG_META_PAGE_ID, false);
+    page_id_t meta_page_id = meta->GetIndexMetaPages()->at(index_id);
+    char *buf = bpm.FetchPage(meta_page_id)->GetData();
+    std::string index_name = "index-1";
+    uint32_t legacy[] = {344528, index_id, static_cast<uint32_t>(index_name.size())};
+    memcpy(buf, legacy, sizeof(legacy));
+    memcpy(buf + sizeof(legacy), index_name.c_str(), index_name.size());
+    uint32_t keys[] = {table_id, 1, 1};
+    memcpy(buf + sizeof(legacy) + index_name.size(), keys, sizeof(keys));
+    bpm.UnpinPage(meta_page_id, true);
+    auto *roots = reinterpret_cast<IndexRootsPage *>(bpm.FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    ASSERT_TRUE(roots->GetRootId(index_id, &old_root_id));
+    bpm.UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  }
+  // the index is rebuilt from the table on load, in a new tree
+  for (int round = 0; round < 2; round++) {
+    auto db_02 = new DBStorageEngine(db_file_name, false);
+    ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-1", index_info));
+    ASSERT_EQ(round == 0, index_info->GetIndexMeta()->HasLegacyTree());
+    auto *roots = reinterpret_cast<IndexRootsPage *>(db_02->bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    page_id_t root_id = INVALID_PAGE_ID;
+    ASSERT_TRUE(roots->GetRootId(index_id, &root_id));
+    db_02->bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+    ASSERT_NE(old_root_id, root_id);
+    for (int i = 0; i < row_nums; i++) {
+      std::string name = "name-" + std::to_string(i);
+      std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+      Row key(fields);
+      std::vector<RowId> result;
+      int position = 0;
+      page_id_t leaf_page = 0;
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, result, position, leaf_page, nullptr));
+      ASSERT_EQ(1u, result.size());
+    }
+    // the second load finds the metadata written back in the current format
+    delete db_02;
+  }
+}
+
+TEST(CatalogTest, CatalogLegacyPageFormatTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateTable("table-1", schema.get(), {}, nullptr, table_info));
+  const int row_nums = 500;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>("n"), 1, true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, nullptr));
+  }
+  table_info->SetRootPageId();
+  IndexInfo *index_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, db_01->catalog_mgr_->CreateIndex("table-1", "index-1", {"id"}, nullptr, index_info));
+  index_id_t index_id = index_info->GetIndexMeta()->GetIndexId();
+  delete db_01;
+  // the metadata of a tree written before prefix compression differs in its magic number only
+  page_id_t old_root_id = INVALID_PAGE_ID;
+  {
+    DiskManager disk_manager(db_file_name);
+    BufferPoolManager bpm(DEFAULT_BUFFER_POOL_SIZE, &disk_manager);
+    CatalogMeta *meta = CatalogMeta::DeserializeFrom(bpm.FetchPage(CATALOG_META_PAGE_ID)->GetData(), &heap);
+    bpm.UnpinPage(CATALOG_META_PAGE_ID, false);
+    page_id_t meta_page_id = meta->GetIndexMetaPages()->at(index_id);
+    MACH_WRITE_UINT32(bpm.FetchPage(meta_page_id)->GetData(), 344531);
+    bpm.UnpinPage(meta_page_id, true);
+    auto *roots = reinterpret_cast<IndexRootsPage *>(bpm.FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    ASSERT_TRUE(roots->GetRootId(index_id, &old_root_id));
+    bpm.UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+  }
+  for (int round = 0; round < 2; round++) {
+    auto db_02 = new DBStorageEngine(db_file_name, false);
+    ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-1", index_info));
+    ASSERT_EQ(round == 0, index_info->GetIndexMeta()->HasLegacyTree());
+    ASSERT_TRUE(index_info->GetIndexMeta()->GetIncludeMapping().empty());
+    auto *roots = reinterpret_cast<IndexRootsPage *>(db_02->bpm_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+    page_id_t root_id = INVALID_PAGE_ID;
+    ASSERT_TRUE(roots->GetRootId(index_id, &root_id));
+    db_02->bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+    ASSERT_NE(old_root_id, root_id);
+    for (int i = 0; i < row_nums; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+      Row key(fields);
+      std::vector<RowId> result;
+      int position = 0;
+      page_id_t leaf_page = 0;
+      ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(key, result, position, leaf_page, nullptr));
+      ASSERT_EQ(1u, result.size());
+    }
+    delete db_02;
+  }
+}
+
+TEST(CatalogTest, CatalogIndexKeySizeTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 200, 1, true, false),
+          ALLOC_COLUMN(heap)("code", TypeId::kTypeChar, 4, 2, true, false),
+          ALLOC_COLUMN(heap)("tag", TypeId::kTypeChar, 16, 3, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  vector<Column> primary_key;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), primary_key, &txn, table_info));
+  // a single int column gets plain int keys
+  IndexInfo *index_info = nullptr;
+  std::vector<std::string> index_keys{"id"};
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-1", index_keys, &txn, index_info));
+  using INT_INDEX = BPlusTreeIndex<int32_t, RowId, BasicComparator<int32_t>>;
+  ASSERT_EQ(kIndexKeyInt, index_info->GetIndexMeta()->GetKeyKind());
+  ASSERT_NE(nullptr, dynamic_cast<INT_INDEX *>(index_info->GetIndex()));
+  // a char(4) key takes the 8-byte instantiation
+  std::vector<std::string> code_index_keys{"code"};
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-3", code_index_keys, &txn, index_info));
+  using CODE_INDEX = BPlusTreeIndex<GenericKey<8>, RowId, GenericComparator<8>>;
+  ASSERT_EQ(kIndexKeyGeneric, index_info->GetIndexMeta()->GetKeyKind());
+  ASSERT_NE(nullptr, dynamic_cast<CODE_INDEX *>(index_info->GetIndex()));
+  // a char(16) key needs 19 bytes and fits the 24-byte instantiation rather than 32
+  std::vector<std::string> tag_index_keys{"tag"};
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-4", tag_index_keys, &txn, index_info));
+  using TAG_INDEX = BPlusTreeIndex<GenericKey<24>, RowId, GenericComparator<24>>;
+  ASSERT_NE(nullptr, dynamic_cast<TAG_INDEX *>(index_info->GetIndex()));
+  // a non-unique index appends the 8-byte row id to the key, an int column gets a generic key then
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateIndex("table-1", "index-5", index_keys, &txn, index_info, false));
+  using NON_UNIQUE_INDEX = BPlusTreeIndex<GenericKey<16>, RowId, GenericComparator<16>>;
+  ASSERT_FALSE(index_info->IsUnique());
+  ASSERT_EQ(kIndexKeyGeneric, index_info->GetIndexMeta()->GetKeyKind());
+  ASSERT_NE(nullptr, dynamic_cast<NON_UNIQUE_INDEX *>(index_info->GetIndex()));
+  // include columns are stored after the key, the key of an int column is generic then
+  std::vector<std::string> include_columns{"code", "id"};
+  ASSERT_EQ(DB_SUCCESS,
+            catalog_01->CreateIndex("table-1", "index-6", index_keys, &txn, index_info, true, include_columns));
+  using COVERING_INDEX = BPlusTreeIndex<GenericKey<16>, RowId, GenericComparator<16>>;
+  ASSERT_EQ(kIndexKeyGeneric, index_info->GetIndexMeta()->GetKeyKind());
+  ASSERT_NE(nullptr, dynamic_cast<COVERING_INDEX *>(index_info->GetIndex()));
+  ASSERT_EQ(1u, index_info->GetIndexKeySchema()->GetColumnCount());
+  ASSERT_EQ(2u, index_info->GetIndexEntrySchema()->GetColumnCount());
+  std::vector<std::string> bad_include_columns{"none"};
+  ASSERT_EQ(DB_COLUMN_NAME_NOT_EXIST,
+            catalog_01->CreateIndex("table-1", "index-7", index_keys, &txn, index_info, true, bad_include_columns));
+  // keys wider than the widest instantiation are rejected
+  std::vector<std::string> wide_index_keys{"id", "name"};
+  ASSERT_EQ(DB_FAILED, catalog_01->CreateIndex("table-1", "index-2", wide_index_keys, &txn, index_info));
+  // the cursor walks the keys in order without knowing the key type
+  ASSERT_EQ(DB_SUCCESS, catalog_01->GetIndex("table-1", "index-1", index_info));
+  for (int i = 9; i >= 0; i--) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(row, RowId(1000, i), nullptr));
+  }
+  int i = 0;
+  for (auto cursor = index_info->GetIndex()->GetBeginCursor(); !cursor->IsEnd(); cursor->Next()) {
+    ASSERT_EQ(RowId(1000, i).Get(), cursor->GetRowId().Get());
+    i++;
+  }
+  ASSERT_EQ(10, i);
+  // null is not indexed by int keys
+  std::vector<Field> null_fields{Field(TypeId::kTypeInt)};
+  Row null_row(null_fields);
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->InsertEntry(null_row, RowId(1000, 10), nullptr));
+  std::vector<RowId> ret;
+  int position = 0;
+  page_id_t leaf_page = 0;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index_info->GetIndex()->ScanKey(null_row, ret, position, leaf_page, &txn));
+  delete db_01;
+  // the key kind survives reloading the catalog
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-1", index_info));
+  ASSERT_NE(nullptr, dynamic_cast<INT_INDEX *>(index_info->GetIndex()));
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 7)};
+  Row row(fields);
+  ASSERT_EQ(DB_SUCCESS, index_info->GetIndex()->ScanKey(row, ret, position, leaf_page, &txn));
+  ASSERT_EQ(RowId(1000, 7).Get(), ret.back().Get());
+  ASSERT_TRUE(index_info->IsUnique());
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-5", index_info));
+  ASSERT_FALSE(index_info->IsUnique());
+  ASSERT_NE(nullptr, dynamic_cast<NON_UNIQUE_INDEX *>(index_info->GetIndex()));
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetIndex("table-1", "index-6", index_info));
+  ASSERT_EQ(std::vector<uint32_t>{2}, index_info->GetIndexMeta()->GetIncludeMapping());
+  ASSERT_EQ("code", index_info->GetIndexEntrySchema()->GetColumn(1)->GetName());
+  ASSERT_NE(nullptr, dynamic_cast<COVERING_INDEX *>(index_info->GetIndex()));
+  delete db_02;
+}
+
+TEST(CatalogTest, CatalogStatisticsTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 1, true, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  vector<Column> primary_key;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), primary_key, &txn, table_info));
+  ASSERT_EQ(DB_TABLE_NOT_EXIST, catalog_01->AnalyzeTable("table-2", table_info));
+  ASSERT_EQ(nullptr, table_info->GetStatistics());
+  // every 10th score is null, 50 different names
+  const int row_nums = 10000;
+  for (int i = 0; i < row_nums; i++) {
+    std::string name = "name-" + std::to_string(i % 50);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              i % 10 == 0 ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, (float)(i % 100)),
+                              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.length(), true)};
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1", table_info));
+  TableStatistics *stats = table_info->GetStatistics();
+  ASSERT_NE(nullptr, stats);
+  ASSERT_EQ(row_nums, stats->GetRowCount());
+  ASSERT_EQ(table_info->GetTableHeap()->GetPageCount(), stats->GetPageCount());
+  ASSERT_NEAR(row_nums, stats->GetColumnStatistics(0).distinct_, row_nums * 0.05);
+  ASSERT_NEAR(90, stats->GetColumnStatistics(1).distinct_, 2);
+  ASSERT_NEAR(50, stats->GetColumnStatistics(2).distinct_, 2);
+  ASSERT_EQ(row_nums / 10, stats->GetColumnStatistics(1).nulls_);
+  // min and max are exact, the buckets in between are about even
+  const std::vector<double> bounds = stats->GetColumnStatistics(0).bounds_;
+  ASSERT_EQ(TableStatistics::HISTOGRAM_BUCKETS + 1, bounds.size());
+  ASSERT_EQ(0, bounds.front());
+  ASSERT_EQ(row_nums - 1, bounds.back());
+  ASSERT_TRUE(stats->GetColumnStatistics(2).bounds_.empty());
+  ASSERT_NEAR(0.25, stats->Selectivity(0, "<", 2500), 0.03);
+  ASSERT_NEAR(0.9, stats->Selectivity(0, ">=", 1000), 0.03);
+  ASSERT_NEAR(1.0 / row_nums, stats->Selectivity(0, "=", 42), 0.0001);
+  ASSERT_EQ(0, stats->Selectivity(0, "=", -1));
+  ASSERT_EQ(0, stats->Selectivity(0, "<", 0));
+  ASSERT_EQ(1, stats->Selectivity(0, "<=", row_nums - 1));
+  ASSERT_NEAR(0.1, stats->Selectivity(1, "is", 0), 0.0001);
+  ASSERT_NEAR(0.02, stats->Selectivity(2, "=", 0), 0.001);
+  // analyzing again replaces the statistics, the old ones are released
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1", table_info));
+  stats = table_info->GetStatistics();
+  ASSERT_EQ(row_nums, stats->GetRowCount());
+  ASSERT_EQ(bounds, stats->GetColumnStatistics(0).bounds_);
+  // the statistics belong to the catalog, which is gone with the engine
+  uint32_t distinct = stats->GetColumnStatistics(0).distinct_;
+  delete db_01;
+  // the statistics are stored with the catalog
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info));
+  TableStatistics *loaded = table_info->GetStatistics();
+  ASSERT_NE(nullptr, loaded);
+  ASSERT_EQ(row_nums, loaded->GetRowCount());
+  ASSERT_EQ(distinct, loaded->GetColumnStatistics(0).distinct_);
+  ASSERT_EQ(bounds, loaded->GetColumnStatistics(0).bounds_);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->DropTable("table-1"));
+  delete db_02;
+}
+
+TEST(CatalogTest, CatalogOversizedStatisticsTest) {
+  SimpleMemHeap heap;
+  auto db_01 = new DBStorageEngine(db_file_name, true);
+  auto &catalog_01 = db_01->catalog_mgr_;
+  // the histograms of 32 int columns don't fit in a page, the statistics of the empty table do
+  const uint32_t column_count = 32;
+  std::vector<Column *> columns;
+  for (uint32_t i = 0; i < column_count; i++) {
+    columns.push_back(ALLOC_COLUMN(heap)("c" + std::to_string(i), TypeId::kTypeInt, i, false, false));
+  }
+  auto schema = std::make_shared<Schema>(columns);
+  Transaction txn;
+  vector<Column> primary_key;
+  TableInfo *table_info = nullptr;
+  ASSERT_EQ(DB_SUCCESS, catalog_01->CreateTable("table-1", schema.get(), primary_key, &txn, table_info));
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1", table_info));
+  ASSERT_NE(nullptr, table_info->GetStatistics());
+  ASSERT_GE(PAGE_SIZE, table_info->GetStatistics()->GetSerializedSize());
+  const int row_nums = 1000;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> fields;
+    for (uint32_t j = 0; j < column_count; j++) {
+      fields.emplace_back(TypeId::kTypeInt, i + (int)j);
+    }
+    Row row(fields);
+    ASSERT_TRUE(table_info->GetTableHeap()->InsertTuple(row, &txn));
+  }
+  ASSERT_EQ(DB_SUCCESS, catalog_01->AnalyzeTable("table-1", table_info));
+  ASSERT_NE(nullptr, table_info->GetStatistics());
+  ASSERT_EQ(row_nums, table_info->GetStatistics()->GetRowCount());
+  ASSERT_LT(PAGE_SIZE, table_info->GetStatistics()->GetSerializedSize());
+  delete db_01;
+  // the statistics of the empty table are not loaded in place of the ones that weren't stored
+  auto db_02 = new DBStorageEngine(db_file_name, false);
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->GetTable("table-1", table_info));
+  ASSERT_EQ(nullptr, table_info->GetStatistics());
+  ASSERT_EQ(DB_SUCCESS, db_02->catalog_mgr_->DropTable("table-1"));
+  delete db_02;
+}
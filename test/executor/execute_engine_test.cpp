@@ -0,0 +1,277 @@
+#include <malloc.h>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+
+#include "common/instance.h"
+#include "executor/operators.h"
+#include "executor/sql_utils.h"
+#include "gtest/gtest.h"
+
+static const char *engine_db_name = "execute_engine_test_db";
+
+/* a database with table t(id int unique, name char(16), age int, primary key(id)) of rows (i, "n<i>", i % 7) */
+class ExecuteEngineTest : public testing::Test {
+protected:
+  void SetUp() override {
+    remove("databasefile.txt");
+    remove(engine_db_name);
+    engine_ = new ExecuteEngine();
+    ASSERT_EQ(DB_SUCCESS, Execute(std::string("create database ") + engine_db_name + ";"));
+    ASSERT_EQ(DB_SUCCESS, Execute(std::string("use ") + engine_db_name + ";"));
+    ASSERT_EQ(DB_SUCCESS, Execute("create table t(id int unique, name char(16), age int, primary key(id));"));
+  }
+
+  void TearDown() override {
+    delete engine_;
+    remove("databasefile.txt");
+    remove(engine_db_name);
+  }
+
+  dberr_t Execute(const std::string &sql) { return ExecuteSql(*engine_, sql.c_str(), &context_); }
+
+  void InsertRows(int count) {
+    for (int i = 1; i <= count; i++) {
+      std::string sql = "insert into t values(" + std::to_string(i) + ", \"n" + std::to_string(i) + "\", " +
+                        std::to_string(i % 7) + ");";
+      ASSERT_EQ(DB_SUCCESS, Execute(sql));
+    }
+  }
+
+  ExecuteEngine *engine_{nullptr};
+  ExecuteContext context_;
+};
+
+TEST_F(ExecuteEngineTest, StatementMemoryTest) {
+  InsertRows(300);
+  // every statement reads and writes rows through its own heap, which is released when it returns
+  const char *update = "update t set age = 3 where age = 3;";
+  ASSERT_EQ(DB_SUCCESS, Execute(update));
+  ASSERT_EQ(nullptr, context_.heap_);
+  size_t before = mallinfo2().uordblks;
+  for (int i = 0; i < 20; i++) {
+    ASSERT_EQ(DB_SUCCESS, Execute(update));
+    ASSERT_EQ(nullptr, context_.heap_);
+  }
+  size_t after = mallinfo2().uordblks;
+  // a statement heap that was kept would leave at least one chunk behind per statement
+  ASSERT_LT(after, before + ArenaMemHeap::DEFAULT_CHUNK_SIZE * 2);
+}
+
+static const char *planner_db_name = "planner_test.db";
+
+/*
+ * table t(id int unique, age int) of rows (i, i % 7), with an index on id and a non-unique index on age,
+ * the index paths of a where clause are asked for directly
+ */
+class PlannerTest : public testing::Test {
+protected:
+  static constexpr int ROWS = 300;
+
+  void SetUp() override {
+    storage_ = new DBStorageEngine(planner_db_name, true);
+    context_.heap_ = &heap_;
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, true),
+            ALLOC_COLUMN(heap_)("age", TypeId::kTypeInt, 1, true, false)
+    };
+    auto schema = ALLOC(heap_, Schema)(columns);
+    ASSERT_EQ(DB_SUCCESS, storage_->catalog_mgr_->CreateTable("t", schema, std::vector<Column>(), nullptr, table_));
+    for (int i = 0; i < ROWS; i++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeInt, i % 7)};
+      Row row(fields);
+      ASSERT_TRUE(table_->GetTableHeap()->InsertTuple(row, nullptr));
+      ids_[row.GetRowId().Get()] = i;
+    }
+    IndexInfo *index = nullptr;
+    ASSERT_EQ(DB_SUCCESS, storage_->catalog_mgr_->CreateIndex("t", "idx_id", {"id"}, nullptr, index, true));
+    ASSERT_EQ(DB_SUCCESS, storage_->catalog_mgr_->CreateIndex("t", "idx_age", {"age"}, nullptr, index, false));
+  }
+
+  void TearDown() override {
+    delete storage_;
+    remove(planner_db_name);
+  }
+
+  /*
+   * the rows the index paths select for the where clause of sql, by id; false if they are not
+   * sorted by row id, hold a row twice or there is no index path
+   */
+  bool IndexPath(const char *sql, std::set<int> *ids) {
+    ParsedStatement statement(sql);
+    EXPECT_TRUE(statement.IsValid());
+    RowIdList rows{MemHeapAllocator<RowId>(&heap_)};
+    if (!engine_.IndexPath(storage_, table_, statement.GetCondition(), SIZE_MAX, &rows, &context_)) {
+      return false;
+    }
+    for (size_t i = 1; i < rows.size(); i++) {
+      if (rows[i - 1].Get() >= rows[i].Get()) {
+        return false;
+      }
+    }
+    for (auto &rid : rows) {
+      ids->insert(ids_[rid.Get()]);
+    }
+    return true;
+  }
+
+  void SortRowIds(RowIdList *rows) { engine_.SortRowIds(rows); }
+
+  /* the scan planned for the where clause of sql, its row ids are kept in rows_ */
+  std::unique_ptr<Operator> PlanScan(const char *sql) {
+    ParsedStatement statement(sql);
+    EXPECT_TRUE(statement.IsValid());
+    rows_.clear();
+    return engine_.PlanScan(storage_, table_, statement.GetCondition(), &rows_, &context_);
+  }
+
+  /* the ids of the rows op gives */
+  static std::set<int> ReadIds(Operator *op) {
+    std::set<int> ids;
+    RowBatch batch;
+    while (op->Next(&batch)) {
+      for (size_t i = 0; i < batch.Size(); i++) {
+        ids.insert(batch.At(i).GetInt(0));
+      }
+    }
+    return ids;
+  }
+
+  /* the ids in [0, ROWS) that satisfy condition */
+  template<typename Condition>
+  static std::set<int> Expect(Condition condition) {
+    std::set<int> ids;
+    for (int i = 0; i < ROWS; i++) {
+      if (condition(i)) {
+        ids.insert(i);
+      }
+    }
+    return ids;
+  }
+
+  ArenaMemHeap heap_;
+  ExecuteContext context_;
+  ExecuteEngine engine_;
+  DBStorageEngine *storage_{nullptr};
+  TableInfo *table_{nullptr};
+  std::map<int64_t, int> ids_;
+  RowIdList rows_{MemHeapAllocator<RowId>(&heap_)};
+};
+
+TEST_F(PlannerTest, SortRowIdsTest) {
+  // sorted by page then slot, duplicates dropped
+  RowIdList rows{MemHeapAllocator<RowId>(&heap_)};
+  for (RowId rid : {RowId(3, 1), RowId(1, 5), RowId(3, 0), RowId(1, 5), RowId(2, 2), RowId(3, 1), RowId(1, 0)}) {
+    rows.push_back(rid);
+  }
+  SortRowIds(&rows);
+  std::vector<RowId> expect{RowId(1, 0), RowId(1, 5), RowId(2, 2), RowId(3, 0), RowId(3, 1)};
+  ASSERT_EQ(expect.size(), rows.size());
+  for (size_t i = 0; i < expect.size(); i++) {
+    ASSERT_EQ(expect[i], rows[i]);
+  }
+  // a sorted list keeps its order, an empty one stays empty
+  SortRowIds(&rows);
+  ASSERT_EQ(expect.size(), rows.size());
+  rows.clear();
+  SortRowIds(&rows);
+  ASSERT_TRUE(rows.empty());
+}
+
+TEST_F(PlannerTest, IntersectionTest) {
+  std::set<int> ids;
+  // overlapping
+  ASSERT_TRUE(IndexPath("select * from t where age = 3 and id < 100;", &ids));
+  ASSERT_EQ(Expect([](int i) { return i % 7 == 3 && i < 100; }), ids);
+  // disjoint, both sides from the non-unique index
+  ids.clear();
+  ASSERT_TRUE(IndexPath("select * from t where age = 3 and age = 4;", &ids));
+  ASSERT_TRUE(ids.empty());
+  // one side empty
+  ASSERT_TRUE(IndexPath("select * from t where id > 1000 and age = 3;", &ids));
+  ASSERT_TRUE(ids.empty());
+  // the same rows on both sides
+  ASSERT_TRUE(IndexPath("select * from t where age = 5 and age >= 5;", &ids));
+  ASSERT_EQ(Expect([](int i) { return i % 7 == 5; }), ids);
+}
+
+TEST_F(PlannerTest, UnionTest) {
+  std::set<int> ids;
+  // overlapping
+  ASSERT_TRUE(IndexPath("select * from t where age = 3 or id < 100;", &ids));
+  ASSERT_EQ(Expect([](int i) { return i % 7 == 3 || i < 100; }), ids);
+  // disjoint
+  ids.clear();
+  ASSERT_TRUE(IndexPath("select * from t where age = 3 or age = 4;", &ids));
+  ASSERT_EQ(Expect([](int i) { return i % 7 == 3 || i % 7 == 4; }), ids);
+  // one side empty, then both
+  ids.clear();
+  ASSERT_TRUE(IndexPath("select * from t where id > 1000 or age = 6;", &ids));
+  ASSERT_EQ(Expect([](int i) { return i % 7 == 6; }), ids);
+  ids.clear();
+  ASSERT_TRUE(IndexPath("select * from t where id > 1000 or id < 0;", &ids));
+  ASSERT_TRUE(ids.empty());
+  // every row of the non-unique index on both sides, each is kept once
+  ASSERT_TRUE(IndexPath("select * from t where age = 2 or age <= 2;", &ids));
+  ASSERT_EQ(Expect([](int i) { return i % 7 <= 2; }), ids);
+  // <> reads both sides of the key with two cursors
+  ids.clear();
+  ASSERT_TRUE(IndexPath("select * from t where age <> 2 or age = 2;", &ids));
+  ASSERT_EQ(Expect([](int) { return true; }), ids);
+}
+
+TEST_F(PlannerTest, PlanScanTest) {
+  // a table of a few pages, where the cost of a full scan allows less than one index row
+  ASSERT_LT(table_->GetTableHeap()->GetPageCount(), RANDOM_PAGE_COST);
+  // a single row is still read through the index
+  auto plan = PlanScan("select * from t where id = 5;");
+  ASSERT_NE(nullptr, dynamic_cast<IndexScanOperator *>(plan.get()));
+  ASSERT_EQ(1u, rows_.size());
+  ASSERT_EQ(std::set<int>({5}), ReadIds(plan.get()));
+  // no row at all as well
+  plan = PlanScan("select * from t where id > 1000;");
+  ASSERT_NE(nullptr, dynamic_cast<IndexScanOperator *>(plan.get()));
+  ASSERT_TRUE(ReadIds(plan.get()).empty());
+  // the rows of a non-unique key cost more than the full scan
+  plan = PlanScan("select * from t where age = 3;");
+  ASSERT_NE(nullptr, dynamic_cast<FilterOperator *>(plan.get()));
+  ASSERT_TRUE(rows_.empty());
+  ASSERT_EQ(Expect([](int i) { return i % 7 == 3; }), ReadIds(plan.get()));
+  // no where clause
+  plan = PlanScan("select * from t;");
+  ASSERT_NE(nullptr, dynamic_cast<SeqScanOperator *>(plan.get()));
+  ASSERT_EQ(static_cast<size_t>(ROWS), ReadIds(plan.get()).size());
+}
+
+TEST_F(PlannerTest, PlanScanLargeTableTest) {
+  // the table grows to enough pages for a few index rows to beat the full scan
+  IndexInfo *id_index = nullptr;
+  IndexInfo *age_index = nullptr;
+  storage_->catalog_mgr_->GetIndex("t", "idx_id", id_index);
+  storage_->catalog_mgr_->GetIndex("t", "idx_age", age_index);
+  const int rows = 5000;
+  for (int i = ROWS; i < rows; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeInt, i % 7)};
+    Row row(fields);
+    ASSERT_TRUE(table_->GetTableHeap()->InsertTuple(row, nullptr));
+    std::vector<Field> id_fields{Field(TypeId::kTypeInt, i)};
+    std::vector<Field> age_fields{Field(TypeId::kTypeInt, i % 7)};
+    ASSERT_EQ(DB_SUCCESS, id_index->GetIndex()->InsertEntry(Row(id_fields), row.GetRowId(), nullptr));
+    ASSERT_EQ(DB_SUCCESS, age_index->GetIndex()->InsertEntry(Row(age_fields), row.GetRowId(), nullptr));
+  }
+  auto maxrows = static_cast<size_t>(table_->GetTableHeap()->GetPageCount() / RANDOM_PAGE_COST);
+  ASSERT_GT(maxrows, 5u);
+  auto plan = PlanScan("select * from t where id < 5;");
+  ASSERT_NE(nullptr, dynamic_cast<IndexScanOperator *>(plan.get()));
+  ASSERT_EQ(Expect([](int i) { return i < 5; }), ReadIds(plan.get()));
+  // a range of more rows than the full scan costs
+  plan = PlanScan("select * from t where id >= 1000 and id < 2000;");
+  ASSERT_NE(nullptr, dynamic_cast<FilterOperator *>(plan.get()));
+  ASSERT_EQ(1000u, ReadIds(plan.get()).size());
+  // an and of a cheap and an expensive side reads the cheap one
+  plan = PlanScan("select * from t where id < 5 and age = 3;");
+  ASSERT_NE(nullptr, dynamic_cast<IndexScanOperator *>(plan.get()));
+  ASSERT_EQ(std::set<int>({3}), ReadIds(plan.get()));
+}
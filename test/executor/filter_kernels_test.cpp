@@ -0,0 +1,96 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "executor/filter_kernels.h"
+#include "gtest/gtest.h"
+
+static const CompareOp compare_ops[] = {CompareOp::kEqual, CompareOp::kNotEqual, CompareOp::kLess,
+                                        CompareOp::kLessEqual, CompareOp::kGreater, CompareOp::kGreaterEqual};
+
+/* counts around the eight values of a vector and the 64 of a mask word */
+static const size_t counts[] = {0, 1, 7, 8, 9, 15, 63, 64, 65, 71, 127, 128, 129, 1000, 1031};
+
+template<typename T>
+static bool Reference(T value, CompareOp op, T constant) {
+  switch (op) {
+    case CompareOp::kEqual:
+      return value == constant;
+    case CompareOp::kNotEqual:
+      return value != constant;
+    case CompareOp::kLess:
+      return value < constant;
+    case CompareOp::kLessEqual:
+      return value <= constant;
+    case CompareOp::kGreater:
+      return value > constant;
+    case CompareOp::kGreaterEqual:
+      return value >= constant;
+  }
+  return false;
+}
+
+static constexpr uint64_t STALE_BITS = 0xA5A5A5A5A5A5A5A5ULL;
+
+/*
+ * run the kernel on the first count values and check every bit of the mask against the scalar reference,
+ * the mask starts with stale bits which the kernel clears, the word after it is not touched
+ */
+template<typename T, typename Kernel>
+static void Check(Kernel kernel, const std::vector<T> &values, size_t count, CompareOp op, T constant) {
+  size_t words = MaskWords(count);
+  std::vector<uint64_t> mask(words + 1, STALE_BITS);
+  kernel(values.data(), count, op, constant, mask.data());
+  ASSERT_EQ(STALE_BITS, mask[words]);
+  for (size_t i = 0; i < words * 64; i++) {
+    bool bit = ((mask[i / 64] >> (i % 64)) & 1) != 0;
+    bool expect = i < count && Reference(values[i], op, constant);
+    ASSERT_EQ(expect, bit) << "value " << (i < count ? values[i] : T{}) << " op " << static_cast<int>(op)
+                           << " constant " << constant << " index " << i << " count " << count;
+  }
+}
+
+TEST(FilterKernelsTest, Int32Test) {
+  std::mt19937 rng(0);
+  std::vector<int32_t> values(1031);
+  // few distinct values so that equality happens, and the extremes of the type
+  for (auto &value : values) {
+    value = static_cast<int32_t>(rng() % 9) - 4;
+  }
+  values[3] = std::numeric_limits<int32_t>::min();
+  values[70] = std::numeric_limits<int32_t>::max();
+  for (size_t count : counts) {
+    for (CompareOp op : compare_ops) {
+      for (int32_t constant : {-4, 0, 3, 5, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()}) {
+        Check(FilterInt32, values, count, op, constant);
+      }
+    }
+  }
+}
+
+TEST(FilterKernelsTest, FloatTest) {
+  std::mt19937 rng(0);
+  std::vector<float> values(1031);
+  for (auto &value : values) {
+    value = static_cast<float>(static_cast<int>(rng() % 9) - 4) / 2;
+  }
+  // NaN compares false with everything but <>, zero has two signs
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const float inf = std::numeric_limits<float>::infinity();
+  values[0] = nan;
+  values[9] = nan;
+  values[64] = nan;
+  values[5] = -0.0f;
+  values[66] = inf;
+  values[67] = -inf;
+  for (size_t count : counts) {
+    for (CompareOp op : compare_ops) {
+      for (float constant : {-2.0f, 0.0f, -0.0f, 0.5f, 3.0f, inf, -inf}) {
+        Check(FilterFloat, values, count, op, constant);
+      }
+      // a NaN literal, every value
+      Check(FilterFloat, values, count, op, nan);
+    }
+  }
+}
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+
+#include "common/instance.h"
+#include "executor/operators.h"
+#include "executor/sql_utils.h"
+#include "gtest/gtest.h"
+
+static const char *operators_db_name = "operators_test.db";
+
+/*
+ * table t(id int unique, name char(1600), age int) of rows (i, 100 characters, i % 7), spread over several pages,
+ * with an index on id and a non-unique index on age
+ */
+class OperatorsTest : public testing::Test {
+protected:
+  static constexpr int ROWS = 300;
+
+  void SetUp() override {
+    engine_ = new DBStorageEngine(operators_db_name, true);
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, true),
+            ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 1600, 1, true, false),
+            ALLOC_COLUMN(heap_)("age", TypeId::kTypeInt, 2, true, false)
+    };
+    auto schema = ALLOC(heap_, Schema)(columns);
+    ASSERT_EQ(DB_SUCCESS, engine_->catalog_mgr_->CreateTable("t", schema, std::vector<Column>(), nullptr, table_));
+    std::string name(100, 'x');
+    for (int i = 0; i < ROWS; i++) {
+      std::vector<Field> fields{
+              Field(TypeId::kTypeInt, i),
+              Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true),
+              Field(TypeId::kTypeInt, i % 7)
+      };
+      Row row(fields);
+      ASSERT_TRUE(table_->GetTableHeap()->InsertTuple(row, nullptr));
+    }
+    IndexInfo *index = nullptr;
+    ASSERT_EQ(DB_SUCCESS, engine_->catalog_mgr_->CreateIndex("t", "idx_id", {"id"}, nullptr, index, true));
+    ASSERT_EQ(DB_SUCCESS, engine_->catalog_mgr_->CreateIndex("t", "idx_age", {"age"}, nullptr, index, false));
+    engine_->catalog_mgr_->GetTableIndexes("t", indexes_);
+    ASSERT_GT(table_->GetTableHeap()->GetPageCount(), 2u);
+  }
+
+  void TearDown() override {
+    delete engine_;
+    remove(operators_db_name);
+  }
+
+  /* a filter over a full scan for the where clause of sql */
+  std::unique_ptr<Operator> Filter(const char *sql) {
+    ParsedStatement statement(sql);
+    EXPECT_TRUE(statement.IsValid());
+    return std::make_unique<FilterOperator>(std::make_unique<SeqScanOperator>(table_->GetTableHeap(), nullptr),
+                                            Predicate(statement.GetCondition(), table_->GetSchema()));
+  }
+
+  /* the row ids the index finds for key */
+  std::vector<RowId> Lookup(const std::string &index_name, int key) {
+    IndexInfo *index = nullptr;
+    engine_->catalog_mgr_->GetIndex("t", index_name, index);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, key)};
+    Row row(fields);
+    std::vector<RowId> result;
+    int position;
+    page_id_t leaf_page_id;
+    index->GetIndex()->ScanKey(row, result, position, leaf_page_id, nullptr);
+    return result;
+  }
+
+  struct RowInfo {
+    RowId rid_;
+    int age_;
+    uint32_t name_length_;
+  };
+
+  /* every row left in the table, by id */
+  std::map<int, RowInfo> ReadAll() {
+    std::map<int, RowInfo> rows;
+    for (auto it = table_->GetTableHeap()->Begin(nullptr); it != table_->GetTableHeap()->End(); ++it) {
+      const RowView &row = it.GetRowView();
+      uint32_t length;
+      row.GetChars(1, &length);
+      rows[row.GetInt(0)] = RowInfo{it.GetRowId(), row.GetInt(2), length};
+    }
+    return rows;
+  }
+
+  SimpleMemHeap heap_;
+  DBStorageEngine *engine_{nullptr};
+  TableInfo *table_{nullptr};
+  std::vector<IndexInfo *> indexes_;
+};
+
+TEST_F(OperatorsTest, SeqScanTest) {
+  SeqScanOperator scan(table_->GetTableHeap(), nullptr);
+  RowBatch batch;
+  std::set<page_id_t> pages;
+  std::set<int> ids;
+  while (scan.Next(&batch)) {
+    ASSERT_NE(0u, batch.Size());
+    // a batch is the rows of one page, each page makes a single batch
+    page_id_t page_id = batch.At(0).GetRowId().GetPageId();
+    ASSERT_TRUE(pages.insert(page_id).second);
+    for (size_t i = 0; i < batch.Size(); i++) {
+      ASSERT_EQ(page_id, batch.At(i).GetRowId().GetPageId());
+      ASSERT_TRUE(ids.insert(batch.At(i).GetInt(0)).second);
+    }
+  }
+  ASSERT_EQ(table_->GetTableHeap()->GetPageCount(), pages.size());
+  ASSERT_EQ(static_cast<size_t>(ROWS), ids.size());
+  ASSERT_FALSE(scan.Next(&batch));
+}
+
+TEST_F(OperatorsTest, IndexScanTest) {
+  // rows of a page in a row make one batch, the list is read in its order
+  std::vector<RowId> found = Lookup("idx_age", 3);
+  RowIdList rows(found.begin(), found.end(), MemHeapAllocator<RowId>(&heap_));
+  std::sort(rows.begin(), rows.end(), [](const RowId &lhs, const RowId &rhs) { return lhs.Get() < rhs.Get(); });
+  IndexScanOperator scan(table_->GetTableHeap(), &rows, nullptr);
+  RowBatch batch;
+  size_t count = 0;
+  while (scan.Next(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      ASSERT_EQ(batch.At(0).GetRowId().GetPageId(), batch.At(i).GetRowId().GetPageId());
+      ASSERT_EQ(rows[count], batch.At(i).GetRowId());
+      ASSERT_EQ(3, batch.At(i).GetInt(2));
+      count++;
+    }
+  }
+  ASSERT_EQ(rows.size(), count);
+}
+
+TEST_F(OperatorsTest, FilterTest) {
+  auto filter = Filter("select * from t where age = 3 or id < 5;");
+  RowBatch batch;
+  std::set<int> ids;
+  while (filter->Next(&batch)) {
+    // the rows that pass are moved to the front, in the order of the scan
+    ASSERT_NE(0u, batch.Size());
+    for (size_t i = 0; i < batch.Size(); i++) {
+      int id = batch.At(i).GetInt(0);
+      ASSERT_TRUE(id % 7 == 3 || id < 5);
+      if (i != 0) {
+        ASSERT_LT(batch.At(i - 1).GetRowId().Get(), batch.At(i).GetRowId().Get());
+      }
+      ids.insert(id);
+    }
+  }
+  for (int i = 0; i < ROWS; i++) {
+    ASSERT_EQ(i % 7 == 3 || i < 5, ids.count(i) == 1);
+  }
+  // no row passes, every batch is skipped
+  auto none = Filter("select * from t where id > 1000;");
+  ASSERT_FALSE(none->Next(&batch));
+}
+
+TEST_F(OperatorsTest, ProjectionTest) {
+  ProjectionOperator projection(std::make_unique<SeqScanOperator>(table_->GetTableHeap(), nullptr), {2, 0});
+  RowBatch batch;
+  size_t count = 0;
+  while (projection.Next(&batch)) {
+    // only the visible columns change, the rows are the ones of the scan
+    ASSERT_EQ(std::vector<uint32_t>({2, 0}), batch.GetColumns());
+    for (size_t i = 0; i < batch.Size(); i++) {
+      ASSERT_EQ(batch.At(i).GetInt(0) % 7, batch.At(i).GetInt(2));
+    }
+    count += batch.Size();
+  }
+  ASSERT_EQ(static_cast<size_t>(ROWS), count);
+}
+
+TEST_F(OperatorsTest, DeleteTest) {
+  ArenaMemHeap heap;
+  DeleteOperator plan(Filter("select * from t where age = 3;"), table_, indexes_, nullptr, &heap);
+  RowBatch batch;
+  while (plan.Next(&batch)) {
+    ASSERT_EQ(0u, batch.Size());
+  }
+  ASSERT_EQ(DB_SUCCESS, plan.GetStatus());
+  size_t deleted = 0;
+  for (int i = 0; i < ROWS; i++) {
+    deleted += i % 7 == 3 ? 1 : 0;
+  }
+  ASSERT_EQ(deleted, plan.GetCount());
+  // the rows are gone from the table and from both indexes
+  std::map<int, RowInfo> rows = ReadAll();
+  ASSERT_EQ(ROWS - deleted, rows.size());
+  ASSERT_TRUE(Lookup("idx_age", 3).empty());
+  for (int i = 0; i < ROWS; i++) {
+    ASSERT_EQ(i % 7 != 3, rows.count(i) == 1);
+    ASSERT_EQ(i % 7 != 3, Lookup("idx_id", i).size() == 1);
+  }
+}
+
+TEST_F(OperatorsTest, UpdateTest) {
+  ArenaMemHeap heap;
+  // the rows grow past the room left in their page, all but the ones on a page with room move to another one
+  std::string name(1500, 'y');
+  std::vector<Field> values;
+  values.emplace_back(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true);
+  values.emplace_back(TypeId::kTypeInt, 10);
+  std::map<int, RowInfo> before = ReadAll();
+  UpdateOperator update(Filter("select * from t where age = 3;"), table_, indexes_, {1, 2}, std::move(values),
+                        nullptr, &heap);
+  RowBatch batch;
+  while (update.Next(&batch)) {
+  }
+  ASSERT_EQ(DB_SUCCESS, update.GetStatus());
+  size_t updated = 0;
+  for (int i = 0; i < ROWS; i++) {
+    updated += i % 7 == 3 ? 1 : 0;
+  }
+  // every row is updated once, even the ones that moved to pages the scan had not read yet
+  ASSERT_EQ(updated, update.GetCount());
+  std::map<int, RowInfo> after = ReadAll();
+  ASSERT_EQ(static_cast<size_t>(ROWS), after.size());
+  ASSERT_TRUE(Lookup("idx_age", 3).empty());
+  ASSERT_EQ(updated, Lookup("idx_age", 10).size());
+  size_t moved = 0;
+  for (int i = 0; i < ROWS; i++) {
+    const RowInfo &row = after[i];
+    ASSERT_EQ(i % 7 == 3 ? 10 : i % 7, row.age_);
+    ASSERT_EQ(i % 7 == 3 ? name.size() : 100u, row.name_length_);
+    moved += row.rid_ == before[i].rid_ ? 0 : 1;
+    // the indexes point to where the row is now
+    std::vector<RowId> found = Lookup("idx_id", i);
+    ASSERT_EQ(1u, found.size());
+    ASSERT_EQ(row.rid_, found[0]);
+  }
+  ASSERT_GT(moved, updated / 2);
+}
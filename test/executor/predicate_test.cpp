@@ -0,0 +1,247 @@
+#include <functional>
+#include <random>
+#include <string>
+
+#include "common/instance.h"
+#include "executor/operators.h"
+#include "executor/predicate.h"
+#include "gtest/gtest.h"
+
+static const char *predicate_db_name = "predicate_test.db";
+
+/*
+ * table t(id int, score float, name char(16)) of rows (i, (i % 100) / 4, "name-<i % 50>"), every 10th score
+ * and every 7th name null. Where clauses are built as syntax trees, the parser only nests to the left
+ */
+class PredicateTest : public testing::Test {
+protected:
+  static constexpr int ROWS = 2000;
+
+  /* a condition and what it should be for the row of id */
+  struct Condition {
+    pSyntaxNode node_;
+    std::function<bool(int)> expect_;
+  };
+
+  void SetUp() override {
+    engine_ = new DBStorageEngine(predicate_db_name, true);
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, false),
+            ALLOC_COLUMN(heap_)("score", TypeId::kTypeFloat, 1, true, false),
+            ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 16, 2, true, false)
+    };
+    auto schema = ALLOC(heap_, Schema)(columns);
+    ASSERT_EQ(DB_SUCCESS, engine_->catalog_mgr_->CreateTable("t", schema, std::vector<Column>(), nullptr, table_));
+    for (int i = 0; i < ROWS; i++) {
+      std::string name = Name(i);
+      std::vector<Field> fields{
+              Field(TypeId::kTypeInt, i),
+              ScoreIsNull(i) ? Field(TypeId::kTypeFloat) : Field(TypeId::kTypeFloat, Score(i)),
+              NameIsNull(i) ? Field(TypeId::kTypeChar)
+                            : Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)
+      };
+      Row row(fields);
+      ASSERT_TRUE(table_->GetTableHeap()->InsertTuple(row, nullptr));
+    }
+  }
+
+  void TearDown() override {
+    DestroySyntaxTree();
+    delete engine_;
+    remove(predicate_db_name);
+  }
+
+  static bool ScoreIsNull(int i) { return i % 10 == 0; }
+
+  static float Score(int i) { return static_cast<float>(i % 100) / 4; }
+
+  static bool NameIsNull(int i) { return i % 7 == 0; }
+
+  static std::string Name(int i) { return "name-" + std::to_string(i % 50); }
+
+  /* whether a comparison of result cmp satisfies op */
+  static bool Satisfies(const std::string &op, int cmp) {
+    if (op == "=") {
+      return cmp == 0;
+    } else if (op == "<>") {
+      return cmp != 0;
+    } else if (op == "<") {
+      return cmp < 0;
+    } else if (op == "<=") {
+      return cmp <= 0;
+    } else if (op == ">") {
+      return cmp > 0;
+    }
+    return cmp >= 0;
+  }
+
+  static pSyntaxNode Node(SyntaxNodeType type, const char *val) {
+    return CreateSyntaxNode(type, const_cast<char *>(val));
+  }
+
+  /* column op value, value of type kNodeNumber, kNodeString or kNodeNull; a string is quoted as the lexer leaves it */
+  static pSyntaxNode Compare(const char *column, const char *op, SyntaxNodeType type, const char *value) {
+    pSyntaxNode node = Node(kNodeCompareOperator, op);
+    SyntaxNodeAddChildren(node, Node(kNodeIdentifier, column));
+    std::string quoted = type == kNodeString ? "\"" + std::string(value) + "\"" : "";
+    SyntaxNodeAddChildren(node, Node(type, type == kNodeString ? quoted.c_str() : value));
+    return node;
+  }
+
+  static Condition Connect(const char *connector, const Condition &left, const Condition &right) {
+    pSyntaxNode node = Node(kNodeConnector, connector);
+    SyntaxNodeAddChildren(node, left.node_);
+    SyntaxNodeAddChildren(node, right.node_);
+    bool is_and = strcmp(connector, "and") == 0;
+    auto l = left.expect_;
+    auto r = right.expect_;
+    return Condition{node, [is_and, l, r](int i) { return is_and ? l(i) && r(i) : l(i) || r(i); }};
+  }
+
+  /*
+   * Evaluate the condition on every row, one at a time and by batches, both have to agree with expect_
+   * @return the number of rows that satisfy it
+   */
+  int Check(const Condition &condition) {
+    Predicate predicate(condition.node_, table_->GetSchema());
+    SeqScanOperator scan(table_->GetTableHeap(), nullptr);
+    RowBatch batch;
+    std::vector<uint64_t> selection;
+    int count = 0;
+    while (scan.Next(&batch)) {
+      predicate.Evaluate(batch, &selection);
+      EXPECT_EQ(MaskWords(batch.Size()), selection.size());
+      for (size_t i = 0; i < batch.Size(); i++) {
+        int id = batch.At(i).GetInt(0);
+        bool expect = condition.expect_(id);
+        EXPECT_EQ(expect, predicate.Evaluate(batch.At(i))) << "row " << id;
+        EXPECT_EQ(expect, ((selection[i / 64] >> (i % 64)) & 1) != 0) << "row " << id;
+        count += expect ? 1 : 0;
+      }
+    }
+    return count;
+  }
+
+  SimpleMemHeap heap_;
+  DBStorageEngine *engine_{nullptr};
+  TableInfo *table_{nullptr};
+};
+
+TEST_F(PredicateTest, CompareTest) {
+  ASSERT_EQ(100, Check({Compare("id", "<", kNodeNumber, "100"), [](int i) { return i < 100; }}));
+  Check({Compare("id", "<>", kNodeNumber, "7"), [](int i) { return i != 7; }});
+  Check({Compare("id", ">=", kNodeNumber, "1990"), [](int i) { return i >= 1990; }});
+  Check({Compare("score", "<=", kNodeNumber, "12.25"), [](int i) { return !ScoreIsNull(i) && Score(i) <= 12.25; }});
+  Check({Compare("score", ">", kNodeNumber, "20"), [](int i) { return !ScoreIsNull(i) && Score(i) > 20; }});
+  ASSERT_EQ(0, Check({Compare("id", "=", kNodeNumber, "-1"), [](int) { return false; }}));
+}
+
+TEST_F(PredicateTest, NullTest) {
+  ASSERT_EQ(ROWS / 10, Check({Compare("score", "is", kNodeNull, nullptr), ScoreIsNull}));
+  Check({Compare("name", "not", kNodeNull, nullptr), [](int i) { return !NameIsNull(i); }});
+  Check({Compare("id", "is", kNodeNull, nullptr), [](int) { return false; }});
+  // a null score is decoded as 0 in the batch, a comparison with it is still false
+  Check({Compare("score", "=", kNodeNumber, "0"), [](int i) { return !ScoreIsNull(i) && Score(i) == 0; }});
+  Check({Compare("score", "<>", kNodeNumber, "1"), [](int i) { return !ScoreIsNull(i) && Score(i) != 1; }});
+  Check({Compare("score", "<", kNodeNumber, "1000"), [](int i) { return !ScoreIsNull(i); }});
+  Check({Compare("name", "<>", kNodeString, "x"), [](int i) { return !NameIsNull(i); }});
+  Check({Compare("name", ">=", kNodeString, ""), [](int i) { return !NameIsNull(i); }});
+}
+
+TEST_F(PredicateTest, CharTest) {
+  // the literal is a prefix of the column value, or the column value is a prefix of it
+  Check({Compare("name", "=", kNodeString, "name-1"), [](int i) { return !NameIsNull(i) && Name(i) == "name-1"; }});
+  Check({Compare("name", "=", kNodeString, "name-"), [](int) { return false; }});
+  Check({Compare("name", "=", kNodeString, "name-10x"), [](int) { return false; }});
+  for (const char *op : {"<", "<=", ">", ">="}) {
+    for (const char *literal : {"name-1", "name-", "name-10x", "name-4"}) {
+      std::string op_string = op;
+      std::string value = literal;
+      Check({Compare("name", op, kNodeString, literal),
+             [op_string, value](int i) { return !NameIsNull(i) && Satisfies(op_string, Name(i).compare(value)); }});
+    }
+  }
+}
+
+TEST_F(PredicateTest, UnknownColumnTest) {
+  // a column the table does not have compiles to false, alone or under and/or
+  Condition unknown{Compare("age", "=", kNodeNumber, "1"), [](int) { return false; }};
+  ASSERT_EQ(0, Check(unknown));
+  Condition some{Compare("id", "<", kNodeNumber, "10"), [](int i) { return i < 10; }};
+  ASSERT_EQ(10, Check(Connect("or", unknown, some)));
+  unknown.node_ = Compare("age", "is", kNodeNull, nullptr);
+  some.node_ = Compare("id", "<", kNodeNumber, "10");
+  ASSERT_EQ(0, Check(Connect("and", some, unknown)));
+}
+
+TEST_F(PredicateTest, NestedTest) {
+  // nested to the right, every level needs one more operand on the stack
+  const int depth = 40;
+  Condition chain{Compare("id", "=", kNodeNumber, "0"), [](int i) { return i == 0; }};
+  for (int k = 1; k < depth; k++) {
+    int key = k * 3;
+    Condition leaf{Compare("id", "=", kNodeNumber, std::to_string(key).c_str()), [key](int i) { return i == key; }};
+    chain = Connect("or", leaf, chain);
+  }
+  ASSERT_EQ(depth, Check(chain));
+  // and under or under and, to the right and to the left, on columns sharing a decoded vector
+  std::mt19937 rng(0);
+  const char *ops[] = {"=", "<>", "<", "<=", ">", ">="};
+  const char *ints[] = {"0", "5", "500", "1000", "1999"};
+  const char *floats[] = {"0", "2.5", "12.25", "24.75"};
+  const char *chars[] = {"name-1", "name-3", "name-33"};
+  std::function<Condition(int)> random_condition = [&](int level) -> Condition {
+    if (level == 0 || rng() % 4 == 0) {
+      std::string op = ops[rng() % 6];
+      switch (rng() % 4) {
+        case 0: {
+          const char *value = ints[rng() % 5];
+          int key = atoi(value);
+          return {Compare("id", op.c_str(), kNodeNumber, value),
+                  [op, key](int i) { return Satisfies(op, (i > key) - (i < key)); }};
+        }
+        case 1: {
+          const char *value = floats[rng() % 4];
+          float key = atof(value);
+          return {Compare("score", op.c_str(), kNodeNumber, value), [op, key](int i) {
+                    return !ScoreIsNull(i) && Satisfies(op, (Score(i) > key) - (Score(i) < key));
+                  }};
+        }
+        case 2: {
+          std::string value = chars[rng() % 3];
+          return {Compare("name", op.c_str(), kNodeString, value.c_str()),
+                  [op, value](int i) { return !NameIsNull(i) && Satisfies(op, Name(i).compare(value)); }};
+        }
+        default: {
+          bool is_null = rng() % 2 == 0;
+          return {Compare("score", is_null ? "is" : "not", kNodeNull, nullptr),
+                  [is_null](int i) { return ScoreIsNull(i) == is_null; }};
+        }
+      }
+    }
+    Condition left = random_condition(level - 1);
+    Condition right = random_condition(level - 1);
+    return Connect(rng() % 2 == 0 ? "and" : "or", left, right);
+  };
+  for (int round = 0; round < 30; round++) {
+    Check(random_condition(5));
+  }
+}
+
+TEST_F(PredicateTest, VectorTest) {
+  // two conditions on one column share its decoded vector, which is decoded again for every batch
+  Condition above{Compare("score", ">", kNodeNumber, "5"), [](int i) { return !ScoreIsNull(i) && Score(i) > 5; }};
+  Condition below{Compare("score", "<=", kNodeNumber, "20.5"),
+                  [](int i) { return !ScoreIsNull(i) && Score(i) <= 20.5; }};
+  Check(Connect("and", above, below));
+  // a null decodes as 0 and its bit in not_null_ clears it, under or as well
+  above.node_ = Compare("score", ">", kNodeNumber, "5");
+  Condition zero{Compare("score", "<=", kNodeNumber, "0"), [](int i) { return !ScoreIsNull(i) && Score(i) <= 0; }};
+  Check(Connect("or", zero, above));
+  // the same on an int column, next to a float and a char condition
+  Condition low{Compare("id", ">=", kNodeNumber, "100"), [](int i) { return i >= 100; }};
+  Condition high{Compare("id", "<", kNodeNumber, "1500"), [](int i) { return i < 1500; }};
+  Condition name{Compare("name", "<>", kNodeString, "name-3"), [](int i) { return !NameIsNull(i) && Name(i) != "name-3"; }};
+  zero.node_ = Compare("score", "<=", kNodeNumber, "0");
+  Check(Connect("and", Connect("and", low, Connect("or", zero, name)), high));
+}
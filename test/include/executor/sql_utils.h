@@ -0,0 +1,63 @@
+#ifndef MINISQL_SQL_UTILS_H
+#define MINISQL_SQL_UTILS_H
+
+#include "common/macros.h"
+#include "executor/execute_engine.h"
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+/**
+ * One statement parsed the way the shell does, the syntax tree lives as long as the object.
+ * The parser keeps global state, only one statement can be parsed at a time.
+ */
+class ParsedStatement {
+public:
+  explicit ParsedStatement(const char *sql) : buffer_(yy_scan_string(sql)) {
+    yy_switch_to_buffer(buffer_);
+    MinisqlParserInit();
+    yyparse();
+  }
+
+  ~ParsedStatement() {
+    MinisqlParserFinish();
+    yy_delete_buffer(buffer_);
+    yylex_destroy();
+  }
+
+  DISALLOW_COPY_AND_MOVE(ParsedStatement);
+
+  inline bool IsValid() const { return MinisqlParserGetError() == 0 && GetRoot() != nullptr; }
+
+  inline pSyntaxNode GetRoot() const { return MinisqlGetParserRootNode(); }
+
+  /**
+   * @return the condition of the where clause, nullptr without one
+   */
+  pSyntaxNode GetCondition() const {
+    for (pSyntaxNode node = GetRoot()->child_; node != nullptr; node = node->next_) {
+      if (node->type_ == kNodeConditions) {
+        return node->child_;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  YY_BUFFER_STATE buffer_;
+};
+
+/**
+ * Parse and execute one statement
+ */
+inline dberr_t ExecuteSql(ExecuteEngine &engine, const char *sql, ExecuteContext *context) {
+  ParsedStatement statement(sql);
+  if (!statement.IsValid()) {
+    return DB_FAILED;
+  }
+  return engine.Execute(statement.GetRoot(), context);
+}
+
+#endif  // MINISQL_SQL_UTILS_H
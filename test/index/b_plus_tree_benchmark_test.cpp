@@ -0,0 +1,275 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree_index.h"
+#include "index/basic_comparator.h"
+#include "index/generic_key.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "bp_tree_benchmark_test.db";
+
+TEST(BPlusTreeBenchmarkTests, GenericKeyInsertLookupTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  // set BENCHMARK_ROWS for a larger run, the default keeps the test suite fast
+  const int key_nums = getenv("BENCHMARK_ROWS") != nullptr ? atoi(getenv("BENCHMARK_ROWS")) : 100000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  std::vector<uint32_t> index_key_map{1, 0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_);
+  // few distinct names, so most comparisons have to look at the second column
+  char names[8][16];
+  for (auto &name : names) {
+    RandomUtils::RandomString(name, 15);
+  }
+  std::vector<int> ids;
+  for (int i = 0; i < key_nums; i++) {
+    ids.push_back(i);
+  }
+  ShuffleArray(ids);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int id : ids) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeChar, names[id % 8], 15, true),
+            Field(TypeId::kTypeInt, id)
+    };
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key, RowId(id / 100, id % 100), nullptr));
+  }
+  auto insert_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  ShuffleArray(ids);
+  int position = 0;
+  page_id_t leaf_page_id = INVALID_PAGE_ID;
+  std::vector<RowId> result;
+  start = std::chrono::steady_clock::now();
+  for (int id : ids) {
+    std::vector<Field> fields{
+            Field(TypeId::kTypeChar, names[id % 8], 15, true),
+            Field(TypeId::kTypeInt, id)
+    };
+    Row key(fields);
+    result.clear();
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, result, position, leaf_page_id, nullptr));
+    ASSERT_EQ(RowId(id / 100, id % 100).Get(), result.back().Get());
+  }
+  auto lookup_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+  std::cout << "insert " << key_nums << " keys: " << insert_ms.count() << " ms" << std::endl;
+  std::cout << "lookup " << key_nums << " keys: " << lookup_ms.count() << " ms" << std::endl;
+}
+
+template<typename Index>
+static std::chrono::milliseconds PointLookup(Index *index, const std::vector<int> &ids) {
+  int position = 0;
+  page_id_t leaf_page_id = INVALID_PAGE_ID;
+  std::vector<RowId> result;
+  auto start = std::chrono::steady_clock::now();
+  for (int id : ids) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+    Row key(fields);
+    result.clear();
+    EXPECT_EQ(DB_SUCCESS, index->ScanKey(key, result, position, leaf_page_id, nullptr));
+    EXPECT_EQ(RowId(id / 100, id % 100).Get(), result.back().Get());
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+}
+
+TEST(BPlusTreeBenchmarkTests, IntKeyPointLookupTest) {
+  using GENERIC_INDEX = BPlusTreeIndex<GenericKey<8>, RowId, GenericComparator<8>>;
+  using INT_INDEX = BPlusTreeIndex<int32_t, RowId, BasicComparator<int32_t>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  const int key_nums = getenv("BENCHMARK_ROWS") != nullptr ? atoi(getenv("BENCHMARK_ROWS")) : 100000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  std::vector<uint32_t> index_key_map{0};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  // the same int column, once in the generic encoding and once as plain int keys
+  auto *generic_index = ALLOC(heap, GENERIC_INDEX)(0, index_schema, engine.bpm_);
+  auto *int_index = ALLOC(heap, INT_INDEX)(1, index_schema, engine.bpm_);
+  std::vector<int> ids;
+  for (int i = 0; i < key_nums; i++) {
+    ids.push_back(i);
+  }
+  ShuffleArray(ids);
+  for (int id : ids) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, id)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, generic_index->InsertEntry(key, RowId(id / 100, id % 100), nullptr));
+    ASSERT_EQ(DB_SUCCESS, int_index->InsertEntry(key, RowId(id / 100, id % 100), nullptr));
+  }
+  ShuffleArray(ids);
+  auto generic_ms = PointLookup(generic_index, ids);
+  auto int_ms = PointLookup(int_index, ids);
+  std::cout << "point lookup " << key_nums << " keys (GenericKey<8>): " << generic_ms.count() << " ms" << std::endl;
+  std::cout << "point lookup " << key_nums << " keys (int32_t): " << int_ms.count() << " ms" << std::endl;
+}
+
+template<typename Index>
+static std::chrono::milliseconds BuildIndex(Index *index, const std::vector<Row> &rows, bool bulk_load) {
+  auto start = std::chrono::steady_clock::now();
+  if (bulk_load) {
+    auto builder = index->GetBuilder(DEFAULT_INDEX_FILL_FACTOR);
+    for (size_t i = 0; i < rows.size(); i++) {
+      builder->Add(rows[i], RowId(i / 100, i % 100));
+    }
+    EXPECT_EQ(DB_SUCCESS, builder->Finish(nullptr));
+  } else {
+    for (size_t i = 0; i < rows.size(); i++) {
+      EXPECT_EQ(DB_SUCCESS, index->InsertEntry(rows[i], RowId(i / 100, i % 100), nullptr));
+    }
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+}
+
+TEST(BPlusTreeBenchmarkTests, BulkLoadTest) {
+  using INT_INDEX = BPlusTreeIndex<int32_t, RowId, BasicComparator<int32_t>>;
+  using GENERIC_INDEX = BPlusTreeIndex<GenericKey<32>, RowId, GenericComparator<32>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  const int key_nums = getenv("BENCHMARK_ROWS") != nullptr ? atoi(getenv("BENCHMARK_ROWS")) : 100000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> int_key_map{0};
+  std::vector<uint32_t> generic_key_map{1, 0};
+  auto *int_schema = Schema::ShallowCopySchema(&table_schema, int_key_map, &heap);
+  auto *generic_schema = Schema::ShallowCopySchema(&table_schema, generic_key_map, &heap);
+  // rows in table order, the keys come in random order
+  std::vector<int> ids;
+  for (int i = 0; i < key_nums; i++) {
+    ids.push_back(i);
+  }
+  ShuffleArray(ids);
+  char name[16];
+  RandomUtils::RandomString(name, 15);
+  std::vector<Row> int_rows;
+  std::vector<Row> generic_rows;
+  for (int id : ids) {
+    std::vector<Field> int_fields{Field(TypeId::kTypeInt, id)};
+    int_rows.emplace_back(int_fields);
+    std::vector<Field> generic_fields{Field(TypeId::kTypeChar, name, 15, true), Field(TypeId::kTypeInt, id)};
+    generic_rows.emplace_back(generic_fields);
+  }
+  index_id_t index_id = 0;
+  for (bool bulk_load : {false, true}) {
+    auto *int_index = ALLOC(heap, INT_INDEX)(index_id++, int_schema, engine.bpm_);
+    auto *generic_index = ALLOC(heap, GENERIC_INDEX)(index_id++, generic_schema, engine.bpm_);
+    auto int_ms = BuildIndex(int_index, int_rows, bulk_load);
+    auto generic_ms = BuildIndex(generic_index, generic_rows, bulk_load);
+    // both ways give the same index
+    std::vector<RowId> result;
+    int position = 0;
+    page_id_t leaf_page_id = INVALID_PAGE_ID;
+    for (int i = 0; i < key_nums; i += 97) {
+      result.clear();
+      ASSERT_EQ(DB_SUCCESS, int_index->ScanKey(int_rows[i], result, position, leaf_page_id, nullptr));
+      ASSERT_EQ(DB_SUCCESS, generic_index->ScanKey(generic_rows[i], result, position, leaf_page_id, nullptr));
+      ASSERT_EQ(RowId(i / 100, i % 100).Get(), result[0].Get());
+      ASSERT_EQ(RowId(i / 100, i % 100).Get(), result[1].Get());
+    }
+    int count = 0;
+    for (auto cursor = int_index->GetBeginCursor(); !cursor->IsEnd(); cursor->Next()) {
+      count++;
+    }
+    ASSERT_EQ(key_nums, count);
+    std::cout << (bulk_load ? "bulk load " : "insert one by one ") << key_nums << " keys: int " << int_ms.count()
+              << " ms, GenericKey<32> " << generic_ms.count() << " ms" << std::endl;
+  }
+}
+
+/* the binary search the pages used before, as reference */
+template<typename LeafPage, typename KeyType, typename KeyComparator>
+static int BranchyKeyIndex(LeafPage *leaf, const KeyType &key, const KeyComparator &comparator) {
+  int left = 0;
+  int right = leaf->GetSize();
+  while (left < right) {
+    int mid = (left + right) / 2;
+    if (comparator(key, leaf->KeyAt(mid)) > 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
+  }
+  return left;
+}
+
+template<typename KeyType, typename KeyComparator, typename MakeKey>
+static void NodeSearch(const char *name, const KeyComparator &comparator, MakeKey make_key) {
+  using LeafPage = BPlusTreeLeafPage<KeyType, RowId, KeyComparator>;
+  const int probe_nums = 1000000;
+  alignas(8) char buf[PAGE_SIZE];
+  auto *leaf = reinterpret_cast<LeafPage *>(buf);
+  // the fanout of keys that do not share a prefix
+  using KeyArray = PrefixKeyArray<KeyType, RowId>;
+  const int max_size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - KeyArray::HEADER_SIZE) / KeyArray::MAX_ENTRY_SIZE;
+  for (int fanout : {8, 32, 128, max_size}) {
+    if (fanout > max_size) {
+      continue;
+    }
+    leaf->Init(0, INVALID_PAGE_ID, max_size);
+    // even keys in the page, probes hit and miss alike
+    for (int i = 0; i < fanout; i++) {
+      leaf->Insert(make_key(2 * i), RowId(0, i), comparator);
+    }
+    std::mt19937 rng(fanout);
+    std::uniform_int_distribution<int> distribution(-1, 2 * fanout);
+    std::vector<KeyType> probes;
+    for (int i = 0; i < probe_nums; i++) {
+      probes.push_back(make_key(distribution(rng)));
+    }
+    int64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto &probe : probes) {
+      sum += BranchyKeyIndex(leaf, probe, comparator);
+    }
+    auto branchy_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    int64_t branchless_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (auto &probe : probes) {
+      branchless_sum += leaf->KeyIndex(probe, comparator);
+    }
+    auto branchless_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    ASSERT_EQ(sum, branchless_sum);
+    for (int i = 0; i < 2 * fanout + 1; i++) {
+      KeyType key = make_key(i - 1);
+      ASSERT_EQ(BranchyKeyIndex(leaf, key, comparator), leaf->KeyIndex(key, comparator));
+    }
+    std::cout << name << " fanout " << fanout << ", " << probe_nums << " searches: branchy " << branchy_ms.count()
+              << " ms, branchless " << branchless_ms.count() << " ms" << std::endl;
+  }
+}
+
+TEST(BPlusTreeBenchmarkTests, NodeSearchTest) {
+  NodeSearch<int>("int32_t", BasicComparator<int>(), [](int i) { return i; });
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false)
+  };
+  Schema key_schema(columns);
+  NodeSearch<GenericKey<8>>("GenericKey<8>", GenericComparator<8>(&key_schema), [&key_schema](int i) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i)};
+    Row row(fields);
+    GenericKey<8> key;
+    key.SerializeFromKey(row, &key_schema);
+    return key;
+  });
+}
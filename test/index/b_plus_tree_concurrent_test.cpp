@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/basic_comparator.h"
+#include "index/generic_key.h"
+#include "utils/utils.h"
+
+static const std::string db_name = "bp_tree_concurrent_test.db";
+
+using INT_TREE = BPlusTree<int, RowId, BasicComparator<int>>;
+
+template<typename F>
+static void RunThreads(int thread_nums, F f) {
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_nums; t++) {
+    threads.emplace_back(f, t);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(BPlusTreeConcurrentTests, InsertLookupRemoveTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  // small pages, so that splits and merges happen all the time
+  INT_TREE tree(0, engine.bpm_, comparator, 16, 16);
+  const int thread_nums = 4;
+  const int key_nums = 20000;
+  std::atomic<bool> done{false};
+  // readers check every value they find and that scans stay sorted both ways
+  auto reader = [&](int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> distribution(0, key_nums - 1);
+    while (!done) {
+      int key = distribution(rng);
+      std::vector<RowId> result;
+      int position = 0;
+      page_id_t leaf_page_id = INVALID_PAGE_ID;
+      if (tree.GetValue(key, result, position, leaf_page_id)) {
+        ASSERT_EQ(RowId(key, 0).Get(), result.back().Get());
+      }
+      int last = -1;
+      int steps = 0;
+      for (auto iter = tree.Begin(key); iter != tree.End() && steps < 64; ++iter, steps++) {
+        ASSERT_LT(last, (*iter).first);
+        last = (*iter).first;
+      }
+      // and backward, stepping into the leaves before
+      last = key_nums;
+      steps = 0;
+      for (auto iter = tree.RBegin(key, true); iter != tree.REnd() && steps < 64; --iter, steps++) {
+        ASSERT_GT(last, (*iter).first);
+        last = (*iter).first;
+      }
+    }
+  };
+  std::thread reader_1(reader, 1);
+  std::thread reader_2(reader, 2);
+  RunThreads(thread_nums, [&](int t) {
+    std::vector<int> keys;
+    for (int key = t; key < key_nums; key += thread_nums) {
+      keys.push_back(key);
+    }
+    ShuffleArray(keys);
+    std::mt19937 rng(t);
+    for (size_t i = 0; i < keys.size(); i++) {
+      ASSERT_TRUE(tree.Insert(keys[i], RowId(keys[i], 0)));
+      // a key inserted before is found, even if the leaf splits under the lookup
+      int key = keys[std::uniform_int_distribution<size_t>(0, i)(rng)];
+      std::vector<RowId> result;
+      int position = 0;
+      page_id_t leaf_page_id = INVALID_PAGE_ID;
+      ASSERT_TRUE(tree.GetValue(key, result, position, leaf_page_id));
+    }
+  });
+  ASSERT_FALSE(tree.Insert(0, RowId(0, 0)));
+  int expect = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, expect++) {
+    ASSERT_EQ(expect, (*iter).first);
+  }
+  ASSERT_EQ(key_nums, expect);
+  // remove the odd keys while the readers keep going
+  RunThreads(thread_nums, [&](int t) {
+    std::vector<int> keys;
+    for (int key = 2 * t + 1; key < key_nums; key += 2 * thread_nums) {
+      keys.push_back(key);
+    }
+    ShuffleArray(keys);
+    for (int key : keys) {
+      tree.Remove(key);
+    }
+  });
+  done = true;
+  reader_1.join();
+  reader_2.join();
+  expect = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, expect += 2) {
+    ASSERT_EQ(expect, (*iter).first);
+  }
+  ASSERT_EQ(key_nums, expect);
+  ASSERT_TRUE(tree.Check());
+}
+
+TEST(BPlusTreeConcurrentTests, GenericKeyInsertRemoveTest) {
+  using KeyType = GenericKey<16>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 12, 0, false, false)};
+  Schema key_schema(columns);
+  GenericComparator<16> comparator(&key_schema);
+  // keys that share a prefix, leaves split by bytes and push up separators shorter than a key
+  BPlusTree<KeyType, RowId, GenericComparator<16>> tree(0, engine.bpm_, comparator);
+  const int thread_nums = 4;
+  const int key_nums = 20000;
+  std::vector<KeyType> keys(key_nums);
+  for (int i = 0; i < key_nums; i++) {
+    std::string name = "key-" + std::to_string(i * 7919 % key_nums);
+    std::vector<Field> fields{Field(TypeId::kTypeChar, const_cast<char *>(name.c_str()), name.size(), true)};
+    Row row(fields);
+    keys[i].SerializeFromKey(row, &key_schema);
+  }
+  RunThreads(thread_nums, [&](int t) {
+    for (int i = t; i < key_nums; i += thread_nums) {
+      ASSERT_TRUE(tree.Insert(keys[i], RowId(i, 0)));
+    }
+  });
+  // remove the odd ones, lookups of the even ones go on meanwhile
+  RunThreads(thread_nums, [&](int t) {
+    std::vector<RowId> result;
+    int position = 0;
+    page_id_t leaf_page_id = INVALID_PAGE_ID;
+    for (int i = t; i < key_nums; i += thread_nums) {
+      if (i % 2 == 1) {
+        tree.Remove(keys[i]);
+      } else {
+        result.clear();
+        ASSERT_TRUE(tree.GetValue(keys[i], result, position, leaf_page_id));
+        ASSERT_EQ(RowId(i, 0).Get(), result.back().Get());
+      }
+    }
+  });
+  int count = 0;
+  KeyType last;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter, count++) {
+    ASSERT_EQ(0u, (*iter).second.GetPageId() % 2);
+    ASSERT_TRUE(count == 0 || comparator(last, (*iter).first) < 0);
+    last = (*iter).first;
+  }
+  ASSERT_EQ(key_nums / 2, count);
+  ASSERT_TRUE(tree.Check());
+}
+
+TEST(BPlusTreeConcurrentTests, ThroughputTest) {
+  // set BENCHMARK_ROWS for a larger run, the default keeps the test suite fast
+  const int key_nums = getenv("BENCHMARK_ROWS") != nullptr ? atoi(getenv("BENCHMARK_ROWS")) : 100000;
+  const int max_threads = std::max(2, std::min(8, static_cast<int>(std::thread::hardware_concurrency())));
+  std::vector<int> keys;
+  for (int i = 0; i < key_nums; i++) {
+    keys.push_back(i);
+  }
+  ShuffleArray(keys);
+  for (int thread_nums : {1, max_threads}) {
+    DBStorageEngine engine(db_name);
+    BasicComparator<int> comparator;
+    INT_TREE tree(0, engine.bpm_, comparator);
+    auto start = std::chrono::steady_clock::now();
+    RunThreads(thread_nums, [&](int t) {
+      for (int i = t; i < key_nums; i += thread_nums) {
+        ASSERT_TRUE(tree.Insert(keys[i], RowId(keys[i], 0)));
+      }
+    });
+    auto insert_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    start = std::chrono::steady_clock::now();
+    RunThreads(thread_nums, [&](int t) {
+      std::vector<RowId> result;
+      int position = 0;
+      page_id_t leaf_page_id = INVALID_PAGE_ID;
+      for (int i = t; i < key_nums; i += thread_nums) {
+        result.clear();
+        ASSERT_TRUE(tree.GetValue(keys[i], result, position, leaf_page_id));
+        ASSERT_EQ(RowId(keys[i], 0).Get(), result.back().Get());
+      }
+    });
+    auto lookup_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << thread_nums << " thread(s), " << key_nums << " keys: insert " << insert_ms.count() << " ms, lookup "
+              << lookup_ms.count() << " ms" << std::endl;
+    ASSERT_TRUE(tree.Check());
+  }
+}
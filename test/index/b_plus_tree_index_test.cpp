@@ -1,8 +1,11 @@
+#include <atomic>
 #include <string>
+#include <thread>
 
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/b_plus_tree_index.h"
+#include "index/basic_comparator.h"
 #include "index/generic_key.h"
 
 static const std::string db_name = "bp_tree_index_test.db";
@@ -34,6 +37,60 @@ TEST(BPlusTreeTests, BPlusTreeIndexGenericKeyTest) {
   ASSERT_EQ(0, comparator(k1, k2));
 }
 
+TEST(BPlusTreeTests, GenericKeyOrderTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  Schema key_schema(columns);
+  INDEX_COMPARATOR_TYPE comparator(&key_schema);
+  char names[][4] = {"", "a", "a\0", "a\0b", "ab", "b"};
+  uint32_t name_lens[] = {0, 1, 2, 3, 2, 1};
+  int ids[] = {INT32_MIN, -65537, -1, 0, 1, 188, INT32_MAX};
+  float accounts[] = {-1e30f, -2.33f, -0.0f, 0.0f, 1e-30f, 19.99f};
+  // each list is in ascending order, the encoded keys have to sort the same way
+  std::vector<std::vector<Field>> keys;
+  for (int id : ids) {
+    for (int i = 0; i < 6; i++) {
+      for (float account : accounts) {
+        keys.push_back({Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, names[i], name_lens[i], true),
+                        Field(TypeId::kTypeFloat, account)});
+      }
+    }
+  }
+  std::vector<INDEX_KEY_TYPE> encoded(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    Row key(keys[i]);
+    encoded[i].SerializeFromKey(key, &key_schema);
+    // decoding gives back the same fields
+    Row decoded(INVALID_ROWID);
+    encoded[i].DeserializeToKey(decoded, &key_schema);
+    for (uint32_t j = 0; j < 3; j++) {
+      ASSERT_EQ(CmpBool::kTrue, decoded.GetField(j)->CompareEquals(keys[i][j]));
+    }
+  }
+  for (size_t i = 0; i + 1 < keys.size(); i++) {
+    // -0.0 and 0.0 are the same key
+    int expected = keys[i][2].CompareEquals(keys[i + 1][2]) == CmpBool::kTrue ? 0 : -1;
+    ASSERT_EQ(expected, comparator(encoded[i], encoded[i + 1]));
+    ASSERT_EQ(-expected, comparator(encoded[i + 1], encoded[i]));
+  }
+  // null sorts first
+  std::vector<Field> null_fields{Field(TypeId::kTypeInt), Field(TypeId::kTypeChar), Field(TypeId::kTypeFloat)};
+  Row null_key(null_fields);
+  INDEX_KEY_TYPE null_encoded;
+  null_encoded.SerializeFromKey(null_key, &key_schema);
+  ASSERT_EQ(-1, comparator(null_encoded, encoded[0]));
+  Row decoded(INVALID_ROWID);
+  null_encoded.DeserializeToKey(decoded, &key_schema);
+  ASSERT_TRUE(decoded.GetField(0)->IsNull());
+  ASSERT_TRUE(decoded.GetField(1)->IsNull());
+}
+
 TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
   using INDEX_KEY_TYPE = GenericKey<32>;
   using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
@@ -83,4 +140,264 @@ TEST(BPlusTreeTests, BPlusTreeIndexSimpleTest) {
     ASSERT_EQ(i, (*iter).second.GetSlotNum());
     i++;
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BPlusTreeIndexNonUniqueTest) {
+  using INDEX_KEY_TYPE = GenericKey<16>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<16>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("city", TypeId::kTypeInt, 1, true, false)
+  };
+  std::vector<uint32_t> index_key_map{1};
+  const TableSchema table_schema(columns);
+  auto *index_schema = Schema::ShallowCopySchema(&table_schema, index_key_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, index_schema, engine.bpm_, false);
+  auto *built = ALLOC(heap, BP_TREE_INDEX)(1, index_schema, engine.bpm_, false);
+  auto builder = built->GetBuilder(DEFAULT_INDEX_FILL_FACTOR);
+  // 10 cities with 100 rows each, enough to spread a city over several leaves
+  const int row_nums = 1000;
+  for (int i = row_nums - 1; i >= 0; i--) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i % 10)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(key, RowId(i / 100 + 1, i % 100), nullptr));
+    builder->Add(key, RowId(i / 100 + 1, i % 100));
+  }
+  ASSERT_EQ(DB_SUCCESS, builder->Finish(nullptr));
+  for (auto *scanned : {index, built}) {
+    for (int city = 0; city < 10; city++) {
+      std::vector<Field> fields{Field(TypeId::kTypeInt, city)};
+      Row key(fields);
+      std::vector<RowId> result;
+      int position = 0;
+      page_id_t leaf_page_id = INVALID_PAGE_ID;
+      ASSERT_EQ(DB_SUCCESS, scanned->ScanKey(key, result, position, leaf_page_id, nullptr));
+      // every row of the city, in row id order
+      ASSERT_EQ(100u, result.size());
+      for (int j = 0; j < 100; j++) {
+        int i = j * 10 + city;
+        ASSERT_EQ(RowId(i / 100 + 1, i % 100).Get(), result[j].Get());
+      }
+    }
+  }
+  // removing takes out the entry of that row only
+  for (int i = 0; i < row_nums; i += 2) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i % 10)};
+    Row key(fields);
+    ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(key, RowId(i / 100 + 1, i % 100), nullptr));
+  }
+  for (int city = 0; city < 10; city++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, city)};
+    Row key(fields);
+    std::vector<RowId> result;
+    int position = 0;
+    page_id_t leaf_page_id = INVALID_PAGE_ID;
+    if (city % 2 == 0) {
+      ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(key, result, position, leaf_page_id, nullptr));
+      continue;
+    }
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, result, position, leaf_page_id, nullptr));
+    ASSERT_EQ(100u, result.size());
+  }
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 10)};
+  Row missing(fields);
+  std::vector<RowId> result;
+  int position = 0;
+  page_id_t leaf_page_id = INVALID_PAGE_ID;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(missing, result, position, leaf_page_id, nullptr));
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexScanTest) {
+  using INT_INDEX = BPlusTreeIndex<int32_t, RowId, BasicComparator<int32_t>>;
+  using NON_UNIQUE_INDEX = BPlusTreeIndex<GenericKey<16>, RowId, GenericComparator<16>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, true, false),
+          ALLOC_COLUMN(heap)("score", TypeId::kTypeInt, 1, true, false)
+  };
+  const TableSchema table_schema(columns);
+  std::vector<uint32_t> id_key_map{0};
+  std::vector<uint32_t> score_key_map{1};
+  auto *id_schema = Schema::ShallowCopySchema(&table_schema, id_key_map, &heap);
+  auto *score_schema = Schema::ShallowCopySchema(&table_schema, score_key_map, &heap);
+  auto *id_index = ALLOC(heap, INT_INDEX)(0, id_schema, engine.bpm_);
+  auto *score_index = ALLOC(heap, NON_UNIQUE_INDEX)(1, score_schema, engine.bpm_, false);
+  // even ids from 0 to 3998, scores from 0 to 99 with 20 rows each, and a row with null score
+  const int row_nums = 2000;
+  for (int i = 0; i < row_nums; i++) {
+    std::vector<Field> id_fields{Field(TypeId::kTypeInt, 2 * i)};
+    std::vector<Field> score_fields{Field(TypeId::kTypeInt, i % 100)};
+    ASSERT_EQ(DB_SUCCESS, id_index->InsertEntry(Row(id_fields), RowId(i / 100 + 1, i % 100), nullptr));
+    ASSERT_EQ(DB_SUCCESS, score_index->InsertEntry(Row(score_fields), RowId(i / 100 + 1, i % 100), nullptr));
+  }
+  std::vector<Field> null_fields{Field(TypeId::kTypeInt)};
+  ASSERT_EQ(DB_SUCCESS, score_index->InsertEntry(Row(null_fields), RowId(100, 0), nullptr));
+  // count the rows the cursor returns, and check they come in key order
+  auto count = [](std::unique_ptr<IndexCursor> cursor, bool by_id) {
+    int rows = 0;
+    int64_t last = -1;
+    for (; !cursor->IsEnd(); cursor->Next(), rows++) {
+      RowId rid = cursor->GetRowId();
+      int i = (rid.GetPageId() - 1) * 100 + rid.GetSlotNum();
+      int64_t order = by_id ? i : (static_cast<int64_t>(i % 100) << 32) | i;
+      EXPECT_LT(last, order);
+      last = order;
+    }
+    return rows;
+  };
+  for (int low : {-10, 0, 7, 50, 99, 150}) {
+    for (int high : {-1, 0, 7, 60, 99, 4000}) {
+      for (bool low_inclusive : {false, true}) {
+        for (bool high_inclusive : {false, true}) {
+          std::vector<Field> low_fields{Field(TypeId::kTypeInt, low)};
+          std::vector<Field> high_fields{Field(TypeId::kTypeInt, high)};
+          Row low_row(low_fields);
+          Row high_row(high_fields);
+          auto in_range = [&](int key, bool lower, bool upper) {
+            return (!lower || key > low || (low_inclusive && key == low)) &&
+                   (!upper || key < high || (high_inclusive && key == high));
+          };
+          for (bool lower : {false, true}) {
+            for (bool upper : {false, true}) {
+              int ids = 0;
+              int scores = 0;
+              for (int i = 0; i < row_nums; i++) {
+                ids += in_range(2 * i, lower, upper);
+                scores += in_range(i % 100, lower, upper);
+              }
+              const Row *low_bound = lower ? &low_row : nullptr;
+              const Row *high_bound = upper ? &high_row : nullptr;
+              ASSERT_EQ(ids, count(id_index->Scan(low_bound, low_inclusive, high_bound, high_inclusive), true));
+              // the null score is never in range
+              ASSERT_EQ(scores,
+                        count(score_index->Scan(low_bound, low_inclusive, high_bound, high_inclusive), false));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexIncludeTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 1, true, false)
+  };
+  std::vector<uint32_t> key_map{0};
+  std::vector<uint32_t> entry_map{0, 1};
+  const TableSchema table_schema(columns);
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, key_map, &heap);
+  auto *entry_schema = Schema::ShallowCopySchema(&table_schema, entry_map, &heap);
+  // unique on id, the name is stored in the entries next to it
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, key_schema, engine.bpm_, true, entry_schema);
+  auto *built = ALLOC(heap, BP_TREE_INDEX)(1, key_schema, engine.bpm_, true, entry_schema);
+  auto builder = built->GetBuilder(DEFAULT_INDEX_FILL_FACTOR);
+  const int row_nums = 1000;
+  for (int i = row_nums - 1; i >= 0; i--) {
+    std::string name = "n" + std::to_string(i);
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, &name[0], name.size(), true)};
+    Row entry(fields);
+    ASSERT_EQ(DB_SUCCESS, index->InsertEntry(entry, RowId(i, 0), nullptr));
+    builder->Add(entry, RowId(i, 0));
+  }
+  // the same id with another name is a duplicate, the builder keeps the entry added first
+  for (int i = 0; i < row_nums; i += 100) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>("a"), 1, true)};
+    Row entry(fields);
+    ASSERT_EQ(DB_FAILED, index->InsertEntry(entry, RowId(i, 1), nullptr));
+    builder->Add(entry, RowId(i, 1));
+  }
+  ASSERT_EQ(DB_SUCCESS, builder->Finish(nullptr));
+  for (auto *scanned : {index, built}) {
+    std::vector<Field> lower_fields{Field(TypeId::kTypeInt, 100)};
+    std::vector<Field> upper_fields{Field(TypeId::kTypeInt, 200)};
+    Row lower(lower_fields);
+    Row upper(upper_fields);
+    int expect = 100;
+    for (auto cursor = scanned->Scan(&lower, true, &upper, false); !cursor->IsEnd(); cursor->Next(), expect++) {
+      ASSERT_EQ(RowId(expect, 0).Get(), cursor->GetRowId().Get());
+      // the entry gives back the key and the include column
+      Row entry(INVALID_ROWID);
+      cursor->GetEntry(entry);
+      ASSERT_EQ(2u, entry.GetFieldCount());
+      ASSERT_EQ(CmpBool::kTrue, entry.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, expect)));
+      std::string name = "n" + std::to_string(expect);
+      ASSERT_EQ(name, std::string(entry.GetField(1)->GetData(), entry.GetField(1)->GetLength()));
+    }
+    ASSERT_EQ(200, expect);
+    std::vector<RowId> result;
+    int position = 0;
+    page_id_t leaf_page_id = INVALID_PAGE_ID;
+    ASSERT_EQ(DB_SUCCESS, scanned->ScanKey(lower, result, position, leaf_page_id, nullptr));
+    ASSERT_EQ(1u, result.size());
+    ASSERT_EQ(RowId(100, 0).Get(), result[0].Get());
+  }
+  // removing takes the entry with its include column
+  std::string name = "n100";
+  std::vector<Field> fields{Field(TypeId::kTypeInt, 100), Field(TypeId::kTypeChar, &name[0], name.size(), true)};
+  Row entry(fields);
+  ASSERT_EQ(DB_SUCCESS, index->RemoveEntry(entry, RowId(100, 0), nullptr));
+  std::vector<Field> key_fields{Field(TypeId::kTypeInt, 100)};
+  Row key(key_fields);
+  std::vector<RowId> result;
+  int position = 0;
+  page_id_t leaf_page_id = INVALID_PAGE_ID;
+  ASSERT_EQ(DB_KEY_NOT_FOUND, index->ScanKey(key, result, position, leaf_page_id, nullptr));
+}
+
+TEST(BPlusTreeTests, BPlusTreeIndexIncludeConcurrentTest) {
+  using INDEX_KEY_TYPE = GenericKey<32>;
+  using INDEX_COMPARATOR_TYPE = GenericComparator<32>;
+  using BP_TREE_INDEX = BPlusTreeIndex<INDEX_KEY_TYPE, RowId, INDEX_COMPARATOR_TYPE>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 8, 1, true, false)
+  };
+  std::vector<uint32_t> key_map{0};
+  std::vector<uint32_t> entry_map{0, 1};
+  const TableSchema table_schema(columns);
+  auto *key_schema = Schema::ShallowCopySchema(&table_schema, key_map, &heap);
+  auto *entry_schema = Schema::ShallowCopySchema(&table_schema, entry_map, &heap);
+  auto *index = ALLOC(heap, BP_TREE_INDEX)(0, key_schema, engine.bpm_, true, entry_schema);
+  // every thread inserts every id under its own name, the check and the insertion are one step
+  const int row_nums = 500;
+  const int thread_nums = 4;
+  std::vector<std::atomic<int>> inserted(row_nums);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_nums; t++) {
+    threads.emplace_back([&, t]() {
+      std::string name = "t" + std::to_string(t);
+      for (int i = 0; i < row_nums; i++) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, &name[0], name.size(), true)};
+        Row entry(fields);
+        if (index->InsertEntry(entry, RowId(i, t), nullptr) == DB_SUCCESS) {
+          inserted[i]++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < row_nums; i++) {
+    ASSERT_EQ(1, inserted[i].load());
+    std::vector<Field> key_fields{Field(TypeId::kTypeInt, i)};
+    Row key(key_fields);
+    std::vector<RowId> result;
+    int position = 0;
+    page_id_t leaf_page_id = INVALID_PAGE_ID;
+    ASSERT_EQ(DB_SUCCESS, index->ScanKey(key, result, position, leaf_page_id, nullptr));
+    ASSERT_EQ(1u, result.size());
+  }
+}
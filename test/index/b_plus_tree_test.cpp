@@ -1,7 +1,10 @@
+#include <algorithm>
+
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "index/b_plus_tree.h"
 #include "index/basic_comparator.h"
+#include "index/generic_key.h"
 #include "utils/tree_file_mgr.h"
 #include "utils/utils.h"
 
@@ -68,4 +71,292 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_TRUE(tree.GetValue(delete_seq[i], ans, position, leaf_page_id));
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, BulkLoadTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  int position = 0;
+  page_id_t leaf_page_id = INVALID_PAGE_ID;
+  index_id_t index_id = 0;
+  // sizes around the page boundaries, fill factors from half to full pages
+  for (int n : {0, 1, 3, 4, 5, 17, 64, 200}) {
+    for (double fill_factor : {0.5, 0.75, 1.0}) {
+      BPlusTree<int, int, BasicComparator<int>> tree(index_id++, engine.bpm_, comparator, 4, 4);
+      vector<std::pair<int, int>> entries;
+      for (int i = 0; i < n; i++) {
+        entries.emplace_back(2 * i, i);
+      }
+      ASSERT_TRUE(tree.BulkLoad(entries, fill_factor));
+      ASSERT_TRUE(tree.Check());
+      vector<int> ans;
+      for (int i = 0; i < n; i++) {
+        ASSERT_TRUE(tree.GetValue(2 * i, ans, position, leaf_page_id));
+        ASSERT_EQ(i, ans.back());
+        ASSERT_FALSE(tree.GetValue(2 * i + 1, ans, position, leaf_page_id));
+      }
+      int i = 0;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter, i++) {
+        ASSERT_EQ(2 * i, (*iter).first);
+      }
+      ASSERT_EQ(n, i);
+      // only an empty tree is bulk loaded
+      if (n > 0) {
+        ASSERT_FALSE(tree.BulkLoad(entries, fill_factor));
+      }
+      // the loaded tree splits and merges like any other
+      for (i = 0; i < n; i++) {
+        ASSERT_TRUE(tree.Insert(2 * i + 1, i));
+      }
+      for (i = 0; i < n; i++) {
+        tree.Remove(2 * i);
+      }
+      i = 0;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter, i++) {
+        ASSERT_EQ(2 * i + 1, (*iter).first);
+      }
+      ASSERT_EQ(n, i);
+      ASSERT_TRUE(tree.Check());
+    }
+  }
+}
+
+TEST(BPlusTreeTests, BulkLoadOutOfPagesTest) {
+  DBStorageEngine engine(db_name, true, 16);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 4);
+  vector<std::pair<int, int>> entries;
+  for (int i = 0; i < 200; i++) {
+    entries.emplace_back(i, i);
+  }
+  // every frame but two is pinned, fewer than the levels of the tree
+  vector<page_id_t> pinned;
+  page_id_t page_id;
+  while (engine.bpm_->NewPage(page_id) != nullptr) {
+    pinned.push_back(page_id);
+  }
+  for (int i = 0; i < 2; i++) {
+    engine.bpm_->UnpinPage(pinned.back(), false);
+    pinned.pop_back();
+  }
+  ASSERT_FALSE(tree.BulkLoad(entries, 1.0));
+  ASSERT_TRUE(tree.IsEmpty());
+  // the pages of the failed load are not left pinned
+  for (int i = 0; i < 2; i++) {
+    Page *page = engine.bpm_->NewPage(page_id);
+    ASSERT_NE(nullptr, page);
+    pinned.push_back(page_id);
+  }
+  for (page_id_t id : pinned) {
+    engine.bpm_->UnpinPage(id, false);
+  }
+  ASSERT_TRUE(tree.BulkLoad(entries, 1.0));
+  ASSERT_TRUE(tree.Check());
+}
+
+TEST(BPlusTreeTests, InsertOutOfPagesTest) {
+  DBStorageEngine engine(db_name, true, 16);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 64);
+  // leaves under a root with room for more, the tree grows between the rounds
+  for (int i = 0; i < 30; i += 10) {
+    for (int j = i; j < i + 10; j++) {
+      ASSERT_TRUE(tree.Insert(j, j));
+    }
+    // every frame but two is pinned, a split takes the leaf, its parent and a new page
+    vector<page_id_t> pinned;
+    page_id_t page_id;
+    while (engine.bpm_->NewPage(page_id) != nullptr) {
+      pinned.push_back(page_id);
+    }
+    for (int k = 0; k < 2; k++) {
+      engine.bpm_->UnpinPage(pinned.back(), false);
+      pinned.pop_back();
+    }
+    vector<int> failed;
+    for (int j = i + 100; j < i + 110; j++) {
+      if (!tree.Insert(j, j)) {
+        failed.push_back(j);
+      }
+    }
+    ASSERT_FALSE(failed.empty());
+    for (int j = i + 100; j < i + 110; j++) {
+      vector<int> ans;
+      int position;
+      page_id_t leaf_page_id;
+      ASSERT_EQ(std::find(failed.begin(), failed.end(), j) == failed.end(),
+                tree.GetValue(j, ans, position, leaf_page_id));
+    }
+    // the failed inserts left no page pinned
+    for (int k = 0; k < 2; k++) {
+      ASSERT_NE(nullptr, engine.bpm_->NewPage(page_id));
+      pinned.push_back(page_id);
+    }
+    for (page_id_t id : pinned) {
+      engine.bpm_->UnpinPage(id, false);
+    }
+    ASSERT_TRUE(tree.Check());
+    for (int key : failed) {
+      ASSERT_TRUE(tree.Insert(key, key));
+    }
+    ASSERT_TRUE(tree.Check());
+  }
+}
+
+TEST(BPlusTreeTests, ReverseIterationTest) {
+  DBStorageEngine engine(db_name);
+  BasicComparator<int> comparator;
+  BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, 4, 4);
+  ASSERT_TRUE(tree.RBegin() == tree.REnd());
+  // even keys from 0 to 398 in random order, then every fourth one removed
+  const int n = 200;
+  vector<int> keys;
+  for (int i = 0; i < n; i++) {
+    keys.push_back(2 * i);
+  }
+  ShuffleArray(keys);
+  for (int key : keys) {
+    ASSERT_TRUE(tree.Insert(key, key));
+  }
+  for (int key = 0; key < 2 * n; key += 8) {
+    tree.Remove(key);
+  }
+  vector<int> forward;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    forward.push_back((*iter).first);
+  }
+  vector<int> backward;
+  for (auto iter = tree.RBegin(); iter != tree.REnd(); --iter) {
+    backward.push_back((*iter).first);
+  }
+  std::reverse(backward.begin(), backward.end());
+  ASSERT_EQ(forward, backward);
+  // start before or at a key, present or not, then walk back to the first key
+  for (int upper = -1; upper <= 2 * n; upper++) {
+    for (bool inclusive : {false, true}) {
+      auto expect = std::lower_bound(forward.begin(), forward.end(), upper);
+      if (inclusive && expect != forward.end() && *expect == upper) {
+        expect++;
+      }
+      auto iter = tree.RBegin(upper, inclusive);
+      for (; expect != forward.begin(); --iter) {
+        expect--;
+        ASSERT_FALSE(iter == tree.REnd());
+        ASSERT_EQ(*expect, (*iter).first);
+      }
+      ASSERT_TRUE(iter == tree.REnd());
+    }
+  }
+  // both ways on one iterator
+  auto iter = tree.Begin();
+  ++iter;
+  ++iter;
+  --iter;
+  ASSERT_EQ(forward[1], (*iter).first);
+  --iter;
+  --iter;
+  ASSERT_TRUE(iter == tree.REnd());
+  ASSERT_TRUE(tree.Check());
+}
+
+/* the number of leaves of tree, walked along the next page links */
+template<typename Tree, typename KeyType>
+static int CountLeaves(Tree &tree, BufferPoolManager *bpm) {
+  Page *page = tree.FindLeafPage(KeyType(), true);
+  page_id_t page_id = page->GetPageId();
+  int leaves = 0;
+  while (page_id != INVALID_PAGE_ID) {
+    page = bpm->FetchPage(page_id);
+    leaves++;
+    bpm->UnpinPage(page_id, false);
+    // FindLeafPage left the first leaf pinned once more
+    if (leaves == 1) {
+      bpm->UnpinPage(page_id, false);
+    }
+    page_id = reinterpret_cast<BPlusTreeLeafPage<KeyType, RowId, GenericComparator<64>> *>(page->GetData())
+                      ->GetNextPageId();
+  }
+  return leaves;
+}
+
+TEST(BPlusTreeTests, PrefixCompressionTest) {
+  using KeyType = GenericKey<64>;
+  using Tree = BPlusTree<KeyType, RowId, GenericComparator<64>>;
+  DBStorageEngine engine(db_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("path", TypeId::kTypeChar, 60, 0, false, false)};
+  Schema key_schema(columns);
+  GenericComparator<64> comparator(&key_schema);
+  // keys with a long common prefix, most of a key is shared with its neighbours
+  const int n = 20000;
+  std::vector<KeyType> keys(n);
+  for (int i = 0; i < n; i++) {
+    char path[64];
+    snprintf(path, sizeof(path), "user-profile/region-eu/account-%06d", i);
+    std::vector<Field> fields{Field(TypeId::kTypeChar, path, strlen(path), true)};
+    Row row(fields);
+    keys[i].SerializeFromKey(row, &key_schema);
+  }
+  // a page of whole keys holds this many
+  const int uncompressed = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<KeyType, RowId>);
+  std::vector<int> order(n);
+  for (int i = 0; i < n; i++) {
+    order[i] = i;
+  }
+  ShuffleArray(order);
+  Tree tree(0, engine.bpm_, comparator);
+  for (int i : order) {
+    ASSERT_TRUE(tree.Insert(keys[i], RowId(i / 100, i % 100)));
+  }
+  ASSERT_FALSE(tree.Insert(keys[order[0]], RowId(0, 0)));
+  int leaves = CountLeaves<Tree, KeyType>(tree, engine.bpm_);
+  ASSERT_LT(leaves * uncompressed, n / 2);
+  // remove a third of the keys, the pages left merge and redistribute
+  ShuffleArray(order);
+  std::vector<bool> removed(n, false);
+  for (int i = 0; i < n / 3; i++) {
+    tree.Remove(keys[order[i]]);
+    removed[order[i]] = true;
+  }
+  for (int i = 0; i < n; i++) {
+    std::vector<RowId> result;
+    int position;
+    page_id_t leaf_page_id;
+    ASSERT_EQ(!removed[i], tree.GetValue(keys[i], result, position, leaf_page_id));
+    if (!removed[i]) {
+      ASSERT_EQ(RowId(i / 100, i % 100), result[0]);
+    }
+  }
+  // the keys are in order both ways, also across leaves that start after their separator
+  std::vector<int> forward;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    forward.push_back((*iter).second.GetPageId() * 100 + (*iter).second.GetSlotNum());
+  }
+  std::vector<int> backward;
+  for (auto iter = tree.RBegin(); iter != tree.REnd(); --iter) {
+    backward.push_back((*iter).second.GetPageId() * 100 + (*iter).second.GetSlotNum());
+  }
+  std::reverse(backward.begin(), backward.end());
+  ASSERT_EQ(n - n / 3, static_cast<int>(forward.size()));
+  ASSERT_TRUE(std::is_sorted(forward.begin(), forward.end()));
+  ASSERT_EQ(forward, backward);
+  for (int i = 0; i < n; i++) {
+    tree.Remove(keys[i]);
+  }
+  ASSERT_TRUE(tree.IsEmpty());
+  // a bulk load fills the pages by bytes, not by the number of keys
+  std::vector<std::pair<KeyType, RowId>> entries;
+  for (int i = 0; i < n; i++) {
+    entries.emplace_back(keys[i], RowId(i / 100, i % 100));
+  }
+  ASSERT_TRUE(tree.BulkLoad(entries, 1.0));
+  int loaded = CountLeaves<Tree, KeyType>(tree, engine.bpm_);
+  ASSERT_LT(loaded, leaves);
+  ASSERT_LT(loaded * uncompressed * 3, n);
+  int count = 0;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    ASSERT_EQ(0, comparator(keys[count], (*iter).first));
+    count++;
+  }
+  ASSERT_EQ(n, count);
+  ASSERT_TRUE(tree.Check());
+}
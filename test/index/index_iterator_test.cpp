@@ -39,4 +39,18 @@ TEST(BPlusTreeTests, IndexIteratorTest) {
     EXPECT_EQ(ans, (*iter).first);
     EXPECT_EQ(ans * 100, (*iter).second);
   }
+  // the end stays the end, after the last pair and past an upper bound alike
+  auto last = tree.RBegin();
+  ++last;
+  ASSERT_TRUE(last == tree.End());
+  ++last;
+  ASSERT_TRUE(last == tree.End());
+  int upper = 5;
+  auto bounded = tree.Scan(nullptr, false, &upper, false);
+  ++bounded;
+  ++bounded;
+  ASSERT_TRUE(bounded == tree.End());
+  ++bounded;
+  ASSERT_TRUE(bounded == tree.End());
+  ASSERT_TRUE(tree.Check());
 }
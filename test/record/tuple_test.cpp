@@ -3,6 +3,7 @@
 #include "common/instance.h"
 #include "gtest/gtest.h"
 #include "page/table_page.h"
+#include "record/column_comparator.h"
 #include "record/field.h"
 #include "record/row.h"
 #include "record/schema.h"
@@ -117,4 +118,165 @@ TEST(TupleTest, RowTest) {
   }
   ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
   table_page.ApplyDelete(row.GetRowId(), nullptr, nullptr);
-}
\ No newline at end of file
+}
+TEST(TupleTest, RowViewTest) {
+  SimpleMemHeap heap;
+  TablePage table_page;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("nick", TypeId::kTypeChar, 64, 2, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 3, true, false)
+  };
+  std::vector<Field> fields = {
+          Field(TypeId::kTypeInt, 188),
+          Field(TypeId::kTypeChar, const_cast<char *>("minisql"), strlen("minisql"), false),
+          Field(TypeId::kTypeChar),
+          Field(TypeId::kTypeFloat, 19.99f)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  table_page.Init(0, INVALID_PAGE_ID, nullptr, nullptr);
+  ASSERT_TRUE(table_page.InsertTuple(row, schema.get(), nullptr, nullptr, nullptr));
+  RowView view;
+  ASSERT_TRUE(table_page.GetTupleView(row.GetRowId(), schema.get(), &view));
+  ASSERT_EQ(row.GetRowId(), view.GetRowId());
+  ASSERT_EQ(4, view.GetFieldCount());
+  ASSERT_EQ(row.GetSerializedSize(schema.get()), view.GetSerializedSize());
+  // fields can be read in any order
+  ASSERT_FLOAT_EQ(19.99f, view.GetFloat(3));
+  ASSERT_EQ(188, view.GetInt(0));
+  ASSERT_TRUE(view.IsNull(2));
+  ASSERT_FALSE(view.IsNull(1));
+  uint32_t len = 0;
+  const char *name = view.GetChars(1, &len);
+  ASSERT_EQ(strlen("minisql"), len);
+  ASSERT_EQ(0, memcmp("minisql", name, len));
+  for (size_t i = 0; i < fields.size(); i++) {
+    Field field = view.GetField(i);
+    if (fields[i].IsNull()) {
+      ASSERT_TRUE(field.IsNull());
+    } else {
+      ASSERT_EQ(CmpBool::kTrue, field.CompareEquals(fields[i]));
+    }
+  }
+  ASSERT_TRUE(table_page.MarkDelete(row.GetRowId(), nullptr, nullptr, nullptr));
+  ASSERT_FALSE(table_page.GetTupleView(row.GetRowId(), schema.get(), &view));
+}
+
+TEST(TupleTest, RowOffsetArrayTest) {
+  SimpleMemHeap heap;
+  const uint32_t column_nums = 40;
+  std::vector<Column *> columns;
+  std::vector<Field> fields;
+  for (uint32_t i = 0; i < column_nums; i++) {
+    std::string name = "c" + std::to_string(i);
+    if (i % 3 == 0) {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeChar, 16, i, true, false));
+      fields.emplace_back(TypeId::kTypeChar, chars[i % 4], strlen(chars[i % 4]), false);
+    } else if (i % 7 == 0) {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeFloat, i, true, false));
+      fields.emplace_back(TypeId::kTypeFloat);
+    } else {
+      columns.push_back(ALLOC_COLUMN(heap)(name, TypeId::kTypeInt, i, true, false));
+      fields.emplace_back(TypeId::kTypeInt, static_cast<int32_t>(i * 10));
+    }
+  }
+  auto schema = std::make_shared<Schema>(columns);
+  Row row(fields);
+  char buffer[PAGE_SIZE];
+  uint32_t size = row.SerializeTo(buffer, schema.get());
+  ASSERT_EQ(row.GetSerializedSize(schema.get()), size);
+  // late column first, nothing before it needs to be decoded
+  RowView view(buffer, schema.get());
+  ASSERT_EQ(column_nums, view.GetFieldCount());
+  ASSERT_EQ(380, view.GetInt(38));
+  ASSERT_TRUE(view.IsNull(35));
+  ASSERT_EQ(size, view.GetSerializedSize());
+  Row row2(INVALID_ROWID);
+  ASSERT_EQ(size, row2.DeserializeFrom(buffer, schema.get()));
+  for (uint32_t i = 0; i < column_nums; i++) {
+    Field field = view.GetField(i);
+    if (fields[i].IsNull()) {
+      ASSERT_TRUE(field.IsNull());
+      ASSERT_TRUE(row2.GetField(i)->IsNull());
+    } else {
+      ASSERT_EQ(CmpBool::kTrue, field.CompareEquals(fields[i]));
+      ASSERT_EQ(CmpBool::kTrue, row2.GetField(i)->CompareEquals(fields[i]));
+    }
+  }
+  // rows written before the offset array existed are still readable
+  char legacy[16];
+  MACH_WRITE_UINT32(legacy, 2);
+  MACH_WRITE_CHAR(legacy + 4, static_cast<char>(0xC0));
+  MACH_WRITE_INT32(legacy + 5, 7);
+  MACH_WRITE_INT32(legacy + 9, -7);
+  std::vector<Column *> int_columns = {
+          ALLOC_COLUMN(heap)("a", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("b", TypeId::kTypeInt, 1, false, false)
+  };
+  Schema int_schema(int_columns);
+  RowView legacy_view(legacy, &int_schema);
+  ASSERT_EQ(-7, legacy_view.GetInt(1));
+  ASSERT_EQ(13, legacy_view.GetSerializedSize());
+  Row row3(INVALID_ROWID);
+  ASSERT_EQ(13, row3.DeserializeFrom(legacy, &int_schema));
+  ASSERT_EQ(CmpBool::kTrue, row3.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, 7)));
+}
+
+TEST(TupleTest, FieldInlineCharsTest) {
+  char short_chars[] = "fifteen chars!!";
+  char long_chars[] = "sixteen chars!!!";
+  Field short_field(TypeId::kTypeChar, short_chars, strlen(short_chars), true);
+  Field long_field(TypeId::kTypeChar, long_chars, strlen(long_chars), true);
+  // short values are copied into the field itself
+  ASSERT_NE(short_chars, short_field.GetData());
+  ASSERT_STREQ(short_chars, short_field.GetData());
+  ASSERT_STREQ(long_chars, long_field.GetData());
+  Field short_copy(short_field);
+  Field long_copy(long_field);
+  ASSERT_NE(short_field.GetData(), short_copy.GetData());
+  ASSERT_EQ(CmpBool::kTrue, short_copy.CompareEquals(short_field));
+  ASSERT_EQ(CmpBool::kTrue, long_copy.CompareEquals(long_field));
+  // moving keeps the value valid after the source is gone
+  std::vector<Field> fields;
+  for (int i = 0; i < 16; i++) {
+    fields.emplace_back(TypeId::kTypeChar, i % 2 ? short_chars : long_chars, i % 2 ? 15 : 16, true);
+  }
+  for (int i = 0; i < 16; i++) {
+    ASSERT_EQ(CmpBool::kTrue, fields[i].CompareEquals(i % 2 ? short_field : long_field));
+  }
+  Field moved(std::move(fields[1]));
+  fields.clear();
+  ASSERT_EQ(CmpBool::kTrue, moved.CompareEquals(short_field));
+  // swapping an inline value with a heap one
+  Swap(short_copy, long_copy);
+  ASSERT_STREQ(long_chars, short_copy.GetData());
+  ASSERT_STREQ(short_chars, long_copy.GetData());
+}
+
+TEST(TupleTest, ColumnComparatorTest) {
+  // the specialized kernels agree with the virtual comparisons
+  auto check = [](Field *fields, int count) {
+    DispatchColumnComparator(fields[0].GetType(), [&](auto comparator) {
+      using Comparator = decltype(comparator);
+      char lhs_buf[64], rhs_buf[64];
+      for (int i = 0; i < count; i++) {
+        for (int j = 0; j < count; j++) {
+          int expected = fields[i].CompareLessThan(fields[j]) == CmpBool::kTrue ? -1
+                         : fields[i].CompareGreaterThan(fields[j]) == CmpBool::kTrue ? 1 : 0;
+          int result = Comparator::Compare(fields[i], fields[j]);
+          ASSERT_EQ(expected, (result > 0) - (result < 0));
+          fields[i].SerializeTo(lhs_buf);
+          fields[j].SerializeTo(rhs_buf);
+          result = Comparator::CompareSerialized(lhs_buf, rhs_buf);
+          ASSERT_EQ(expected, (result > 0) - (result < 0));
+          ASSERT_EQ(fields[i].GetSerializedSize(), Comparator::GetSerializedSize(lhs_buf));
+        }
+      }
+    });
+  };
+  check(int_fields, sizeof(int_fields) / sizeof(Field));
+  check(float_fields, sizeof(float_fields) / sizeof(Field));
+  check(char_fields, sizeof(char_fields) / sizeof(Field));
+}
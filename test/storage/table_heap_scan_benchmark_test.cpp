@@ -0,0 +1,102 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/table_heap.h"
+#include "utils/utils.h"
+
+static string db_file_name = "table_heap_scan_benchmark_test.db";
+
+/*
+ * every call into the global allocator is counted, memory heaps get their chunks from here too. Replacing the
+ * global operator new affects the whole executable, so it is only done in the benchmark's own executable
+ * (COUNT_ALLOCATIONS, see test/CMakeLists.txt) and not in minisql_test, which links every suite
+ */
+static std::atomic<uint64_t> alloc_count{0};
+
+#ifdef COUNT_ALLOCATIONS
+void *operator new(size_t size) {
+  alloc_count.fetch_add(1, std::memory_order_relaxed);
+  void *buf = malloc(size == 0 ? 1 : size);
+  if (buf == nullptr) {
+    throw std::bad_alloc();
+  }
+  return buf;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+#endif
+
+TEST(TableHeapBenchmarkTest, ScanAllocationTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  // the benchmark is meant for 1M rows, set BENCHMARK_ROWS=1000000; the default keeps the test suite fast
+  const int row_nums = getenv("BENCHMARK_ROWS") != nullptr ? atoi(getenv("BENCHMARK_ROWS")) : 100000;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  Schema schema(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, &schema, nullptr, nullptr, nullptr, &heap);
+  char name[16];
+  for (int i = 0; i < row_nums; i++) {
+    int32_t len = RandomUtils::RandomInt(1, 15);
+    RandomUtils::RandomString(name, len);
+    std::vector<Field> fields{
+            Field(TypeId::kTypeInt, i),
+            Field(TypeId::kTypeChar, name, len, false),
+            Field(TypeId::kTypeFloat, RandomUtils::RandomFloat(-999.f, 999.f))
+    };
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+  }
+
+  // full scan materializing every row, as select without index does
+  int64_t sum = 0;
+  int scanned = 0;
+  uint64_t before = alloc_count.load();
+  auto start = std::chrono::steady_clock::now();
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    sum += it->GetField(1)->GetLength();
+    scanned++;
+  }
+  auto row_scan_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  uint64_t row_scan_allocs = alloc_count.load() - before;
+  ASSERT_EQ(row_nums, scanned);
+
+  // same scan through the zero-copy view
+  int64_t view_sum = 0;
+  scanned = 0;
+  before = alloc_count.load();
+  start = std::chrono::steady_clock::now();
+  for (auto it = table_heap->Begin(nullptr); it != table_heap->End(); ++it) {
+    uint32_t len;
+    it.GetRowView().GetChars(1, &len);
+    view_sum += len;
+    scanned++;
+  }
+  auto view_scan_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  uint64_t view_scan_allocs = alloc_count.load() - before;
+  ASSERT_EQ(row_nums, scanned);
+  ASSERT_EQ(sum, view_sum);
+
+  std::cout << "scan " << row_nums << " rows (Row): " << row_scan_allocs << " allocations, "
+            << row_scan_ms.count() << " ms" << std::endl;
+  std::cout << "scan " << row_nums << " rows (RowView): " << view_scan_allocs << " allocations, "
+            << view_scan_ms.count() << " ms" << std::endl;
+#ifdef COUNT_ALLOCATIONS
+  // fields are decoded into the row's inline heap and short char values are kept inside the field;
+  // what is left is per page (buffer pool bookkeeping), not per row
+  ASSERT_LT(row_scan_allocs, static_cast<uint64_t>(row_nums / 20));
+  ASSERT_LT(view_scan_allocs, static_cast<uint64_t>(row_nums / 20));
+#endif
+}
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <vector>
 #include <unordered_map>
 
@@ -42,6 +43,29 @@ TEST(TableHeapTest, TableHeapSampleTest) {
   }
 
   ASSERT_EQ(row_nums, row_values.size());
+  // in page order, the page of one tuple stays pinned for the next ones on it
+  std::vector<int64_t> rids;
+  for (auto row_kv : row_values) {
+    rids.push_back(row_kv.first);
+  }
+  std::sort(rids.begin(), rids.end());
+  TablePage *page = nullptr;
+  for (auto rid : rids) {
+    RowView view;
+    ASSERT_TRUE(table_heap->GetTupleView(RowId(rid), &view, page, nullptr));
+    ASSERT_EQ(RowId(rid).GetPageId(), page->GetTablePageId());
+    for (size_t j = 0; j < schema.get()->GetColumnCount(); j++) {
+      ASSERT_EQ(CmpBool::kTrue, view.GetField(j).CompareEquals(row_values[rid]->at(j)));
+    }
+  }
+  table_heap->ReleasePage(page);
+  ASSERT_EQ(nullptr, page);
+  std::vector<page_id_t> page_ids;
+  for (auto rid : rids) {
+    page_ids.push_back(RowId(rid).GetPageId());
+  }
+  page_ids.erase(std::unique(page_ids.begin(), page_ids.end()), page_ids.end());
+  ASSERT_EQ(page_ids.size(), table_heap->GetPageCount());
   for (auto row_kv : row_values) {
     Row row(RowId(row_kv.first));
     table_heap->GetTuple(&row, nullptr);
@@ -0,0 +1,72 @@
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "utils/mem_heap.h"
+
+TEST(ArenaMemHeapTest, FreeReuseTest) {
+  ArenaMemHeap heap;
+  void *small = heap.Allocate(40);
+  void *other = heap.Allocate(40);
+  ASSERT_NE(small, other);
+  // a freed block is handed out again for the same size class
+  heap.Free(small);
+  ASSERT_EQ(small, heap.Allocate(33));
+  // but not for another class
+  heap.Free(other);
+  void *large = heap.Allocate(200);
+  ASSERT_NE(other, large);
+  ASSERT_EQ(other, heap.Allocate(40));
+  heap.Free(large);
+  ASSERT_EQ(large, heap.Allocate(240));
+  // blocks beyond the largest class are not reused, but can be freed
+  void *huge = heap.Allocate(8192);
+  heap.Free(huge);
+  ASSERT_NE(huge, heap.Allocate(8192));
+  heap.Free(nullptr);
+}
+
+TEST(ArenaMemHeapTest, AlignmentTest) {
+  ArenaMemHeap heap(256);
+  for (size_t size = 1; size < 2048; size += 7) {
+    auto *buf = static_cast<char *>(heap.Allocate(size));
+    ASSERT_EQ(0u, reinterpret_cast<uintptr_t>(buf) % 8) << "size " << size;
+    // the whole block is writable without touching the next one
+    memset(buf, 0x5a, size);
+  }
+  ASSERT_GT(heap.GetChunkCount(), 1u);
+}
+
+TEST(ArenaMemHeapTest, ResetTest) {
+  alignas(8) char buf[256];
+  ArenaMemHeap heap(buf, sizeof(buf), 512);
+  // the inline buffer serves the first allocations
+  char *first = static_cast<char *>(heap.Allocate(16));
+  ASSERT_TRUE(first >= buf && first < buf + sizeof(buf));
+  ASSERT_EQ(0u, heap.GetChunkCount());
+  for (int i = 0; i < 100; i++) {
+    heap.Allocate(64);
+  }
+  ASSERT_GT(heap.GetChunkCount(), 0u);
+  void *freed = heap.Allocate(100);
+  heap.Free(freed);
+  // reset gives the chunks back and starts over from the inline buffer, free lists are dropped
+  heap.Reset();
+  ASSERT_EQ(0u, heap.GetChunkCount());
+  ASSERT_EQ(first, heap.Allocate(16));
+  void *next = heap.Allocate(100);
+  ASSERT_NE(freed, next);
+  ASSERT_TRUE(static_cast<char *>(next) >= buf && static_cast<char *>(next) < buf + sizeof(buf));
+}
+
+TEST(ArenaMemHeapTest, AllocatorTest) {
+  ArenaMemHeap heap;
+  std::vector<int, MemHeapAllocator<int>> values{MemHeapAllocator<int>(&heap)};
+  for (int i = 0; i < 1000; i++) {
+    values.push_back(i);
+  }
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(i, values[i]);
+  }
+  ASSERT_GT(heap.GetChunkCount(), 0u);
+}